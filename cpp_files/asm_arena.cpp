@@ -0,0 +1,63 @@
+#include "../hpp_files/asm_arena.hpp"
+#include <cstring>
+#include <utility>
+
+AsmArena::AsmArena() : cursor(nullptr), remaining(0), first_size(0), last(nullptr), used(0) {}
+
+AsmArena::AsmArena(AsmArena&& other) noexcept
+    : chunks(std::move(other.chunks)), cursor(other.cursor), remaining(other.remaining),
+      first_size(other.first_size), last(other.last), used(other.used) {
+    other.chunks.clear();
+    other.cursor = other.last = nullptr;
+    other.remaining = other.first_size = other.used = 0;
+}
+
+AsmArena& AsmArena::operator=(AsmArena&& other) noexcept {
+    if (this != &other) {
+        AsmArena moved(std::move(other));
+        std::swap(chunks, moved.chunks);
+        std::swap(cursor, moved.cursor);
+        std::swap(remaining, moved.remaining);
+        std::swap(first_size, moved.first_size);
+        std::swap(last, moved.last);
+        std::swap(used, moved.used);
+    }
+    return *this;
+}
+
+char* AsmArena::alloc(size_t bytes) {
+    if (bytes > remaining) {
+        size_t size = (bytes > CHUNK_BYTES) ? bytes : CHUNK_BYTES;
+        chunks.emplace_back(new char[size]);
+        if (chunks.size() == 1) first_size = size;
+        cursor = chunks.back().get();
+        remaining = size;
+    }
+    last = cursor;
+    cursor += bytes;
+    remaining -= bytes;
+    used += bytes;
+    return last;
+}
+
+void AsmArena::shrink_last(char* p, size_t bytes) {
+    if (p != last || p + bytes > cursor) return;
+    size_t freed = (size_t)(cursor - p) - bytes;
+    cursor -= freed;
+    remaining += freed;
+    used -= freed;
+}
+
+const char* AsmArena::copy(const char* src, size_t bytes) {
+    char* dst = alloc(bytes);
+    if (bytes) memcpy(dst, src, bytes);
+    return dst;
+}
+
+void AsmArena::reset() {
+    if (chunks.size() > 1) chunks.resize(1);
+    cursor = chunks.empty() ? nullptr : chunks[0].get();
+    remaining = chunks.empty() ? 0 : first_size;
+    last = nullptr;
+    used = 0;
+}
@@ -0,0 +1,100 @@
+#include "../hpp_files/batch_sim.hpp"
+#include "../hpp_files/simulator.hpp"
+#include "../hpp_files/sim_threads.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+
+BatchSimulator::BatchSimulator(const std::map<unsigned int, unsigned int>& imem,
+                               const std::map<unsigned int, int32_t>& data,
+                               uint32_t text_end, size_t states, const BatchConfig& config)
+    : program(imem), end_pc(text_end), cfg(config), count(states), tile(1), workers(1)
+{
+    cfg.mem_bytes &= ~3u;
+    row_words = 32 + cfg.mem_bytes / 4;
+    table.assign(count * row_words, 0);
+    cycle_col.assign(count, 0);
+    inst_col.assign(count, 0);
+    status_col.assign(count, BATCH_PENDING);
+
+    // Every state starts from the data segment
+    for (size_t s = 0; s < count; s++) {
+        uint8_t* mem = memory(s);
+        for (auto const& [addr, val] : data) {
+            if ((uint64_t)addr + 4 <= cfg.mem_bytes) std::memcpy(mem + addr, &val, 4);
+        }
+    }
+
+    size_t row_bytes = row_words * 4 + sizeof(uint64_t) * 2 + 1;
+    tile = std::max<size_t>(1, cfg.tile_bytes / row_bytes);
+
+#ifdef SIM_HAS_THREADS
+    workers = cfg.threads ? cfg.threads : std::max(1u, std::thread::hardware_concurrency());
+#endif
+    size_t tiles = (count + tile - 1) / tile;
+    if (workers > tiles) workers = (unsigned int)std::max<size_t>(1, tiles);
+}
+
+int32_t BatchSimulator::mem_word(size_t state, uint32_t addr) const {
+    if ((uint64_t)addr + 4 > cfg.mem_bytes) return 0;
+    int32_t value;
+    std::memcpy(&value, memory(state) + addr, 4);
+    return value;
+}
+
+void BatchSimulator::run_state(size_t state, Core& sim) {
+    sim.reset();
+
+    int32_t* r = regs(state);
+    uint8_t* mem = memory(state);
+    for (int i = 1; i < 32; i++) sim.set_reg(i, r[i]);
+    sim.write_mem_block(0, mem, cfg.mem_bytes);
+
+    uint64_t c = 0;
+    while (c < cfg.max_cycles && !sim.is_drained(end_pc)) {
+        sim.step();
+        c++;
+    }
+
+    for (int i = 0; i < 32; i++) r[i] = sim.get_reg(i);
+    sim.read_mem_block(0, mem, cfg.mem_bytes);
+
+    SimStats stats = sim.get_stats();
+    cycle_col[state] = stats.cycles;
+    inst_col[state] = stats.instructions;
+    if (sim.is_halted()) status_col[state] = BATCH_HALTED;
+    else if (sim.is_drained(end_pc)) status_col[state] = BATCH_FINISHED;
+    else status_col[state] = BATCH_TIMEOUT;
+}
+
+void BatchSimulator::run_tile(size_t first, size_t last, Core& sim) {
+    for (size_t s = first; s < last; s++) run_state(s, sim);
+}
+
+void BatchSimulator::run() {
+    size_t tiles = (count + tile - 1) / tile;
+    std::atomic<size_t> next_tile(0);
+
+    // Each worker pulls the next unclaimed tile. Workers own a copy of imem
+    // (no std::map is shared between threads) and one simulator that is
+    // reset() in place between states.
+    auto worker = [&]() {
+        std::map<unsigned int, unsigned int> imem = program;
+        Core sim(imem);
+        sim.set_mem_size(cfg.mem_bytes);
+        sim.save_reset_point();
+
+        for (size_t t = next_tile.fetch_add(1); t < tiles; t = next_tile.fetch_add(1)) {
+            run_tile(t * tile, std::min(count, (t + 1) * tile), sim);
+        }
+    };
+
+#ifdef SIM_HAS_THREADS
+    std::vector<std::thread> pool;
+    for (unsigned int i = 1; i < workers; i++) pool.emplace_back(worker);
+    worker();
+    for (std::thread& t : pool) t.join();
+#else
+    worker();
+#endif
+}
@@ -0,0 +1,144 @@
+#include "../hpp_files/compressed.hpp"
+#include "../hpp_files/utils.hpp"
+
+// RVC register fields (rd', rs1', rs2') only reach x8-x15
+static bool isCompressedReg(int reg) { return reg >= 8 && reg <= 15; }
+
+// Assembler Phase 3b: RVC encodings
+
+/**
+ * Whether an instruction has a 16-bit form (branch range is checked separately).
+ * C.SLLI, C.LW, C.SW, C.LWSP, C.SWSP, C.BEQZ
+ */
+bool isCompressible(const ParsedInstruction& inst) {
+    if (!inst.rvc) return false;
+    const string_view m = inst.mnemonic();
+
+    if (m == "slli" && inst.operand_count == 3) {
+        int rd = getRegisterNumber(inst.operand(0));
+        int imm = getImmediateValue(inst.operand(2));
+        return rd > 0 && rd == getRegisterNumber(inst.operand(1)) && imm > 0 && imm < 32;
+    }
+    if ((m == "lw" || m == "sw") && inst.operand_count == 3) {
+        int reg = getRegisterNumber(inst.operand(0));
+        int base = getRegisterNumber(inst.operand(1));
+        int imm = getImmediateValue(inst.operand(2));
+        if (imm < 0 || (imm & 0x3) != 0) return false;
+        if (isCompressedReg(reg) && isCompressedReg(base) && imm <= 124) return true;
+        if (base == 2 && imm <= 252) return m == "sw" || reg != 0;  // C.LWSP / C.SWSP
+        return false;
+    }
+    if (m == "beq" && inst.operand_count == 3) {
+        int rs1 = getRegisterNumber(inst.operand(0));
+        int rs2 = getRegisterNumber(inst.operand(1));
+        return (isCompressedReg(rs1) && rs2 == 0) || (rs1 == 0 && isCompressedReg(rs2));
+    }
+    return false;
+}
+
+// C.BEQZ: 9-bit signed, even offset
+bool fitsCompressedBranch(int offset) {
+    return offset >= -256 && offset <= 254 && (offset & 1) == 0;
+}
+
+unsigned int encodeCompressed(const ParsedInstruction& inst, int offset) {
+    const string_view m = inst.mnemonic();
+    unsigned int c = 0;
+
+    if (m == "slli") {
+        // C.SLLI: [15:13 000] [12 shamt[5]] [11:7 rd] [6:2 shamt[4:0]] [1:0 10]
+        unsigned int rd = getRegisterNumber(inst.operand(0));
+        unsigned int shamt = getImmediateValue(inst.operand(2)) & 0x1F;
+        c = (0b000 << 13) | (rd << 7) | (shamt << 2) | 0b10;
+
+    } else if (m == "lw" || m == "sw") {
+        unsigned int reg = getRegisterNumber(inst.operand(0));
+        unsigned int base = getRegisterNumber(inst.operand(1));
+        unsigned int imm = getImmediateValue(inst.operand(2));
+        unsigned int f3 = (m == "lw") ? 0b010 : 0b110;
+
+        if (isCompressedReg(reg) && isCompressedReg(base) && imm <= 124) {
+            // C.LW / C.SW: [15:13 f3] [12:10 imm[5:3]] [9:7 rs1'] [6 imm[2]] [5 imm[6]] [4:2 rd'/rs2'] [1:0 00]
+            c = (f3 << 13) | (((imm >> 3) & 0x7) << 10) | ((base - 8) << 7)
+              | (((imm >> 2) & 0x1) << 6) | (((imm >> 6) & 0x1) << 5) | ((reg - 8) << 2) | 0b00;
+        } else if (m == "lw") {
+            // C.LWSP: [15:13 010] [12 imm[5]] [11:7 rd] [6:4 imm[4:2]] [3:2 imm[7:6]] [1:0 10]
+            c = (f3 << 13) | (((imm >> 5) & 0x1) << 12) | (reg << 7)
+              | (((imm >> 2) & 0x7) << 4) | (((imm >> 6) & 0x3) << 2) | 0b10;
+        } else {
+            // C.SWSP: [15:13 110] [12:9 imm[5:2]] [8:7 imm[7:6]] [6:2 rs2] [1:0 10]
+            c = (f3 << 13) | (((imm >> 2) & 0xF) << 9) | (((imm >> 6) & 0x3) << 7) | (reg << 2) | 0b10;
+        }
+
+    } else if (m == "beq") {
+        // C.BEQZ: [15:13 110] [12 off[8]] [11:10 off[4:3]] [9:7 rs1'] [6:5 off[7:6]] [4:3 off[2:1]] [2 off[5]] [1:0 01]
+        int rs1 = getRegisterNumber(inst.operand(0));
+        if (rs1 == 0) rs1 = getRegisterNumber(inst.operand(1));
+        unsigned int off = offset & 0x1FF;
+        c = (0b110 << 13) | (((off >> 8) & 0x1) << 12) | (((off >> 3) & 0x3) << 10) | ((rs1 - 8) << 7)
+          | (((off >> 6) & 0x3) << 5) | (((off >> 1) & 0x3) << 3) | (((off >> 5) & 0x1) << 2) | 0b01;
+    }
+
+    return c;
+}
+
+CodeSizeStats computeCodeSize(const vector<ParsedInstruction>& instructions) {
+    CodeSizeStats s = {0, 0, 0, 0};
+    for (const ParsedInstruction& inst : instructions) {
+        s.instructions++;
+        s.bytes += inst.size;
+        s.uncompressed_bytes += 4;
+        if (inst.size == 2) s.compressed++;
+    }
+    return s;
+}
+
+/**
+ * Expands the RVC forms emitted above into the equivalent RV32I encoding.
+ */
+uint32_t expandCompressed(uint16_t c) {
+    uint32_t op = c & 0x3;
+    uint32_t f3 = (c >> 13) & 0x7;
+
+    if (op == 0b00 && (f3 == 0b010 || f3 == 0b110)) {
+        // C.LW / C.SW
+        uint32_t rs1 = ((c >> 7) & 0x7) + 8;
+        uint32_t r   = ((c >> 2) & 0x7) + 8;
+        uint32_t imm = (((c >> 10) & 0x7) << 3) | (((c >> 6) & 0x1) << 2) | (((c >> 5) & 0x1) << 6);
+        if (f3 == 0b010) return (imm << 20) | (rs1 << 15) | (0b010 << 12) | (r << 7) | 0x03;
+        return ((imm >> 5) << 25) | (r << 20) | (rs1 << 15) | (0b010 << 12) | ((imm & 0x1F) << 7) | 0x23;
+    }
+
+    if (op == 0b10) {
+        uint32_t rd = (c >> 7) & 0x1F;
+        if (f3 == 0b000 && !((c >> 12) & 0x1)) {
+            // C.SLLI (RV32: shamt[5] must be 0)
+            uint32_t shamt = (c >> 2) & 0x1F;
+            return (shamt << 20) | (rd << 15) | (0b001 << 12) | (rd << 7) | 0x13;
+        }
+        if (f3 == 0b010 && rd != 0) {
+            // C.LWSP
+            uint32_t imm = (((c >> 12) & 0x1) << 5) | (((c >> 4) & 0x7) << 2) | (((c >> 2) & 0x3) << 6);
+            return (imm << 20) | (2 << 15) | (0b010 << 12) | (rd << 7) | 0x03;
+        }
+        if (f3 == 0b110) {
+            // C.SWSP
+            uint32_t rs2 = (c >> 2) & 0x1F;
+            uint32_t imm = (((c >> 9) & 0xF) << 2) | (((c >> 7) & 0x3) << 6);
+            return ((imm >> 5) << 25) | (rs2 << 20) | (2 << 15) | (0b010 << 12) | ((imm & 0x1F) << 7) | 0x23;
+        }
+    }
+
+    if (op == 0b01 && f3 == 0b110) {
+        // C.BEQZ -> beq rs1', x0, offset
+        uint32_t rs1 = ((c >> 7) & 0x7) + 8;
+        int32_t off = (((c >> 12) & 0x1) << 8) | (((c >> 10) & 0x3) << 3) | (((c >> 5) & 0x3) << 6)
+                    | (((c >> 3) & 0x3) << 1) | (((c >> 2) & 0x1) << 5);
+        off = (off << 23) >> 23;
+        uint32_t imm = (uint32_t)off;
+        return (((imm >> 12) & 0x1) << 31) | (((imm >> 5) & 0x3F) << 25) | (rs1 << 15) | (0b000 << 12)
+             | (((imm >> 1) & 0xF) << 8) | (((imm >> 11) & 0x1) << 7) | 0x63;
+    }
+
+    return 0;
+}
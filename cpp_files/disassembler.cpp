@@ -0,0 +1,150 @@
+#include "../hpp_files/disassembler.hpp"
+#include "../hpp_files/assembler.hpp"
+#include "../hpp_files/compressed.hpp"
+#include <cstdio>
+#include <cstring>
+
+// One row of the decode table: word & mask == match selects the mnemonic
+struct DisasmEntry {
+    uint32_t match;
+    uint32_t mask;
+    char type;            // R, I, L (load), F (fence.i), S, B, J, V, M (vector memory), C (vsetvli)
+    const char* mnemonic; // Points into INSTRUCTION_SET, which lives for the program
+};
+
+// Decode table bucketed by the 7-bit major opcode, built once from INSTRUCTION_SET
+struct DisasmTable {
+    vector<DisasmEntry> buckets[128];
+
+    DisasmTable() {
+        for (auto const& [name, info] : INSTRUCTION_SET) {
+            uint32_t op = (uint32_t)stoul(info.op, nullptr, 2);
+            uint32_t f3 = (uint32_t)stoul(info.f3, nullptr, 2);
+            uint32_t f7 = info.f7.empty() ? 0 : (uint32_t)stoul(info.f7, nullptr, 2);
+
+            DisasmEntry e;
+            e.match = op | (f3 << 12);
+            e.mask = 0x707F;
+            e.mnemonic = name.c_str();
+
+            if (info.type == "R") {
+                e.type = 'R';
+                e.match |= f7 << 25;
+                e.mask |= 0x7Fu << 25;
+            } else if (name == "fence.i") {
+                e.type = 'F';
+            } else if (info.type == "I" && name == "slli") {
+                // Top 6 bits: funct7 on RV32, funct6 with a 6-bit shamt on RV64
+                e.type = 'I';
+                e.match |= f7 << 25;
+                e.mask |= 0x3Fu << 26;
+            } else if (info.type == "I") {
+                e.type = 'L';
+            } else if (info.type == "S") {
+                e.type = 'S';
+            } else if (info.type == "B") {
+                e.type = 'B';
+            } else if (info.type == "J") {
+                e.type = 'J';
+                e.mask = 0x7F;
+            } else if (info.type == "V") {
+                e.type = 'V';
+                e.match |= f7 << 26; // f7 holds funct6 for OP-V
+                e.mask |= 0x3Fu << 26;
+            } else if (info.type == "VL" || info.type == "VS") {
+                e.type = 'M';
+            } else if (info.type == "VSET") {
+                e.type = 'C';
+                e.mask |= 1u << 31;
+            } else {
+                continue;
+            }
+            buckets[op].push_back(e);
+        }
+    }
+};
+
+static int32_t immI(uint32_t w) { return (int32_t)w >> 20; }
+static int32_t immS(uint32_t w) { return ((int32_t)(w & 0xFE000000) >> 20) | ((w >> 7) & 0x1F); }
+static int32_t immB(uint32_t w) {
+    int32_t v = (((w >> 31) & 0x1) << 12) | (((w >> 7) & 0x1) << 11) | (((w >> 25) & 0x3F) << 5) | (((w >> 8) & 0xF) << 1);
+    return (v << 19) >> 19;
+}
+static int32_t immJ(uint32_t w) {
+    int32_t v = (((w >> 31) & 0x1) << 20) | (((w >> 12) & 0xFF) << 12) | (((w >> 20) & 0x1) << 11) | (((w >> 21) & 0x3FF) << 1);
+    return (v << 11) >> 11;
+}
+
+static size_t clampLength(int n, size_t size) {
+    if (n < 0) return 0;
+    return ((size_t)n < size) ? (size_t)n : size - 1;
+}
+
+size_t disassemble(uint32_t word, char* buf, size_t size) {
+    static const DisasmTable table;
+    if (size == 0) return 0;
+
+    if (isCompressedEncoding(word)) {
+        uint32_t expanded = expandCompressed((uint16_t)word);
+        if (expanded == 0) return clampLength(snprintf(buf, size, ".half 0x%04x", word & 0xFFFF), size);
+        if (size < 3) { buf[0] = '\0'; return 0; }
+        buf[0] = 'c';
+        buf[1] = '.';
+        return 2 + disassemble(expanded, buf + 2, size - 2);
+    }
+
+    const DisasmEntry* e = nullptr;
+    for (const DisasmEntry& candidate : table.buckets[word & 0x7F]) {
+        if ((word & candidate.mask) == candidate.match) { e = &candidate; break; }
+    }
+    if (e == nullptr) return clampLength(snprintf(buf, size, ".word 0x%08x", word), size);
+
+    unsigned rd = (word >> 7) & 0x1F;
+    unsigned rs1 = (word >> 15) & 0x1F;
+    unsigned rs2 = (word >> 20) & 0x1F;
+    const char* m = e->mnemonic;
+    int n = 0;
+
+    switch (e->type) {
+        case 'R': n = snprintf(buf, size, "%s x%u, x%u, x%u", m, rd, rs1, rs2); break;
+        case 'I': n = snprintf(buf, size, "%s x%u, x%u, %u", m, rd, rs1, (word >> 20) & 0x3F); break;
+        case 'L': n = snprintf(buf, size, "%s x%u, %d(x%u)", m, rd, immI(word), rs1); break;
+        case 'F': n = snprintf(buf, size, "%s", m); break;
+        case 'S': n = snprintf(buf, size, "%s x%u, %d(x%u)", m, rs2, immS(word), rs1); break;
+        case 'B': n = snprintf(buf, size, "%s x%u, x%u, .%+d", m, rs1, rs2, immB(word)); break;
+        case 'J': n = snprintf(buf, size, "%s x%u, .%+d", m, rd, immJ(word)); break;
+        case 'V':
+            if (((word >> 12) & 0x7) == 0b011) {
+                n = snprintf(buf, size, "%s v%u, v%u, %u", m, rd, rs2, rs1); // OPIVI: rs1 field is uimm5
+            } else {
+                n = snprintf(buf, size, "%s v%u, v%u, v%u", m, rd, rs2, rs1);
+            }
+            break;
+        case 'M': n = snprintf(buf, size, "%s v%u, (x%u)", m, rd, rs1); break;
+        case 'C': {
+            uint32_t zimm = (word >> 20) & 0x7FF;
+            unsigned sew = 8u << ((zimm >> 3) & 0x7);
+            n = snprintf(buf, size, "%s x%u, x%u, e%u, m1, %s, %s", m, rd, rs1, sew,
+                         (zimm & 0x40) ? "ta" : "tu", (zimm & 0x80) ? "ma" : "mu");
+            break;
+        }
+    }
+    return clampLength(n, size);
+}
+
+DisasmCache::DisasmCache() : hit_count(0), miss_count(0) {
+    std::memset(entries, 0, sizeof(entries));
+}
+
+const char* DisasmCache::lookup(uint32_t word) {
+    Entry& e = entries[(word ^ (word >> 7) ^ (word >> 15)) & (ENTRIES - 1)];
+    if (e.valid && e.word == word) {
+        hit_count++;
+        return e.text;
+    }
+    miss_count++;
+    disassemble(word, e.text, sizeof(e.text));
+    e.word = word;
+    e.valid = true;
+    return e.text;
+}
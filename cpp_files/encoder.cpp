@@ -1,4 +1,6 @@
 #include "../hpp_files/encoder.hpp"
+#include "../hpp_files/compressed.hpp"
+#include <stdexcept>
 
 // Assembler Phase 3: Encoding Functions
 
@@ -29,6 +31,7 @@ unsigned int encodeRType(string rd, string rs1, string rs2, string f3, string f7
 /**
  * I-Type Instruction Format: [31:20 imm] [19:15 rs1] [14:12 funct3] [11:7 rd] [6:0 opcode]
  */
+template <int XLEN>
 unsigned int encodeIType(string rd, string rs1, int imm, string f3, string op, const string& mnemonic) {
     unsigned int machineCode = 0;
     
@@ -41,7 +44,8 @@ unsigned int encodeIType(string rd, string rs1, int imm, string f3, string op, c
     if (mnemonic == "slli") {
         // SLLI: immediate (shamt) - [24:20]; funct7 - [31:25].
         // RISC-V pseudo-I-Type: [31:25 funct7] [24:20 shamt] [19:15 rs1] [14:12 funct3] [11:7 rd] [6:0 opcode]
-        unsigned int shamt = imm & 0b11111; // 5-bit immediate
+        // RV64: 6-bit shamt in [25:20] under a 6-bit funct6
+        unsigned int shamt = imm & XlenTraits<XLEN>::SHAMT_MASK;
         unsigned int u_f7 = binToUint(INSTRUCTION_SET.at(mnemonic).f7);
 
         machineCode |= (u_f7 << 25);
@@ -146,61 +150,199 @@ unsigned int encodeJType(string rd, int imm, string op) {
     return machineCode;
 }
 
+/**
+ * OP-V Arithmetic Format: [31:26 funct6] [25 vm] [24:20 vs2] [19:15 vs1/uimm5] [14:12 funct3] [11:7 vd] [6:0 opcode]
+ * Always unmasked (vm = 1). For OPIVI (funct3 = 011) vs1 is a 5-bit immediate.
+ */
+unsigned int encodeVType(string vd, string vs2, string vs1, string f3, string f6, string op) {
+    unsigned int machineCode = 0;
+
+    unsigned int u_vd = getVectorRegisterNumber(vd);
+    unsigned int u_vs2 = getVectorRegisterNumber(vs2);
+    unsigned int u_f3 = binToUint(f3);
+    unsigned int u_f6 = binToUint(f6);
+    unsigned int u_op = binToUint(op);
+    unsigned int u_vs1 = (u_f3 == 0b011) ? (getImmediateValue(vs1) & 0b11111) : getVectorRegisterNumber(vs1);
+
+    machineCode |= (u_f6 << 26);
+    machineCode |= (1u << 25);
+    machineCode |= (u_vs2 << 20);
+    machineCode |= (u_vs1 << 15);
+    machineCode |= (u_f3 << 12);
+    machineCode |= (u_vd << 7);
+    machineCode |= u_op;
+
+    return machineCode;
+}
+
+/**
+ * Unit-Stride Vector Load/Store: [31:29 nf] [28 mew] [27:26 mop] [25 vm] [24:20 lumop] [19:15 rs1] [14:12 width] [11:7 vd/vs3] [6:0 opcode]
+ * nf, mew, mop and lumop are all zero; vm = 1.
+ */
+unsigned int encodeVMemType(string vd, string rs1, string width, string op) {
+    unsigned int machineCode = 0;
+
+    unsigned int u_vd = getVectorRegisterNumber(vd);
+    unsigned int u_rs1 = getRegisterNumber(rs1);
+    unsigned int u_width = binToUint(width);
+    unsigned int u_op = binToUint(op);
+
+    machineCode |= (1u << 25);
+    machineCode |= (u_rs1 << 15);
+    machineCode |= (u_width << 12);
+    machineCode |= (u_vd << 7);
+    machineCode |= u_op;
+
+    return machineCode;
+}
+
+/**
+ * VSETVLI Format: [31 0] [30:20 zimm] [19:15 rs1] [14:12 111] [11:7 rd] [6:0 opcode]
+ * vtype tokens: e32 (required), m1, ta/tu, ma/mu.
+ */
+unsigned int encodeVsetvli(string rd, string rs1, const vector<string>& vtype, string op) {
+    unsigned int zimm = 0;
+    bool haveSew = false;
+
+    for (const string& token : vtype) {
+        if (token == "e32") { zimm |= (0b010 << 3); haveSew = true; }
+        else if (token == "m1") { }
+        else if (token == "ta") zimm |= (1u << 6);
+        else if (token == "ma") zimm |= (1u << 7);
+        else if (token == "tu" || token == "mu") { }
+        else throw std::runtime_error("vsetvli: unsupported vtype '" + token + "' (only e32, m1)");
+    }
+    if (!haveSew) throw std::runtime_error("vsetvli: element width missing (expected e32)");
+
+    unsigned int machineCode = 0;
+    machineCode |= (zimm << 20);
+    machineCode |= (getRegisterNumber(rs1) << 15);
+    machineCode |= (0b111 << 12);
+    machineCode |= (getRegisterNumber(rd) << 7);
+    machineCode |= binToUint(op);
+
+    return machineCode;
+}
+
+// Address of a branch/jump target
+static unsigned int labelAddress(const map<string, unsigned int>& symbols, const string& label) {
+    auto it = symbols.find(label);
+    if (it == symbols.end()) throw std::runtime_error("Undefined label: " + label);
+    return it->second;
+}
+
+/**
+ * Encodes one instruction at inst.address; branch and jump labels are looked
+ * up in symbols. Throws std::runtime_error for an unknown mnemonic, missing
+ * operands or an undefined label.
+ */
+template <int XLEN>
+unsigned int encodeInstruction(const ParsedInstruction& inst, const map<string, unsigned int>& symbols) {
+    const InstructionInfo* found = instructionInfo(inst.mnemonic_id);
+    if (!found) throw std::runtime_error("Unknown instruction: " + string(inst.mnemonic()));
+    const InstructionInfo& info = *found;
+    const string& mnemonic = mnemonicName(inst.mnemonic_id);
+    const unsigned int address = inst.address;
+    unsigned int opcode = 0;
+
+    // Operand text for the field encoders (register names and immediates are
+    // short enough to stay in the string's inline buffer)
+    string ops[MAX_OPERANDS];
+    const size_t opCount = inst.operand_count;
+    for (size_t i = 0; i < opCount; i++) ops[i] = string(inst.operand(i));
+
+    size_t needed = 3;
+    if (mnemonic == "fence.i") needed = 0;
+    else if (info.type == "J" || info.type == "VL" || info.type == "VS") needed = 2;
+    if (opCount < needed) {
+        throw std::runtime_error(mnemonic + " expects " + to_string(needed) + " operands");
+    }
+
+    if (XLEN == 32 && (mnemonic == "ld" || mnemonic == "sd")) {
+        throw std::runtime_error(mnemonic + " is only available in RV64 builds");
+    }
+
+    if (inst.size == 2) {
+        // RVC: 16-bit encoding chosen by relaxCompressed()
+        int offset = 0;
+        if (info.type == "B") offset = (int)labelAddress(symbols, ops[2]) - (int)address;
+        opcode = encodeCompressed(inst, offset);
+
+    } else if (mnemonic == "fence.i") {
+        // FENCE.I: no operands; rd, rs1 and imm are all zero
+        opcode = encodeIType<XLEN>("x0", "x0", 0, info.f3, info.op, mnemonic);
+
+    } else if (info.type == "R") {
+        // R-Type: rd, rs1, rs2 (e.g., add x1, x2, x3)
+        opcode = encodeRType(ops[0], ops[1], ops[2], info.f3, info.f7, info.op);
+
+    } else if (info.type == "I" && mnemonic != "lw" && mnemonic != "ld" && mnemonic != "jalr") {
+        // Standard I-Type: rd, rs1, imm (e.g., addi x1, x2, 100)
+        int imm = getImmediateValue(ops[2]);
+        if (imm == 999999999) { } 
+        
+        opcode = encodeIType<XLEN>(ops[0], ops[1], imm, info.f3, info.op, mnemonic);
+        
+    } else if (mnemonic == "lw" || mnemonic == "ld" || mnemonic == "jalr") {
+        // Load I-Type: rd, imm(rs1) -> ops: rd, rs1, imm
+        // JALR I-Type: rd, imm(rs1) -> ops: rd, rs1, imm (often rd, rs1, 0)
+        int imm = getImmediateValue(ops[2]);
+        opcode = encodeIType<XLEN>(ops[0], ops[1], imm, info.f3, info.op, mnemonic);
+        
+    } else if (info.type == "S") {
+        // S-Type: rs2, imm(rs1) -> ops: rs2, rs1, imm
+        int imm = getImmediateValue(ops[2]);
+        opcode = encodeSType(ops[1], ops[0], imm, info.f3, info.op); // Note: rs1/rs2 swap for S-type register order
+        
+    } else if (info.type == "B") {
+        // B-Type: rs1, rs2, label -> ops: rs1, rs2, label
+        string label = ops[2];
+        unsigned int targetAddress = labelAddress(symbols, label);
+        // PC-relative immediate calculation: imm = Target - Current PC
+        int imm = (int)targetAddress - (int)address; 
+        opcode = encodeBType(ops[0], ops[1], imm, info.f3, info.op);
+
+    } else if (info.type == "V") {
+        // Vector arithmetic: vd, vs2, vs1 (or uimm5 for .vi)
+        opcode = encodeVType(ops[0], ops[1], ops[2], info.f3, info.f7, info.op);
+
+    } else if (info.type == "VL" || info.type == "VS") {
+        // Unit-stride vector load/store: vd/vs3, (rs1) -> ops: vd, rs1
+        opcode = encodeVMemType(ops[0], ops[1], info.f3, info.op);
+
+    } else if (info.type == "VSET") {
+        // vsetvli rd, rs1, e32[, m1, ta, ma]
+        vector<string> vtype(ops + 2, ops + opCount);
+        opcode = encodeVsetvli(ops[0], ops[1], vtype, info.op);
+
+    } else if (info.type == "J") {
+        // J-Type: rd, label -> ops: rd, label
+        string label = ops[1];
+        unsigned int targetAddress = labelAddress(symbols, label);
+        // PC-relative immediate calculation: imm = Target - Current PC
+        int imm = (int)targetAddress - (int)address; 
+        opcode = encodeJType(ops[0], imm, info.op);
+
+    } else {
+        cerr << "FATAL ERROR: Unhandled instruction type for " << mnemonic << " at 0x" << hex << address << endl;
+        exit(1);
+    }
+    return opcode;
+}
+
+template <int XLEN>
 map<unsigned int, unsigned int> translateToOpcode(const vector<ParsedInstruction>& instructions) {
     map<unsigned int, unsigned int> opcodeMap;
 
     for (const ParsedInstruction& inst : instructions) {
-        const string& mnemonic = inst.mnemonic;
-        const vector<string>& ops = inst.operands;
-        const unsigned int address = inst.address;
-
-        const InstructionInfo& info = INSTRUCTION_SET.at(mnemonic);
-        unsigned int opcode = 0;
-
-        if (info.type == "R") {
-            // R-Type: rd, rs1, rs2 (e.g., add x1, x2, x3)
-            opcode = encodeRType(ops[0], ops[1], ops[2], info.f3, info.f7, info.op);
-
-        } else if (info.type == "I" && mnemonic != "lw" && mnemonic != "jalr") {
-            // Standard I-Type: rd, rs1, imm (e.g., addi x1, x2, 100)
-            int imm = getImmediateValue(ops[2]);
-            if (imm == 999999999) { } 
-            
-            opcode = encodeIType(ops[0], ops[1], imm, info.f3, info.op, mnemonic);
-            
-        } else if (mnemonic == "lw" || mnemonic == "jalr") {
-            // Load I-Type: rd, imm(rs1) -> ops: rd, rs1, imm
-            // JALR I-Type: rd, imm(rs1) -> ops: rd, rs1, imm (often rd, rs1, 0)
-            int imm = getImmediateValue(ops[2]);
-            opcode = encodeIType(ops[0], ops[1], imm, info.f3, info.op, mnemonic);
-            
-        } else if (info.type == "S") {
-            // S-Type: rs2, imm(rs1) -> ops: rs2, rs1, imm
-            int imm = getImmediateValue(ops[2]);
-            opcode = encodeSType(ops[1], ops[0], imm, info.f3, info.op); // Note: rs1/rs2 swap for S-type register order
-            
-        } else if (info.type == "B") {
-            // B-Type: rs1, rs2, label -> ops: rs1, rs2, label
-            string label = ops[2];
-            unsigned int targetAddress = SYMBOL_TABLE.at(label);
-            // PC-relative immediate calculation: imm = Target - Current PC
-            int imm = (int)targetAddress - (int)address; 
-            opcode = encodeBType(ops[0], ops[1], imm, info.f3, info.op);
-
-        } else if (info.type == "J") {
-            // J-Type: rd, label -> ops: rd, label
-            string label = ops[1];
-            unsigned int targetAddress = SYMBOL_TABLE.at(label);
-            // PC-relative immediate calculation: imm = Target - Current PC
-            int imm = (int)targetAddress - (int)address; 
-            opcode = encodeJType(ops[0], imm, info.op);
-
-        } else {
-            cerr << "FATAL ERROR: Unhandled instruction type for " << mnemonic << " at 0x" << hex << address << endl;
-            exit(1);
-        }
-
-        opcodeMap[address] = opcode;
+        opcodeMap[inst.address] = encodeInstruction<XLEN>(inst, SYMBOL_TABLE);
     }
     return opcodeMap;
-}
\ No newline at end of file
+}
+
+template unsigned int encodeIType<32>(string, string, int, string, string, const string&);
+template unsigned int encodeIType<64>(string, string, int, string, string, const string&);
+template unsigned int encodeInstruction<32>(const ParsedInstruction&, const map<string, unsigned int>&);
+template unsigned int encodeInstruction<64>(const ParsedInstruction&, const map<string, unsigned int>&);
+template map<unsigned int, unsigned int> translateToOpcode<32>(const vector<ParsedInstruction>&);
+template map<unsigned int, unsigned int> translateToOpcode<64>(const vector<ParsedInstruction>&);
@@ -0,0 +1,252 @@
+#include "../hpp_files/incremental_asm.hpp"
+#include "../hpp_files/parser.hpp"
+#include "../hpp_files/encoder.hpp"
+#include "../hpp_files/compressed.hpp"
+#include <stdexcept>
+
+IncrementalAssembler::IncrementalAssembler() : dead_bytes(0), err_line(0), stats() {}
+
+bool IncrementalAssembler::set_error(size_t index, const string& message) {
+    err = message;
+    err_line = index + 1;
+    return false;
+}
+
+/**
+ * Classifies one raw editor line with the same rules as readAndPreprocess,
+ * buildSymbolTable, parseDataSection and parseInstructions. Whether it is
+ * emitted depends on the section, which layout() decides.
+ */
+void IncrementalAssembler::parse_line(const string& raw, AsmLine& out) {
+    out = AsmLine();
+    out.kind = ASM_BLANK;
+
+    string line = raw;
+    size_t commentPos = line.find('#');
+    if (commentPos != string::npos) line = line.substr(0, commentPos);
+    line.erase(0, line.find_first_not_of(" \t\r\n"));
+    line.erase(line.find_last_not_of(" \t\r\n") + 1);
+    if (line.empty()) return;
+
+    if (line == ".data") { out.kind = ASM_SECTION_DATA; return; }
+    if (line == ".text") { out.kind = ASM_SECTION_TEXT; return; }
+    if (line.find(".global") != string::npos) { out.kind = ASM_SKIP; return; }
+
+    string rest = line;
+    size_t labelPos = rest.find(':');
+    if (labelPos != string::npos) {
+        out.label = rest.substr(0, labelPos);
+        out.label.erase(remove_if(out.label.begin(), out.label.end(), ::isspace), out.label.end());
+        rest = rest.substr(labelPos + 1);
+        rest.erase(0, rest.find_first_not_of(" \t\r\n"));
+    }
+    if (rest.empty()) return;
+
+    if (rest[0] == '.') {
+        stringstream ss(rest);
+        string directive, valueStr;
+        ss >> directive >> valueStr;
+        if (rest == ".option rvc") out.kind = ASM_OPTION_RVC;
+        else if (rest == ".option norvc") out.kind = ASM_OPTION_NORVC;
+        else if (directive == ".word") {
+            out.kind = ASM_WORD;
+            out.value = getImmediateValue(valueStr);
+        } else {
+            out.kind = ASM_DIRECTIVE;
+        }
+        return;
+    }
+
+    // rest is a suffix of line, which becomes the instruction's text record
+    out.kind = ASM_INSTRUCTION;
+    if (!parseInstructionLine(line, line.size() - rest.size(), text_arena, out.inst, out.parse_error)) return;
+
+    const InstructionInfo* info = instructionInfo(out.inst.mnemonic_id);
+    if (!info) return; // Reported by encodeInstruction
+    if (info->type == "B" && out.inst.operand_count >= 3) out.target = string(out.inst.operand(2));
+    if (info->type == "J" && out.inst.operand_count >= 2) out.target = string(out.inst.operand(1));
+}
+
+/**
+ * Walks the cached lines assigning sections, addresses, labels and .data
+ * words. Instruction sizes come from relax().
+ */
+bool IncrementalAssembler::layout() {
+    symbol_table.clear();
+    data_segment.clear();
+
+    bool inData = false;
+    bool rvc = false;
+    unsigned int textAddress = INSTRUCTION_MEMORY_START;
+    unsigned int dataAddress = DATA_MEMORY_START;
+
+    for (size_t i = 0; i < lines.size(); i++) {
+        AsmLine& l = lines[i];
+        l.emitted = false;
+
+        if (l.kind == ASM_SECTION_DATA) { inData = true; continue; }
+        if (l.kind == ASM_SECTION_TEXT) { inData = false; continue; }
+        if (l.kind == ASM_SKIP) continue;
+
+        if (!l.label.empty()) {
+            if (symbol_table.count(l.label)) return set_error(i, "Duplicate label definition: " + l.label);
+            symbol_table[l.label] = inData ? dataAddress : textAddress;
+        }
+
+        if (inData) {
+            if (l.kind == ASM_WORD) {
+                data_segment[dataAddress] = l.value;
+                dataAddress += 4;
+                l.emitted = true;
+            }
+            continue;
+        }
+
+        if (l.kind == ASM_OPTION_RVC) rvc = true;
+        else if (l.kind == ASM_OPTION_NORVC) rvc = false;
+        else if (l.kind == ASM_INSTRUCTION) {
+            if (!l.parse_error.empty()) return set_error(i, l.parse_error);
+            l.inst.address = textAddress;
+            l.inst.rvc = rvc;
+            l.inst.line = (unsigned int)i + 1;
+            textAddress += l.inst.size;
+            l.emitted = true;
+        }
+    }
+    return true;
+}
+
+/**
+ * Same relaxation as relaxCompressed(): everything compressible starts at
+ * 2 bytes, and a C.BEQZ that cannot reach its target is widened until the
+ * layout is stable. Without ".option rvc" this is a single layout pass.
+ */
+bool IncrementalAssembler::relax() {
+    for (AsmLine& l : lines) {
+        if (l.kind == ASM_INSTRUCTION) l.inst.size = 4;
+    }
+    if (!layout()) return false;
+
+    bool anyCompressed = false;
+    for (AsmLine& l : lines) {
+        if (!l.emitted || l.kind != ASM_INSTRUCTION || !isCompressible(l.inst)) continue;
+        l.inst.size = 2;
+        anyCompressed = true;
+    }
+    if (!anyCompressed) return true;
+
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        if (!layout()) return false;
+
+        for (size_t i = 0; i < lines.size(); i++) {
+            AsmLine& l = lines[i];
+            if (!l.emitted || l.kind != ASM_INSTRUCTION || l.inst.size != 2 || l.inst.mnemonic() != "beq") continue;
+            auto target = symbol_table.find(l.target);
+            if (target == symbol_table.end()) return set_error(i, "Undefined label: " + l.target);
+            if (!fitsCompressedBranch((int)target->second - (int)l.inst.address)) {
+                l.inst.size = 4;
+                changed = true;
+            }
+        }
+    }
+    return true;
+}
+
+// Re-encode only instructions whose line, size, RVC mode or label offset changed
+bool IncrementalAssembler::encode() {
+    for (size_t i = 0; i < lines.size(); i++) {
+        AsmLine& l = lines[i];
+        if (!l.emitted || l.kind != ASM_INSTRUCTION) continue;
+
+        int offset = 0;
+        if (!l.target.empty()) {
+            auto target = symbol_table.find(l.target);
+            if (target == symbol_table.end()) return set_error(i, "Undefined label: " + l.target);
+            offset = (int)target->second - (int)l.inst.address;
+        }
+        if (l.encoded && l.encoded_size == l.inst.size && l.encoded_rvc == l.inst.rvc && l.encoded_offset == offset) {
+            continue;
+        }
+
+        try {
+            l.word = encodeInstruction(l.inst, symbol_table);
+        } catch (const std::exception& e) {
+            return set_error(i, e.what());
+        }
+        l.encoded = true;
+        l.encoded_size = l.inst.size;
+        l.encoded_rvc = l.inst.rvc;
+        l.encoded_offset = offset;
+        stats.encodes++;
+        stats.last_encoded++;
+    }
+    return true;
+}
+
+bool IncrementalAssembler::edit(size_t first, size_t removed, const vector<string>& source) {
+    err.clear();
+    err_line = 0;
+    if (first > lines.size() || removed > lines.size() - first) {
+        err = "Edit range is outside the source";
+        return false;
+    }
+
+    stats.edits++;
+    stats.last_parsed = source.size();
+    stats.last_encoded = 0;
+    stats.lines_parsed += source.size();
+
+    vector<AsmLine> fresh(source.size());
+    for (size_t i = 0; i < source.size(); i++) parse_line(source[i], fresh[i]);
+
+    for (size_t i = first; i < first + removed; i++) dead_bytes += lines[i].inst.record_length;
+    lines.erase(lines.begin() + first, lines.begin() + first + removed);
+    lines.insert(lines.begin() + first, std::make_move_iterator(fresh.begin()), std::make_move_iterator(fresh.end()));
+    if (dead_bytes > AsmArena::CHUNK_BYTES && dead_bytes > text_arena.bytes_used() / 2) compact();
+
+    return relax() && encode();
+}
+
+// Copy the text of the current lines into a fresh arena, dropping replaced ones
+void IncrementalAssembler::compact() {
+    AsmArena fresh;
+    for (AsmLine& l : lines) {
+        if (l.inst.text) l.inst.text = fresh.copy(l.inst.text, l.inst.record_length);
+    }
+    text_arena = std::move(fresh);
+    dead_bytes = 0;
+}
+
+bool IncrementalAssembler::assemble(const string& source) {
+    vector<string> split_lines;
+    std::istringstream stream(source);
+    string line;
+    while (getline(stream, line)) split_lines.push_back(line);
+    return edit(0, lines.size(), split_lines);
+}
+
+vector<ParsedInstruction> IncrementalAssembler::instructions() const {
+    vector<ParsedInstruction> out;
+    for (const AsmLine& l : lines) {
+        if (l.emitted && l.kind == ASM_INSTRUCTION) out.push_back(l.inst);
+    }
+    return out;
+}
+
+map<unsigned int, unsigned int> IncrementalAssembler::text_image() const {
+    map<unsigned int, unsigned int> image;
+    for (const AsmLine& l : lines) {
+        if (l.emitted && l.kind == ASM_INSTRUCTION) image.emplace_hint(image.end(), l.inst.address, l.word);
+    }
+    return image;
+}
+
+vector<size_t> IncrementalAssembler::instruction_lines() const {
+    vector<size_t> out;
+    for (size_t i = 0; i < lines.size(); i++) {
+        if (lines[i].emitted && lines[i].kind == ASM_INSTRUCTION) out.push_back(i + 1);
+    }
+    return out;
+}
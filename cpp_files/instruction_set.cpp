@@ -7,12 +7,54 @@ map<string, InstructionInfo> INSTRUCTION_SET = {
 
     {"slli", {"I", "0010011", "001", "0000000"}},
     {"lw",   {"I", "0000011", "010"}},
+    {"ld",   {"I", "0000011", "011"}}, // RV64 only
 
     {"sw",   {"S", "0100011", "010"}},
+    {"sd",   {"S", "0100011", "011"}}, // RV64 only
     
     {"beq",  {"B", "1100011", "000"}},
     {"blt",  {"B", "1100011", "100"}},
+
+    {"fence.i", {"I", "0001111", "001"}},
+
+    // Vector subset (SEW=32, LMUL=1); f7 holds funct6 for OP-V
+    {"vsetvli",    {"VSET", "1010111", "111"}},
+    {"vle32.v",    {"VL",   "0000111", "110"}},
+    {"vse32.v",    {"VS",   "0100111", "110"}},
+    {"vadd.vv",    {"V",    "1010111", "000", "000000"}},
+    {"vmul.vv",    {"V",    "1010111", "010", "100101"}},
+    {"vsll.vv",    {"V",    "1010111", "000", "100101"}},
+    {"vsll.vi",    {"V",    "1010111", "011", "100101"}},
+    {"vredsum.vs", {"V",    "1010111", "010", "000000"}},
 };
 
 map<unsigned int, unsigned int> INSTRUCTION_MEMORY;
 map<string, unsigned int> SYMBOL_TABLE;
+
+// INSTRUCTION_SET entries in key order, so an ID is a binary-search result
+static const vector<const pair<const string, InstructionInfo>*>& mnemonicTable() {
+    static const vector<const pair<const string, InstructionInfo>*> table = [] {
+        vector<const pair<const string, InstructionInfo>*> entries;
+        for (const auto& entry : INSTRUCTION_SET) entries.push_back(&entry);
+        return entries;
+    }();
+    return table;
+}
+
+uint16_t mnemonicId(string_view mnemonic) {
+    const auto& table = mnemonicTable();
+    auto it = lower_bound(table.begin(), table.end(), mnemonic,
+                          [](const pair<const string, InstructionInfo>* e, string_view m) { return string_view(e->first) < m; });
+    return (it != table.end() && (*it)->first == mnemonic) ? (uint16_t)(it - table.begin()) : NO_MNEMONIC;
+}
+
+const InstructionInfo* instructionInfo(uint16_t id) {
+    const auto& table = mnemonicTable();
+    return (id < table.size()) ? &table[id]->second : nullptr;
+}
+
+const string& mnemonicName(uint16_t id) {
+    static const string unknown;
+    const auto& table = mnemonicTable();
+    return (id < table.size()) ? table[id]->first : unknown;
+}
@@ -0,0 +1,277 @@
+#include "../hpp_files/lane_sim.hpp"
+#include "../hpp_files/compressed.hpp"
+#include "../hpp_files/vector_kernels.hpp"
+#include <cstring>
+
+// Opcode Constants
+#define OP_R_TYPE 0x33
+#define OP_I_TYPE 0x13
+#define OP_LW     0x03
+#define OP_SW     0x23
+#define OP_BRANCH 0x63
+#define OP_FENCE  0x0F
+
+static int32_t sign12(uint32_t value) {
+    return (int32_t)(value << 20) >> 20;
+}
+
+static LaneInst decodeLane(uint32_t inst, uint8_t size) {
+    LaneInst d;
+    d.valid = (inst != 0);
+    d.size = size;
+    d.opcode = inst & 0x7F;
+    d.rd = (inst >> 7) & 0x1F;
+    d.func3 = (inst >> 12) & 0x07;
+    d.rs1 = (inst >> 15) & 0x1F;
+    d.rs2 = (inst >> 20) & 0x1F;
+    d.func7 = (inst >> 25) & 0x7F;
+
+    if (d.opcode == OP_I_TYPE || d.opcode == OP_LW) {
+        d.IMM = (int32_t)inst >> 20;
+    } else if (d.opcode == OP_SW) {
+        d.IMM = sign12(((inst >> 25) << 5) | ((inst >> 7) & 0x1F));
+    } else if (d.opcode == OP_BRANCH) {
+        int32_t value = ((inst >> 31) << 12) | (((inst >> 7) & 0x1) << 11) | (((inst >> 25) & 0x3F) << 5) | (((inst >> 8) & 0xF) << 1);
+        d.IMM = (value << 19) >> 19;
+    } else {
+        d.IMM = 0;
+    }
+    return d;
+}
+
+LaneSimulator::LaneSimulator(const std::map<unsigned int, unsigned int>& imem, unsigned int lanes, uint32_t bytes)
+    : n(lanes), stride((lanes + LANE_PAD - 1) / LANE_PAD * LANE_PAD), mem_bytes(bytes & ~3u),
+      converged(true), shared_pc(0), live(lanes), text_start(0)
+{
+    regs.assign(32 * stride, 0);
+    mem.assign((mem_bytes / 4) * stride, 0);
+    pc.assign(stride, 0);
+    alive.assign(stride, 0);
+    fault.assign(stride, 0);
+    active.assign(stride, 0);
+    result.assign(stride, 0);
+    cond.assign(stride, 0);
+    for (unsigned int l = 0; l < n; l++) alive[l] = -1;
+    std::memset(&stats, 0, sizeof(stats));
+
+    // Predecode the text image once; every lane shares it
+    if (!imem.empty()) {
+        text_start = imem.begin()->first;
+        uint32_t text_end = imem.rbegin()->first + 4;
+        program.assign((text_end - text_start) / 2, LaneInst{});
+        for (auto const& [addr, word] : imem) {
+            bool compressed = isCompressedEncoding(word);
+            uint32_t inst = compressed ? expandCompressed(word & 0xFFFF) : word;
+            program[(addr - text_start) / 2] = decodeLane(inst, compressed ? 2 : 4);
+        }
+    }
+    shared_pc = text_start;
+}
+
+void LaneSimulator::load_data(const std::map<unsigned int, int32_t>& data) {
+    for (auto const& [addr, val] : data) {
+        for (unsigned int l = 0; l < n; l++) set_mem_word(l, addr, val);
+    }
+}
+
+void LaneSimulator::set_reg(unsigned int lane, int idx, int32_t val) {
+    if (lane < n && idx > 0 && idx < 32) regs[idx * stride + lane] = val;
+}
+
+uint8_t LaneSimulator::read8(unsigned int lane, uint32_t addr) const {
+    uint32_t word = (uint32_t)mem[(addr >> 2) * stride + lane];
+    return (word >> ((addr & 3) * 8)) & 0xFF;
+}
+
+void LaneSimulator::write8(unsigned int lane, uint32_t addr, uint8_t val) {
+    uint32_t& word = (uint32_t&)mem[(addr >> 2) * stride + lane];
+    uint32_t shift = (addr & 3) * 8;
+    word = (word & ~(0xFFu << shift)) | ((uint32_t)val << shift);
+}
+
+void LaneSimulator::set_mem_word(unsigned int lane, uint32_t addr, int32_t val) {
+    if (lane >= n || (uint64_t)addr + 4 > mem_bytes) return;
+    if ((addr & 3) == 0) {
+        mem[(addr >> 2) * stride + lane] = val;
+        return;
+    }
+    for (int i = 0; i < 4; i++) write8(lane, addr + i, ((uint32_t)val >> (8 * i)) & 0xFF);
+}
+
+int32_t LaneSimulator::get_mem_word(unsigned int lane, uint32_t addr) const {
+    if (lane >= n || (uint64_t)addr + 4 > mem_bytes) return 0;
+    if ((addr & 3) == 0) return mem[(addr >> 2) * stride + lane];
+    return read8(lane, addr) | (read8(lane, addr + 1) << 8) | (read8(lane, addr + 2) << 16) |
+           ((uint32_t)read8(lane, addr + 3) << 24);
+}
+
+const LaneInst* LaneSimulator::fetch(uint32_t addr) const {
+    if (addr < text_start || (addr & 1)) return nullptr;
+    uint32_t index = (addr - text_start) / 2;
+    if (index >= program.size() || !program[index].valid) return nullptr;
+    return &program[index];
+}
+
+void LaneSimulator::kill_lane(unsigned int lane, bool faulted) {
+    if (!alive[lane]) return;
+    if (converged) pc[lane] = shared_pc;
+    alive[lane] = 0;
+    fault[lane] = faulted;
+    live--;
+}
+
+// rd <- value on the lanes in mask (mask == nullptr: value is already rd's row)
+void LaneSimulator::write_rd(uint8_t rd, const int32_t* value, const int32_t* mask) {
+    if (rd == 0 || mask == nullptr) return;
+    vk_blend_i32(row(rd), value, mask, stride);
+}
+
+/**
+ * LW/SW gather/scatter, one lane at a time. Out-of-bounds accesses behave as
+ * in the pipelined model: a load returns 0 and a store is dropped.
+ */
+void LaneSimulator::memory_access(const LaneInst& inst, const int32_t* mask) {
+    const int32_t* base = &regs[inst.rs1 * stride];
+    for (unsigned int l = 0; l < n; l++) {
+        if (!(mask ? mask[l] : alive[l])) continue;
+
+        uint32_t addr = (uint32_t)base[l] + (uint32_t)inst.IMM;
+        bool ok = (uint64_t)addr + 4 <= mem_bytes;
+        if (inst.opcode == OP_LW) {
+            int32_t value = ok ? get_mem_word(l, addr) : 0;
+            if (inst.rd != 0) regs[inst.rd * stride + l] = value;
+        } else if (ok) {
+            set_mem_word(l, addr, regs[inst.rs2 * stride + l]);
+        }
+    }
+}
+
+void LaneSimulator::execute(const LaneInst& inst, uint32_t at, const int32_t* mask) {
+    const int32_t* a = row(inst.rs1);
+    const int32_t* b = row(inst.rs2);
+    // Unmasked ops write straight into rd's row; masked ones blend from result[]
+    int32_t* out = (mask == nullptr && inst.rd != 0) ? row(inst.rd) : result.data();
+    bool legal = true;
+
+    switch (inst.opcode) {
+    case OP_R_TYPE:
+        if (inst.func3 == 0x1) vk_sll_i32(out, a, b, stride);
+        else if (inst.func3 == 0x2) vk_slt_i32(out, a, b, stride);
+        else legal = false;
+        if (legal) write_rd(inst.rd, out, mask);
+        break;
+
+    case OP_I_TYPE:
+        if (inst.func3 == 0x1) vk_slli_i32(out, a, inst.IMM & 0x1F, stride);
+        else legal = false;
+        if (legal) write_rd(inst.rd, out, mask);
+        break;
+
+    case OP_LW:
+    case OP_SW:
+        if (inst.func3 == 0x2) memory_access(inst, mask);
+        else legal = false;
+        break;
+
+    case OP_FENCE:
+        break;
+
+    case OP_BRANCH: {
+        if (inst.func3 == 0x0) vk_cmpeq_i32(cond.data(), a, b, stride);
+        else if (inst.func3 == 0x4) vk_cmplt_i32(cond.data(), a, b, stride);
+        else { legal = false; break; }
+
+        uint32_t taken = at + inst.IMM;
+        uint32_t next = at + inst.size;
+        if (converged) {
+            unsigned int count = 0;
+            for (unsigned int l = 0; l < n; l++) count += (alive[l] && cond[l]) ? 1 : 0;
+            if (count == live) { shared_pc = taken; return; }
+            if (count == 0)    { shared_pc = next; return; }
+
+            // Lanes split: fall back to per-lane PCs
+            converged = false;
+            for (unsigned int l = 0; l < n; l++) {
+                if (alive[l]) pc[l] = cond[l] ? taken : next;
+            }
+        } else {
+            for (unsigned int l = 0; l < n; l++) {
+                if (mask[l]) pc[l] = cond[l] ? taken : next;
+            }
+        }
+        return;
+    }
+
+    default:
+        legal = false;
+        break;
+    }
+
+    if (!legal) {
+        // Unsupported in the lane model: the issuing lanes stop with a fault
+        for (unsigned int l = 0; l < n; l++) {
+            if (mask ? mask[l] : alive[l]) kill_lane(l, true);
+        }
+    }
+
+    uint32_t next = at + inst.size;
+    if (converged) {
+        shared_pc = next;
+    } else {
+        for (unsigned int l = 0; l < n; l++) {
+            if (mask[l]) pc[l] = next;
+        }
+    }
+}
+
+uint64_t LaneSimulator::run(uint64_t max_steps) {
+    uint64_t issued = 0;
+
+    while (live > 0 && issued < max_steps) {
+        uint32_t at;
+        unsigned int issuing;
+        const int32_t* mask;
+
+        if (!converged) {
+            // Lowest PC among live lanes issues; everyone else waits there
+            at = UINT32_MAX;
+            for (unsigned int l = 0; l < n; l++) {
+                if (alive[l] && pc[l] < at) at = pc[l];
+            }
+            issuing = 0;
+            for (unsigned int l = 0; l < stride; l++) {
+                active[l] = (alive[l] && pc[l] == at) ? -1 : 0;
+                issuing += active[l] ? 1 : 0;
+            }
+            if (issuing == live) {
+                converged = true;
+                shared_pc = at;
+            }
+        }
+
+        if (converged) {
+            at = shared_pc;
+            issuing = live;
+            mask = (live == n) ? nullptr : alive.data();
+        } else {
+            mask = active.data();
+            stats.divergent_steps++;
+        }
+
+        const LaneInst* inst = fetch(at);
+        if (inst == nullptr) {
+            // Ran off the end of .text
+            for (unsigned int l = 0; l < n; l++) {
+                if (mask ? mask[l] : alive[l]) kill_lane(l, false);
+            }
+            continue;
+        }
+
+        issued++;
+        stats.steps++;
+        stats.instance_instructions += issuing;
+        stats.lane_slots += n;
+        execute(*inst, at, mask);
+    }
+    return issued;
+}
@@ -1,338 +1,1038 @@
-#include "../hpp_files/assembler.hpp"
-#include "../hpp_files/parser.hpp"
-#include "../hpp_files/encoder.hpp"
-#include "../hpp_files/simulator.hpp"
+#include "../hpp_files/riscvsim.h"
+#include "../hpp_files/riscvsim_program.hpp"
+#include "../hpp_files/compressed.hpp"
+#include "../hpp_files/vector_kernels.hpp"
+#include "../hpp_files/vector_unit.hpp"
+#include "../hpp_files/sim_snapshot.hpp"
+#include "../hpp_files/sim_delta.hpp"
+#include "../hpp_files/sim_stats.hpp"
+#include "../hpp_files/lane_sim.hpp"
+#include "../hpp_files/sim_status.hpp"
+#include "../hpp_files/incremental_asm.hpp"
+#include "../hpp_files/disassembler.hpp"
+#include "../hpp_files/xlen.hpp"
 #include <emscripten/emscripten.h>
 #include <emscripten/bind.h>
-#include <sstream>
+#include <cstdarg>
+#include <cstdio>
+#include <chrono>
+#include <memory>
+#ifdef __EMSCRIPTEN_PTHREADS__
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#endif
 
 using namespace emscripten;
 
-// Global simulator instance
-RISCV_Simulator* globalSim = nullptr;
-vector<ParsedInstruction> globalInstructions;
-bool isInitialized = false;
+// The bindings drive one libriscvsim session (riscvsim.h). Register width is
+// chosen at build time (-DRISCV_XLEN=64 for RV64I; 64-bit values cross to JS
+// as BigInt and need -s WASM_BIGINT)
+typedef XlenTraits<RISCV_XLEN>::uxlen_t uxlen_t;
+typedef XlenTraits<RISCV_XLEN>::sxlen_t sxlen_t;
+
+// Global session and the program loaded into it (listing, lane sweeps, code size)
+rvsim_session* globalSession = nullptr;
+rvsim_program* globalProgram = nullptr;
+bool unifiedMemory = false; // Survives re-initialization and reset
+unsigned int vectorLength = DEFAULT_VLEN; // VLEN in bits, also kept across resets
+
+const int MAX_RUN_CYCLES = 10000; // Safety limit for runSimulator and background runs
+
+// Message for the last failed binding. A fixed buffer, so calls that
+// succeed (the GUI's hot loop) never allocate or copy strings to JS.
+char lastError[256] = "";
+
+int fail(int status, const char* format, ...) {
+    va_list args;
+    va_start(args, format);
+    vsnprintf(lastError, sizeof(lastError), format, args);
+    va_end(args);
+    return status;
+}
+
+int succeed() {
+    lastError[0] = '\0';
+    return SIM_OK;
+}
+
+// Status of a library call; on failure its message becomes lastError
+int check(int status) {
+    if (status == SIM_OK) return succeed();
+    return fail(status, "%s", rvsim_last_error());
+}
+
+#define REQUIRE_SIM() \
+    if (globalSession == nullptr) return fail(SIM_ERR_NOT_INITIALIZED, "Simulator not initialized")
+
+// Published simulator state; in the -pthread build this is shared memory JS reads directly
+SimSnapshot snapshot;
+
+#ifdef __EMSCRIPTEN_PTHREADS__
+// -pthread build: a background thread runs the simulation loop. Every
+// binding that touches globalSession holds simMutex; the thread drops it
+// between batches of PUBLISH_INTERVAL cycles.
+const uint32_t PUBLISH_INTERVAL = 32;
+std::mutex simMutex;
+std::condition_variable simWake;
+std::atomic<bool> simRunRequested(false);
+bool simThreadStarted = false;
+#define SIM_LOCK() std::lock_guard<std::mutex> simLock(simMutex)
+#else
+#define SIM_LOCK()
+#endif
 
 // Structure to hold pipeline state for JS
 struct PipelineStateJS {
     // IF/ID
-    uint32_t if_id_pc;
+    uxlen_t if_id_pc;
     uint32_t if_id_ir;
-    uint32_t if_id_npc;
+    uxlen_t if_id_npc;
     
     // ID/EX
+    uxlen_t id_ex_pc;
     uint32_t id_ex_ir;
-    int32_t id_ex_a;
-    int32_t id_ex_b;
-    int32_t id_ex_imm;
-    uint32_t id_ex_npc;
+    sxlen_t id_ex_a;
+    sxlen_t id_ex_b;
+    sxlen_t id_ex_imm;
+    uxlen_t id_ex_npc;
     
     // EX/MEM
+    uxlen_t ex_mem_pc;
     uint32_t ex_mem_ir;
-    int32_t ex_mem_aluoutput;
-    uint32_t ex_mem_b;
+    sxlen_t ex_mem_aluoutput;
+    uxlen_t ex_mem_b;
     bool ex_mem_cond;
     
     // MEM/WB
+    uxlen_t mem_wb_pc;
     uint32_t mem_wb_ir;
-    int32_t mem_wb_aluoutput;
-    int32_t mem_wb_lmd;
+    sxlen_t mem_wb_aluoutput;
+    sxlen_t mem_wb_lmd;
     uint8_t mem_wb_rd;
     bool mem_wb_regwrite;
 };
 
+// Statistics for JS (embind has no 64-bit integers without BigInt)
+struct SimStatsJS {
+    double cycles;
+    double instructions;
+    double stall_cycles;
+    double flushes;
+    double itlb_hits;
+    double itlb_misses;
+    double dtlb_hits;
+    double dtlb_misses;
+    double page_walks;
+    double walk_cycles;
+    double traps;
+    double decode_hits;
+    double decode_misses;
+    double code_writes;
+    double fetch_bytes;
+    double compressed_fetches;
+    double vector_instructions;
+    double vector_elements;
+    double vector_lane_slots;  // Lane utilization = vector_elements / vector_lane_slots
+};
+
+// Per-instruction vector counts (instructions executed / elements processed)
+struct VectorStatsJS {
+    double vle32_count, vle32_elements;
+    double vse32_count, vse32_elements;
+    double vadd_count, vadd_elements;
+    double vmul_count, vmul_elements;
+    double vsll_count, vsll_elements;
+    double vredsum_count, vredsum_elements;
+    double utilization;        // 0..1, 0 before any vector instruction
+};
+
+// Result of runLaneSweep: many instances on the lane model vs. one at a time
+struct LaneSweepJS {
+    uint32_t lanes;
+    double instance_instructions;
+    double steps;
+    double divergent_steps;
+    double utilization;        // Active lanes / lane slots over all steps
+    double simd_ms, scalar_ms;
+    double simd_ips, scalar_ips;
+    double speedup;
+    uint32_t faulted;          // Lanes stopped on an instruction the lane model lacks
+};
+
+// Lanes from the last sweep, for getLaneRegister / getLaneMemoryWord
+std::unique_ptr<LaneSimulator> laneSweep;
+
+// Ran off the end of .text (or halted) with nothing left in the pipeline
+bool programFinished() {
+    return rvsim_is_finished(globalSession) != 0;
+}
+
+// Drop the loaded session and program
+void unloadProgram() {
+    rvsim_destroy(globalSession);
+    globalSession = nullptr;
+    rvsim_program_free(globalProgram);
+    globalProgram = nullptr;
+}
+
 // Initialize the simulator with assembly code
-std::string initializeSimulator(std::string assemblyCode) {
-    try {
-        // Clean up existing simulator
-        if (globalSim != nullptr) {
-            delete globalSim;
-            globalSim = nullptr;
-        }
-        
-        // Clear global state
-        INSTRUCTION_MEMORY.clear();
-        SYMBOL_TABLE.clear();
-        DATA_SEGMENT.clear();
-        globalInstructions.clear();
-        
-        // Write assembly to temporary processing
-        std::istringstream stream(assemblyCode);
-        vector<string> lines;
-        string line;
-        
-        while (getline(stream, line)) {
-            // Remove comments
-            size_t commentPos = line.find('#');
-            if (commentPos != string::npos) {
-                line = line.substr(0, commentPos);
-            }
-            
-            // Trim whitespace
-            line.erase(0, line.find_first_not_of(" \t\r\n"));
-            line.erase(line.find_last_not_of(" \t\r\n") + 1);
-            
-            if (!line.empty()) {
-                lines.push_back(line);
-            }
-        }
-        
-        if (lines.empty()) {
-            return "ERROR: No valid assembly code provided";
-        }
-        
-        // Build symbol table and parse
-        SYMBOL_TABLE = buildSymbolTable(lines);
-        parseDataSection(lines);
-        globalInstructions = parseInstructions(lines);
-        
-        // Translate to opcodes
-        INSTRUCTION_MEMORY = translateToOpcode(globalInstructions);
-        
-        // Create simulator
-        globalSim = new RISCV_Simulator(INSTRUCTION_MEMORY);
-        
-        // Load data segment
-        if (!DATA_SEGMENT.empty()) {
-            for (auto const& [addr, val] : DATA_SEGMENT) {
-                globalSim->set_memory(addr,     val & 0xFF);
-                globalSim->set_memory(addr + 1, (val >> 8) & 0xFF);
-                globalSim->set_memory(addr + 2, (val >> 16) & 0xFF);
-                globalSim->set_memory(addr + 3, (val >> 24) & 0xFF);
-            }
-        }
-        
-        isInitialized = true;
-        return "SUCCESS: Simulator initialized with " + std::to_string(globalInstructions.size()) + " instructions";
-        
-    } catch (const std::exception& e) {
-        return std::string("ERROR: ") + e.what();
+int initializeSimulator(std::string assemblyCode) {
+    SIM_LOCK();
+#ifdef __EMSCRIPTEN_PTHREADS__
+    simRunRequested = false; // A background run must not pick up the new program
+#endif
+    unloadProgram();
+
+    int status = rvsim_assemble(assemblyCode.data(), assemblyCode.size(), RISCV_XLEN, &globalProgram);
+    if (status == SIM_OK) status = rvsim_create(globalProgram, RVSIM_TRACE, &globalSession);
+    if (status == SIM_OK) status = rvsim_set_unified_memory(globalSession, unifiedMemory);
+    if (status == SIM_OK) status = rvsim_set_vlen(globalSession, vectorLength);
+    if (status != SIM_OK) {
+        int result = check(status);
+        unloadProgram();
+        return result;
     }
+    return succeed();
 }
 
-// Execute one cycle
-std::string stepSimulator() {
-    if (!isInitialized || globalSim == nullptr) {
-        return "ERROR: Simulator not initialized";
-    }
-    
-    try {
-        globalSim->step();
-        return "SUCCESS: Executed 1 cycle";
-    } catch (const std::exception& e) {
-        return std::string("ERROR: ") + e.what();
+// What the last reloadProgram() changed
+struct ReloadStatsJS {
+    uint32_t text_changed;    // Instruction slots added, removed or re-encoded
+    uint32_t data_changed;    // .data words added, removed or changed
+    uint32_t symbols_changed; // Labels added, removed or moved
+    bool kept_state;
+};
+ReloadStatsJS lastReload = {0, 0, 0, false};
+
+// Patch an assembled program into the running session and make it the
+// loaded program (takes ownership of it). Caller holds the simulator lock.
+int patchProgram(rvsim_program* program, bool keepState) {
+#ifdef __EMSCRIPTEN_PTHREADS__
+    simRunRequested = false;
+#endif
+    rvsim_reload_stats st = {0, 0, 0};
+    int status = rvsim_reload(globalSession, program, keepState, &st);
+    lastReload = {st.text_changed, st.data_changed, st.symbols_changed, keepState};
+    if (status != SIM_OK) {
+        rvsim_program_free(program);
+        return check(status);
     }
+    rvsim_program_free(globalProgram);
+    globalProgram = program;
+    return succeed();
 }
 
-// Run until completion (max 10000 cycles for safety)
-std::string runSimulator() {
-    if (!isInitialized || globalSim == nullptr) {
-        return "ERROR: Simulator not initialized";
+// Assemble edited source and patch it into the running simulator. Only
+// instruction words that differ from the loaded program are rewritten and
+// only their decode-cache entries are dropped. With keepState, registers,
+// PC, memory and in-flight instructions are untouched (the new .data goes
+// into the reset image); otherwise the simulator resets onto the new program.
+int reloadProgram(std::string assemblyCode, bool keepState) {
+    SIM_LOCK();
+    REQUIRE_SIM();
+
+    // A source that fails to assemble leaves the simulator as it was
+    rvsim_program* program = nullptr;
+    int status = rvsim_assemble(assemblyCode.data(), assemblyCode.size(), RISCV_XLEN, &program);
+    if (status != SIM_OK) return check(status);
+    return patchProgram(program, keepState);
+}
+
+// Editor source, kept assembled line by line as it is typed (see assembleEdit)
+IncrementalAssembler editorAsm;
+
+// Replace editor lines [first, first + removed) with lines (a JS string array)
+// and reassemble incrementally. Line numbers are 0-based here; errors report
+// the 1-based editor line.
+int assembleEdit(uint32_t first, uint32_t removed, val lines) {
+    if (editorAsm.edit(first, removed, vecFromJSArray<std::string>(lines))) return succeed();
+    if (editorAsm.error_line() == 0) return fail(SIM_ERR_INVALID_ARGUMENT, "%s", editorAsm.error().c_str());
+    return fail(SIM_ERR_ASSEMBLY, "Line %zu: %s", editorAsm.error_line(), editorAsm.error().c_str());
+}
+
+// Counts for the editor status line
+struct EditorAsmJS {
+    uint32_t lines;
+    uint32_t instructions;
+    uint32_t data_words;
+    uint32_t labels;
+    uint32_t last_parsed;   // Lines re-parsed by the last edit
+    uint32_t last_encoded;  // Instructions re-encoded by the last edit
+    uint32_t error_line;    // 1-based, 0 if the source assembles
+};
+
+EditorAsmJS getEditorAssembly() {
+    EditorAsmJS r;
+    const IncrementalAsmStats& st = editorAsm.get_stats();
+    r.lines = (uint32_t)editorAsm.line_count();
+    r.instructions = (uint32_t)editorAsm.instruction_lines().size();
+    r.data_words = (uint32_t)editorAsm.data().size();
+    r.labels = (uint32_t)editorAsm.symbols().size();
+    r.last_parsed = (uint32_t)st.last_parsed;
+    r.last_encoded = (uint32_t)st.last_encoded;
+    r.error_line = (uint32_t)editorAsm.error_line();
+    return r;
+}
+
+// Hot reload from the editor's incremental assembly (no full re-assemble)
+int reloadFromEditor(bool keepState) {
+    SIM_LOCK();
+    REQUIRE_SIM();
+    if (editorAsm.error_line() != 0 || !editorAsm.error().empty()) {
+        return fail(SIM_ERR_ASSEMBLY, "Line %zu: %s", editorAsm.error_line(), editorAsm.error().c_str());
     }
-    
-    try {
-        int maxCycles = 10000;
-        int cyclesRun = 0;
-        uint32_t lastAddr = globalInstructions.back().address + 4;
-        
-        while (globalSim->get_pc() <= lastAddr && cyclesRun < maxCycles) {
-            globalSim->step();
-            cyclesRun++;
-        }
-        
-        return "SUCCESS: Executed " + std::to_string(cyclesRun) + " cycles";
-    } catch (const std::exception& e) {
-        return std::string("ERROR: ") + e.what();
+    vector<ParsedInstruction> instructions = editorAsm.instructions();
+    if (instructions.empty()) {
+        return fail(SIM_ERR_ASSEMBLY, "No valid assembly code provided");
     }
+    // The editor's text records change with the next edit; the program keeps a copy
+    rvsim_program* program = rvsimProgramFromParts(RISCV_XLEN, std::move(instructions), editorAsm.text_image(),
+                                                   editorAsm.symbols(), editorAsm.data());
+    return patchProgram(program, keepState);
+}
+
+ReloadStatsJS getLastReloadStats() {
+    return lastReload;
+}
+
+// Instructions in the loaded program
+uint32_t getInstructionCount() {
+    return rvsim_program_instruction_count(globalProgram);
+}
+
+// Execute one cycle
+int stepSimulator() {
+    SIM_LOCK();
+    REQUIRE_SIM();
+    return check(rvsim_step(globalSession));
+}
+
+// Run until completion (max 10000 cycles for safety)
+int runSimulator() {
+    SIM_LOCK();
+    REQUIRE_SIM();
+    return check(rvsim_run(globalSession, MAX_RUN_CYCLES, nullptr));
 }
 
 // Reset simulator
-std::string resetSimulator() {
-    if (!isInitialized || globalSim == nullptr) {
-        return "ERROR: Simulator not initialized";
-    }
-    
-    try {
-        delete globalSim;
-        globalSim = new RISCV_Simulator(INSTRUCTION_MEMORY);
-        
-        // Reload data segment
-        if (!DATA_SEGMENT.empty()) {
-            for (auto const& [addr, val] : DATA_SEGMENT) {
-                globalSim->set_memory(addr,     val & 0xFF);
-                globalSim->set_memory(addr + 1, (val >> 8) & 0xFF);
-                globalSim->set_memory(addr + 2, (val >> 16) & 0xFF);
-                globalSim->set_memory(addr + 3, (val >> 24) & 0xFF);
-            }
-        }
-        
-        return "SUCCESS: Simulator reset";
-    } catch (const std::exception& e) {
-        return std::string("ERROR: ") + e.what();
-    }
+int resetSimulator() {
+    SIM_LOCK();
+    REQUIRE_SIM();
+#ifdef __EMSCRIPTEN_PTHREADS__
+    simRunRequested = false;
+#endif
+    // Restores the post-init state in place; unified mode and VLEN carry over
+    return check(rvsim_reset(globalSession));
 }
 
 // Get current PC
-uint32_t getPC() {
-    if (!isInitialized || globalSim == nullptr) return 0;
-    return globalSim->get_pc();
+uxlen_t getPC() {
+    SIM_LOCK();
+    return (uxlen_t)rvsim_get_pc(globalSession);
 }
 
 // Get register value
-int32_t getRegister(int idx) {
-    if (!isInitialized || globalSim == nullptr) return 0;
-    if (idx < 0 || idx > 31) return 0;
-    return globalSim->get_reg(idx);
+sxlen_t getRegister(int idx) {
+    SIM_LOCK();
+    return (sxlen_t)rvsim_get_reg(globalSession, idx);
 }
 
 // Set register value
-std::string setRegister(int idx, int32_t value) {
-    if (!isInitialized || globalSim == nullptr) {
-        return "ERROR: Simulator not initialized";
+int setRegister(int idx, sxlen_t value) {
+    SIM_LOCK();
+    REQUIRE_SIM();
+    return check(rvsim_set_reg(globalSession, idx, value));
+}
+
+// Set x1..x(n-1) from an array of up to 32 values (element 0, x0, is ignored)
+int setRegisters(emscripten::val values) {
+    SIM_LOCK();
+    REQUIRE_SIM();
+    unsigned int count = values["length"].as<unsigned int>();
+    if (count > 32) {
+        return fail(SIM_ERR_INVALID_ARGUMENT, "Expected at most 32 register values, got %u", count);
     }
-    if (idx < 1 || idx > 31) {
-        return "ERROR: Invalid register index (must be 1-31)";
+
+    for (unsigned int i = 1; i < count; i++) {
+        int status = rvsim_set_reg(globalSession, i, values[i].as<sxlen_t>());
+        if (status != SIM_OK) return check(status); // The registers before it keep their new values
     }
-    
-    globalSim->set_reg(idx, value);
-    return "SUCCESS: Register x" + std::to_string(idx) + " set to " + std::to_string(value);
+    return succeed();
+}
+
+// True if [addr, addr + len) lies inside data memory
+bool memoryRangeValid(int addr, uint32_t len) {
+    return addr >= 0 && (uint64_t)addr + len <= rvsim_get_mem_size(globalSession);
 }
 
 // Get memory byte
 uint8_t getMemoryByte(int addr) {
-    if (!isInitialized || globalSim == nullptr) return 0;
-    if (addr < 0 || addr > 127) return 0;
-    return globalSim->get_mem(addr);
+    SIM_LOCK();
+    uint8_t b = 0;
+    if (globalSession != nullptr && memoryRangeValid(addr, 1)) rvsim_read_mem(globalSession, addr, &b, 1);
+    return b;
 }
 
 // Get memory word (32-bit)
 int32_t getMemoryWord(int addr) {
-    if (!isInitialized || globalSim == nullptr) return 0;
-    if (addr < 0 || addr > 124) return 0;
-    
-    return globalSim->get_mem(addr) | 
-           (globalSim->get_mem(addr+1) << 8) | 
-           (globalSim->get_mem(addr+2) << 16) | 
-           (globalSim->get_mem(addr+3) << 24);
+    SIM_LOCK();
+    if (globalSession == nullptr || !memoryRangeValid(addr, 4)) return 0;
+
+    uint8_t b[4];
+    rvsim_read_mem(globalSession, addr, b, 4);
+    return (int32_t)(b[0] | (b[1] << 8) | (b[2] << 16) | ((uint32_t)b[3] << 24));
 }
 
-// Set memory byte
-std::string setMemoryByte(int addr, uint8_t value) {
-    if (!isInitialized || globalSim == nullptr) {
-        return "ERROR: Simulator not initialized";
+// Scratch buffer for range transfers, reused across calls
+std::vector<uint8_t> rangeBuffer;
+
+/**
+ * Copy len bytes starting at addr into a new Uint8Array (one bounds check,
+ * page-wise memcpy, one copy into JS). Returns null if the range is outside memory.
+ */
+emscripten::val getMemoryRange(int addr, uint32_t len) {
+    SIM_LOCK();
+    if (globalSession == nullptr) {
+        fail(SIM_ERR_NOT_INITIALIZED, "Simulator not initialized");
+        return emscripten::val::null();
     }
-    if (addr < 0 || addr > 127) {
-        return "ERROR: Invalid memory address (must be 0-127)";
+    if (!memoryRangeValid(addr, len)) {
+        fail(SIM_ERR_INVALID_ARGUMENT, "Range [%d, %d) is outside memory (size %u)",
+             addr, addr + (int)len, rvsim_get_mem_size(globalSession));
+        return emscripten::val::null();
     }
-    
-    globalSim->set_memory(addr, value);
-    return "SUCCESS: Memory[" + std::to_string(addr) + "] set to " + std::to_string(value);
+
+    rangeBuffer.resize(len);
+    rvsim_read_mem(globalSession, addr, rangeBuffer.data(), len);
+    succeed();
+    return emscripten::val(emscripten::typed_memory_view(len, rangeBuffer.data())).call<emscripten::val>("slice");
 }
 
-// Set memory word (32-bit)
-std::string setMemoryWord(int addr, int32_t value) {
-    if (!isInitialized || globalSim == nullptr) {
-        return "ERROR: Simulator not initialized";
+// Word addresses from the last delta
+uint32_t deltaWords[RVSIM_DELTA_MAX_WORDS];
+
+/**
+ * What changed since the previous call (or init/reset): {cycles, regs, vregs,
+ * latches, pc, memOverflow, memWords}. regs/vregs are bit masks, latches
+ * uses the DELTA_* bits, memWords is a Uint32Array of word addresses.
+ * Reading the delta clears it, so one call per step gives per-cycle deltas.
+ */
+emscripten::val getStepDelta() {
+    SIM_LOCK();
+    emscripten::val out = emscripten::val::object();
+    rvsim_delta d;
+    if (rvsim_take_delta(globalSession, &d, deltaWords, RVSIM_DELTA_MAX_WORDS) != SIM_OK) return out;
+
+    out.set("cycles", (double)d.cycles);
+    out.set("regs", d.regs);
+    out.set("vregs", d.vregs);
+    out.set("latches", d.latches);
+    out.set("pc", d.pc != 0);
+    out.set("memOverflow", d.mem_overflow != 0);
+    out.set("memWords", emscripten::val(emscripten::typed_memory_view(d.mem_words, deltaWords)).call<emscripten::val>("slice"));
+    return out;
+}
+
+// Current data memory size in bytes
+uint32_t getMemorySize() {
+    SIM_LOCK();
+    return rvsim_get_mem_size(globalSession);
+}
+
+// Set memory byte
+int setMemoryByte(int addr, uint8_t value) {
+    SIM_LOCK();
+    REQUIRE_SIM();
+    if (!memoryRangeValid(addr, 1)) {
+        return fail(SIM_ERR_INVALID_ARGUMENT, "Invalid memory address %d (memory is %u bytes)", addr, rvsim_get_mem_size(globalSession));
     }
-    if (addr < 0 || addr > 124) {
-        return "ERROR: Invalid memory address (must be 0-124)";
+    return check(rvsim_write_mem(globalSession, addr, &value, 1));
+}
+
+// Set memory word (32-bit)
+int setMemoryWord(int addr, int32_t value) {
+    SIM_LOCK();
+    REQUIRE_SIM();
+    if (!memoryRangeValid(addr, 4)) {
+        return fail(SIM_ERR_INVALID_ARGUMENT, "Invalid memory address %d (memory is %u bytes)", addr, rvsim_get_mem_size(globalSession));
     }
     
-    globalSim->set_memory(addr,     value & 0xFF);
-    globalSim->set_memory(addr + 1, (value >> 8) & 0xFF);
-    globalSim->set_memory(addr + 2, (value >> 16) & 0xFF);
-    globalSim->set_memory(addr + 3, (value >> 24) & 0xFF);
-    
-    return "SUCCESS: Memory[" + std::to_string(addr) + "] (word) set to " + std::to_string(value);
+    uint8_t b[4] = {(uint8_t)value, (uint8_t)(value >> 8), (uint8_t)(value >> 16), (uint8_t)(value >> 24)};
+    return check(rvsim_write_mem(globalSession, addr, b, 4));
+}
+
+/**
+ * Write a Uint8Array (or array of bytes) starting at addr. The bytes are
+ * copied into the scratch buffer with one TypedArray.set, then written with
+ * one bounds check and a page-wise memcpy.
+ */
+int setMemoryRange(int addr, emscripten::val bytes) {
+    SIM_LOCK();
+    REQUIRE_SIM();
+    uint32_t len = bytes["length"].as<uint32_t>();
+    if (!memoryRangeValid(addr, len)) {
+        return fail(SIM_ERR_INVALID_ARGUMENT, "Range [%d, %d) is outside memory (size %u)",
+                    addr, addr + (int)len, rvsim_get_mem_size(globalSession));
+    }
+
+    rangeBuffer.resize(len);
+    emscripten::val(emscripten::typed_memory_view(len, rangeBuffer.data())).call<void>("set", bytes);
+    return check(rvsim_write_mem(globalSession, addr, rangeBuffer.data(), len));
 }
 
 // Get pipeline state
 PipelineStateJS getPipelineState() {
+    SIM_LOCK();
     PipelineStateJS state;
+    memset(&state, 0, sizeof(state));
+
+    rvsim_pipeline p;
+    if (rvsim_get_pipeline(globalSession, &p, sizeof(p)) != SIM_OK) return state;
     
-    if (!isInitialized || globalSim == nullptr) {
-        memset(&state, 0, sizeof(state));
-        return state;
-    }
-    
-    IF_ID if_id = globalSim->get_if_id();
-    ID_EX id_ex = globalSim->get_id_ex();
-    EX_MEM ex_mem = globalSim->get_ex_mem();
-    MEM_WB mem_wb = globalSim->get_mem_wb();
-    
-    state.if_id_pc = if_id.PC;
-    state.if_id_ir = if_id.IR;
-    state.if_id_npc = if_id.NPC;
+    state.if_id_pc = (uxlen_t)p.if_id_pc;
+    state.if_id_ir = p.if_id_ir;
+    state.if_id_npc = (uxlen_t)p.if_id_npc;
     
-    state.id_ex_ir = id_ex.IR;
-    state.id_ex_a = id_ex.A;
-    state.id_ex_b = id_ex.B;
-    state.id_ex_imm = id_ex.IMM;
-    state.id_ex_npc = id_ex.NPC;
+    state.id_ex_pc = (uxlen_t)p.id_ex_pc;
+    state.id_ex_ir = p.id_ex_ir;
+    state.id_ex_a = (sxlen_t)p.id_ex_a;
+    state.id_ex_b = (sxlen_t)p.id_ex_b;
+    state.id_ex_imm = (sxlen_t)p.id_ex_imm;
+    state.id_ex_npc = (uxlen_t)p.id_ex_npc;
     
-    state.ex_mem_ir = ex_mem.IR;
-    state.ex_mem_aluoutput = ex_mem.ALUOutput;
-    state.ex_mem_b = ex_mem.B;
-    state.ex_mem_cond = ex_mem.cond;
+    state.ex_mem_pc = (uxlen_t)p.ex_mem_pc;
+    state.ex_mem_ir = p.ex_mem_ir;
+    state.ex_mem_aluoutput = (sxlen_t)p.ex_mem_aluoutput;
+    state.ex_mem_b = (uxlen_t)p.ex_mem_b;
+    state.ex_mem_cond = p.ex_mem_cond != 0;
     
-    state.mem_wb_ir = mem_wb.IR;
-    state.mem_wb_aluoutput = mem_wb.ALUOutput;
-    state.mem_wb_lmd = mem_wb.LMD;
-    state.mem_wb_rd = mem_wb.rd;
-    state.mem_wb_regwrite = mem_wb.RegWrite;
+    state.mem_wb_pc = (uxlen_t)p.mem_wb_pc;
+    state.mem_wb_ir = p.mem_wb_ir;
+    state.mem_wb_aluoutput = (sxlen_t)p.mem_wb_aluoutput;
+    state.mem_wb_lmd = (sxlen_t)p.mem_wb_lmd;
+    state.mem_wb_rd = (uint8_t)p.mem_wb_rd;
+    state.mem_wb_regwrite = p.mem_wb_regwrite != 0;
     
     return state;
 }
 
-// Get assembly listing
+// Get simulator statistics
+SimStatsJS getStats() {
+    SIM_LOCK();
+    SimStatsJS js;
+    memset(&js, 0, sizeof(js));
+    rvsim_stats s;
+    if (rvsim_get_stats(globalSession, &s, sizeof(s)) != SIM_OK) return js;
+
+    js.cycles = s.cycles;
+    js.instructions = s.instructions;
+    js.stall_cycles = s.stall_cycles;
+    js.flushes = s.flushes;
+    js.itlb_hits = s.itlb_hits;
+    js.itlb_misses = s.itlb_misses;
+    js.dtlb_hits = s.dtlb_hits;
+    js.dtlb_misses = s.dtlb_misses;
+    js.page_walks = s.page_walks;
+    js.walk_cycles = s.walk_cycles;
+    js.traps = s.traps;
+    js.decode_hits = s.decode_hits;
+    js.decode_misses = s.decode_misses;
+    js.code_writes = s.code_writes;
+    js.fetch_bytes = s.fetch_bytes;
+    js.compressed_fetches = s.compressed_fetches;
+    js.vector_instructions = s.vector_instructions;
+    js.vector_elements = s.vector_elements;
+    js.vector_lane_slots = s.vector_lane_slots;
+    return js;
+}
+
+// Vector instruction mix and lane utilization
+VectorStatsJS getVectorStats() {
+    SIM_LOCK();
+    VectorStatsJS js;
+    memset(&js, 0, sizeof(js));
+    rvsim_stats s;
+    if (rvsim_get_stats(globalSession, &s, sizeof(s)) != SIM_OK) return js;
+
+    js.vle32_count = s.vop_instructions[VOP_LOAD];     js.vle32_elements = s.vop_elements[VOP_LOAD];
+    js.vse32_count = s.vop_instructions[VOP_STORE];    js.vse32_elements = s.vop_elements[VOP_STORE];
+    js.vadd_count = s.vop_instructions[VOP_ADD];       js.vadd_elements = s.vop_elements[VOP_ADD];
+    js.vmul_count = s.vop_instructions[VOP_MUL];       js.vmul_elements = s.vop_elements[VOP_MUL];
+    js.vsll_count = s.vop_instructions[VOP_SLL];       js.vsll_elements = s.vop_elements[VOP_SLL];
+    js.vredsum_count = s.vop_instructions[VOP_REDSUM]; js.vredsum_elements = s.vop_elements[VOP_REDSUM];
+    if (s.vector_lane_slots > 0) js.utilization = (double)s.vector_elements / (double)s.vector_lane_slots;
+    return js;
+}
+
+// Set VLEN in bits (power of two, 32..1024); applies to the current and future simulators
+int setVectorLength(int bits) {
+    SIM_LOCK();
+    if (bits < 32 || bits > (int)MAX_VLEN || (bits & (bits - 1)) != 0) {
+        return fail(SIM_ERR_INVALID_ARGUMENT, "VLEN must be a power of two between 32 and %u", MAX_VLEN);
+    }
+    vectorLength = bits;
+    if (globalSession != nullptr) return check(rvsim_set_vlen(globalSession, bits));
+    return succeed();
+}
+
+// SIMD backend used for vector elements and lane sweeps (AVX2, SSE2, SIMD128, scalar)
+std::string getSimdBackend() {
+    return vk_backend();
+}
+
+// Element of a vector register (SEW = 32)
+int32_t getVectorRegister(int idx, int elem) {
+    SIM_LOCK();
+    return rvsim_get_vreg(globalSession, idx, elem);
+}
+
+// Current vl (set by vsetvli)
+uint32_t getVectorLength() {
+    SIM_LOCK();
+    return rvsim_get_vl(globalSession);
+}
+
+/**
+ * Run the loaded program once per lane on the SoA functional model, lane i
+ * starting with x[reg] = base + i (reg <= 0: the data word at addr instead),
+ * then the same sweep one instance at a time for comparison. Does not touch
+ * the pipelined simulator.
+ */
+LaneSweepJS runLaneSweep(int lanes, int reg, int addr, int32_t base) {
+    SIM_LOCK();
+    LaneSweepJS js;
+    memset(&js, 0, sizeof(js));
+    if (globalProgram == nullptr || lanes <= 0 || reg >= 32) return js;
+
+    // The lane model takes the program's images by reference; the program is not changed
+    map<unsigned int, unsigned int>& text = globalProgram->text;
+    const map<unsigned int, int32_t>& data = globalProgram->data;
+    const uint64_t maxSteps = MAX_RUN_CYCLES * 100;
+    auto seed = [&](LaneSimulator& ls, unsigned int lane, int32_t value) {
+        if (reg > 0) ls.set_reg(lane, reg, value);
+        else ls.set_mem_word(lane, (uint32_t)addr, value);
+    };
+
+    auto t0 = std::chrono::steady_clock::now();
+    laneSweep.reset(new LaneSimulator(text, lanes));
+    laneSweep->load_data(data);
+    for (int l = 0; l < lanes; l++) seed(*laneSweep, l, base + l);
+    laneSweep->run(maxSteps);
+    auto t1 = std::chrono::steady_clock::now();
+
+    for (int l = 0; l < lanes; l++) {
+        LaneSimulator one(text, 1);
+        one.load_data(data);
+        seed(one, 0, base + l);
+        one.run(maxSteps);
+    }
+    auto t2 = std::chrono::steady_clock::now();
+
+    const LaneRunStats& st = laneSweep->get_stats();
+    js.lanes = lanes;
+    js.instance_instructions = st.instance_instructions;
+    js.steps = st.steps;
+    js.divergent_steps = st.divergent_steps;
+    if (st.lane_slots > 0) js.utilization = (double)st.instance_instructions / (double)st.lane_slots;
+    js.simd_ms = std::chrono::duration<double, std::milli>(t1 - t0).count();
+    js.scalar_ms = std::chrono::duration<double, std::milli>(t2 - t1).count();
+    if (js.simd_ms > 0) js.simd_ips = js.instance_instructions / (js.simd_ms / 1000.0);
+    if (js.scalar_ms > 0) js.scalar_ips = js.instance_instructions / (js.scalar_ms / 1000.0);
+    if (js.scalar_ips > 0) js.speedup = js.simd_ips / js.scalar_ips;
+    for (int l = 0; l < lanes; l++) js.faulted += laneSweep->lane_faulted(l) ? 1 : 0;
+    return js;
+}
+
+// Final register of one lane from the last runLaneSweep
+int32_t getLaneRegister(int lane, int idx) {
+    SIM_LOCK();
+    if (!laneSweep || lane < 0 || (unsigned int)lane >= laneSweep->lanes() || idx < 0 || idx >= 32) return 0;
+    return laneSweep->get_reg(lane, idx);
+}
+
+// Final data word of one lane from the last runLaneSweep
+int32_t getLaneMemoryWord(int lane, int addr) {
+    SIM_LOCK();
+    if (!laneSweep || lane < 0 || (unsigned int)lane >= laneSweep->lanes()) return 0;
+    return laneSweep->get_mem_word(lane, (uint32_t)addr);
+}
+
+// Code size of the assembled program (RVC vs. 32-bit only)
+CodeSizeStats getCodeSize() {
+    CodeSizeStats s = {0, 0, 0, 0};
+    if (globalProgram == nullptr) return s;
+    return computeCodeSize(globalProgram->instructions);
+}
+
+// Halted after a trap with no handler
+bool isHalted() {
+    SIM_LOCK();
+    return rvsim_is_halted(globalSession) != 0;
+}
+
+// Set satp (MODE bit 31 enables Sv32 translation)
+int setSatp(uint32_t value) {
+    SIM_LOCK();
+    REQUIRE_SIM();
+    return check(rvsim_set_satp(globalSession, value));
+}
+
+// Resize the I-TLB and D-TLB (entries)
+int configureTLB(int itlbEntries, int dtlbEntries) {
+    SIM_LOCK();
+    REQUIRE_SIM();
+    if (itlbEntries < 0 || dtlbEntries < 0) {
+        return fail(SIM_ERR_INVALID_ARGUMENT, "TLB sizes must be non-negative");
+    }
+    return check(rvsim_configure_tlb(globalSession, itlbEntries, dtlbEntries));
+}
+
+// Set physical memory size in bytes (page tables must fit inside it)
+int setMemorySize(uint32_t bytes) {
+    SIM_LOCK();
+    REQUIRE_SIM();
+    return check(rvsim_set_mem_size(globalSession, bytes));
+}
+
+// Set trap vector (0 = halt on trap)
+int setTrapVector(uxlen_t addr) {
+    SIM_LOCK();
+    REQUIRE_SIM();
+    return check(rvsim_set_trap_vector(globalSession, addr));
+}
+
+// Unified instruction/data memory: stores into .text modify the program
+int setUnifiedMemory(bool enable) {
+    SIM_LOCK();
+    unifiedMemory = enable;
+    if (globalSession != nullptr) return check(rvsim_set_unified_memory(globalSession, enable));
+    return succeed();
+}
+
+// Cause of the last trap (mcause)
+uint32_t getTrapCause() {
+    SIM_LOCK();
+    return rvsim_get_trap_cause(globalSession);
+}
+
+// Get assembly listing (built once per assemble or reload)
 std::string getAssemblyListing() {
-    if (!isInitialized || globalInstructions.empty()) {
-        return "";
+    return rvsim_program_listing(globalProgram);
+}
+
+// Mnemonics for the pipeline view; a stepped loop shows the same few words every cycle
+DisasmCache displayDisasm;
+
+std::string disassembleWord(uint32_t word) {
+    return displayDisasm.lookup(word);
+}
+
+// 1-based editor line of the instruction at pc (0 if pc is not an instruction start)
+uint32_t getSourceLineForPC(uxlen_t pc) {
+    return rvsim_program_line_for_pc(globalProgram, pc);
+}
+
+// Row of getAssemblyListing() for the instruction at pc, or -1
+int getListingRowForPC(uxlen_t pc) {
+    return rvsim_program_row_for_pc(globalProgram, pc);
+}
+
+// Byte addresses of the snapshot fields, so JS can read them from HEAPU8/HEAPU32
+struct SnapshotLayoutJS {
+    uint32_t base;
+    uint32_t seq;
+    uint32_t running;
+    uint32_t halted;
+    uint32_t finished;
+    uint32_t cycle;
+    uint32_t pc;
+    uint32_t regs;
+    uint32_t mem_size;
+    uint32_t mem;
+    uint32_t history_count;
+    uint32_t history;
+    uint32_t history_capacity;
+    uint32_t record_words;
+};
+
+SnapshotLayoutJS getSnapshotLayout() {
+    uint32_t base = (uint32_t)(uintptr_t)&snapshot;
+    SnapshotLayoutJS l;
+    l.base = base;
+    l.seq = base + offsetof(SimSnapshot, seq);
+    l.running = base + offsetof(SimSnapshot, running);
+    l.halted = base + offsetof(SimSnapshot, halted);
+    l.finished = base + offsetof(SimSnapshot, finished);
+    l.cycle = base + offsetof(SimSnapshot, cycle_lo);
+    l.pc = base + offsetof(SimSnapshot, pc_lo);
+    l.regs = base + offsetof(SimSnapshot, regs);
+    l.mem_size = base + offsetof(SimSnapshot, mem_size);
+    l.mem = base + offsetof(SimSnapshot, mem);
+    l.history_count = base + offsetof(SimSnapshot, history_count);
+    l.history = base + offsetof(SimSnapshot, history);
+    l.history_capacity = SNAPSHOT_HISTORY;
+    l.record_words = sizeof(PipelineRecord) / 4;
+    return l;
+}
+
+#ifdef __EMSCRIPTEN_PTHREADS__
+/**
+ * Background simulation loop. Steps until the program finishes, the
+ * cycle limit is hit or JS pauses it, publishing every PUBLISH_INTERVAL
+ * cycles and once more when it stops. The trace is paused meanwhile:
+ * nobody reads it, and formatting it every cycle would cost more than
+ * the step itself.
+ */
+void simThreadMain() {
+    PipelineRecord pending[PUBLISH_INTERVAL];
+    std::unique_lock<std::mutex> lock(simMutex);
+
+    for (;;) {
+        simWake.wait(lock, [] { return simRunRequested.load(); });
+
+        int cyclesRun = 0;
+        uint32_t count = 0;
+        bool finished = false;
+        if (globalSession != nullptr) rvsim_set_trace_enabled(globalSession, 0);
+        while (simRunRequested && globalSession != nullptr) {
+            finished = programFinished();
+            if (finished || cyclesRun >= MAX_RUN_CYCLES) break;
+
+            rvsim_step(globalSession);
+            cyclesRun++;
+            pending[count++] = capturePipeline(globalSession);
+
+            if (count == PUBLISH_INTERVAL) {
+                publishSnapshot(snapshot, globalSession, pending, count, true, false);
+                count = 0;
+                lock.unlock(); // Let waiting bindings in between batches
+                std::this_thread::yield();
+                lock.lock();
+                // Bindings may have replaced the session in between
+                if (globalSession != nullptr) rvsim_set_trace_enabled(globalSession, 0);
+            }
+        }
+
+        simRunRequested = false;
+        if (globalSession != nullptr) {
+            rvsim_set_trace_enabled(globalSession, 1); // Stepping from JS traces again
+            publishSnapshot(snapshot, globalSession, pending, count, false, finished);
+        }
     }
-    
-    std::stringstream ss;
-    for (const ParsedInstruction& inst : globalInstructions) {
-        unsigned int opcode = INSTRUCTION_MEMORY.at(inst.address);
-        ss << "0x" << std::hex << std::setw(8) << std::setfill('0') << inst.address
-           << " | 0x" << std::hex << std::setw(8) << std::setfill('0') << opcode
-           << " | " << inst.originalLine << "\n";
+}
+#endif
+
+// True when built with -pthread (background runs and shared snapshot available)
+bool isThreadedBuild() {
+#ifdef __EMSCRIPTEN_PTHREADS__
+    return true;
+#else
+    return false;
+#endif
+}
+
+// Start running in the background; progress is read from the snapshot
+int startBackgroundRun() {
+#ifdef __EMSCRIPTEN_PTHREADS__
+    SIM_LOCK();
+    REQUIRE_SIM();
+    if (!simThreadStarted) {
+        std::thread(simThreadMain).detach();
+        simThreadStarted = true;
     }
-    
-    return ss.str();
+    simRunRequested = true;
+    simWake.notify_one();
+    return succeed();
+#else
+    return fail(SIM_ERR_UNSUPPORTED, "Background runs need the -pthread build");
+#endif
+}
+
+// Ask the background run to stop after its current batch
+int pauseBackgroundRun() {
+#ifdef __EMSCRIPTEN_PTHREADS__
+    simRunRequested = false;
+    return succeed();
+#else
+    return fail(SIM_ERR_UNSUPPORTED, "Background runs need the -pthread build");
+#endif
+}
+
+// Message for the last binding that returned a non-zero status
+std::string getLastError() {
+    return lastError;
 }
 
 // Emscripten bindings
 EMSCRIPTEN_BINDINGS(riscv_simulator) {
+    emscripten::constant("SIM_OK", (int)SIM_OK);
+    emscripten::constant("SIM_ERR_NOT_INITIALIZED", (int)SIM_ERR_NOT_INITIALIZED);
+    emscripten::constant("SIM_ERR_INVALID_ARGUMENT", (int)SIM_ERR_INVALID_ARGUMENT);
+    emscripten::constant("SIM_ERR_ASSEMBLY", (int)SIM_ERR_ASSEMBLY);
+    emscripten::constant("SIM_ERR_EXCEPTION", (int)SIM_ERR_EXCEPTION);
+    emscripten::constant("SIM_ERR_UNSUPPORTED", (int)SIM_ERR_UNSUPPORTED);
+    emscripten::constant("SIM_ERR_LIMIT", (int)SIM_ERR_LIMIT);
+    emscripten::function("getLastError", &getLastError);
+    emscripten::function("getInstructionCount", &getInstructionCount);
     emscripten::function("initializeSimulator", &initializeSimulator);
     emscripten::function("stepSimulator", &stepSimulator);
     emscripten::function("runSimulator", &runSimulator);
     emscripten::function("resetSimulator", &resetSimulator);
+    emscripten::function("reloadProgram", &reloadProgram);
+    emscripten::function("getLastReloadStats", &getLastReloadStats);
+    emscripten::function("assembleEdit", &assembleEdit);
+    emscripten::function("getEditorAssembly", &getEditorAssembly);
+    emscripten::function("reloadFromEditor", &reloadFromEditor);
     emscripten::function("getPC", &getPC);
     emscripten::function("getRegister", &getRegister);
     emscripten::function("setRegister", &setRegister);
+    emscripten::function("setRegisters", &setRegisters);
     emscripten::function("getMemoryByte", &getMemoryByte);
     emscripten::function("getMemoryWord", &getMemoryWord);
     emscripten::function("setMemoryByte", &setMemoryByte);
     emscripten::function("setMemoryWord", &setMemoryWord);
+    emscripten::function("setMemoryRange", &setMemoryRange);
+    emscripten::function("getMemoryRange", &getMemoryRange);
+    emscripten::function("getMemorySize", &getMemorySize);
+    emscripten::function("getStepDelta", &getStepDelta);
+    emscripten::constant("DELTA_IF_ID", DELTA_IF_ID);
+    emscripten::constant("DELTA_ID_EX", DELTA_ID_EX);
+    emscripten::constant("DELTA_EX_MEM", DELTA_EX_MEM);
+    emscripten::constant("DELTA_MEM_WB", DELTA_MEM_WB);
     emscripten::function("getPipelineState", &getPipelineState);
     emscripten::function("getAssemblyListing", &getAssemblyListing);
+    emscripten::function("getSourceLineForPC", &getSourceLineForPC);
+    emscripten::function("disassembleWord", &disassembleWord);
+    emscripten::function("getListingRowForPC", &getListingRowForPC);
+    emscripten::function("getStats", &getStats);
+    emscripten::function("getCodeSize", &getCodeSize);
+    emscripten::function("isHalted", &isHalted);
+    emscripten::function("setSatp", &setSatp);
+    emscripten::function("configureTLB", &configureTLB);
+    emscripten::function("setMemorySize", &setMemorySize);
+    emscripten::function("setTrapVector", &setTrapVector);
+    emscripten::function("getTrapCause", &getTrapCause);
+    emscripten::function("setUnifiedMemory", &setUnifiedMemory);
+    emscripten::function("getVectorStats", &getVectorStats);
+    emscripten::function("setVectorLength", &setVectorLength);
+    emscripten::function("getVectorRegister", &getVectorRegister);
+    emscripten::function("getVectorLength", &getVectorLength);
+    emscripten::function("getSimdBackend", &getSimdBackend);
+    emscripten::function("runLaneSweep", &runLaneSweep);
+    emscripten::function("getLaneRegister", &getLaneRegister);
+    emscripten::function("getLaneMemoryWord", &getLaneMemoryWord);
+    emscripten::function("getSnapshotLayout", &getSnapshotLayout);
+    emscripten::function("isThreadedBuild", &isThreadedBuild);
+    emscripten::function("startBackgroundRun", &startBackgroundRun);
+    emscripten::function("pauseBackgroundRun", &pauseBackgroundRun);
     
     value_object<PipelineStateJS>("PipelineStateJS")
         .field("if_id_pc", &PipelineStateJS::if_id_pc)
         .field("if_id_ir", &PipelineStateJS::if_id_ir)
         .field("if_id_npc", &PipelineStateJS::if_id_npc)
+        .field("id_ex_pc", &PipelineStateJS::id_ex_pc)
         .field("id_ex_ir", &PipelineStateJS::id_ex_ir)
         .field("id_ex_a", &PipelineStateJS::id_ex_a)
         .field("id_ex_b", &PipelineStateJS::id_ex_b)
         .field("id_ex_imm", &PipelineStateJS::id_ex_imm)
         .field("id_ex_npc", &PipelineStateJS::id_ex_npc)
+        .field("ex_mem_pc", &PipelineStateJS::ex_mem_pc)
         .field("ex_mem_ir", &PipelineStateJS::ex_mem_ir)
         .field("ex_mem_aluoutput", &PipelineStateJS::ex_mem_aluoutput)
         .field("ex_mem_b", &PipelineStateJS::ex_mem_b)
         .field("ex_mem_cond", &PipelineStateJS::ex_mem_cond)
+        .field("mem_wb_pc", &PipelineStateJS::mem_wb_pc)
         .field("mem_wb_ir", &PipelineStateJS::mem_wb_ir)
         .field("mem_wb_aluoutput", &PipelineStateJS::mem_wb_aluoutput)
         .field("mem_wb_lmd", &PipelineStateJS::mem_wb_lmd)
         .field("mem_wb_rd", &PipelineStateJS::mem_wb_rd)
         .field("mem_wb_regwrite", &PipelineStateJS::mem_wb_regwrite);
+
+    value_object<SimStatsJS>("SimStatsJS")
+        .field("cycles", &SimStatsJS::cycles)
+        .field("instructions", &SimStatsJS::instructions)
+        .field("stall_cycles", &SimStatsJS::stall_cycles)
+        .field("flushes", &SimStatsJS::flushes)
+        .field("itlb_hits", &SimStatsJS::itlb_hits)
+        .field("itlb_misses", &SimStatsJS::itlb_misses)
+        .field("dtlb_hits", &SimStatsJS::dtlb_hits)
+        .field("dtlb_misses", &SimStatsJS::dtlb_misses)
+        .field("page_walks", &SimStatsJS::page_walks)
+        .field("walk_cycles", &SimStatsJS::walk_cycles)
+        .field("traps", &SimStatsJS::traps)
+        .field("decode_hits", &SimStatsJS::decode_hits)
+        .field("decode_misses", &SimStatsJS::decode_misses)
+        .field("code_writes", &SimStatsJS::code_writes)
+        .field("fetch_bytes", &SimStatsJS::fetch_bytes)
+        .field("compressed_fetches", &SimStatsJS::compressed_fetches)
+        .field("vector_instructions", &SimStatsJS::vector_instructions)
+        .field("vector_elements", &SimStatsJS::vector_elements)
+        .field("vector_lane_slots", &SimStatsJS::vector_lane_slots);
+
+    value_object<VectorStatsJS>("VectorStatsJS")
+        .field("vle32_count", &VectorStatsJS::vle32_count)
+        .field("vle32_elements", &VectorStatsJS::vle32_elements)
+        .field("vse32_count", &VectorStatsJS::vse32_count)
+        .field("vse32_elements", &VectorStatsJS::vse32_elements)
+        .field("vadd_count", &VectorStatsJS::vadd_count)
+        .field("vadd_elements", &VectorStatsJS::vadd_elements)
+        .field("vmul_count", &VectorStatsJS::vmul_count)
+        .field("vmul_elements", &VectorStatsJS::vmul_elements)
+        .field("vsll_count", &VectorStatsJS::vsll_count)
+        .field("vsll_elements", &VectorStatsJS::vsll_elements)
+        .field("vredsum_count", &VectorStatsJS::vredsum_count)
+        .field("vredsum_elements", &VectorStatsJS::vredsum_elements)
+        .field("utilization", &VectorStatsJS::utilization);
+
+    value_object<SnapshotLayoutJS>("SnapshotLayoutJS")
+        .field("base", &SnapshotLayoutJS::base)
+        .field("seq", &SnapshotLayoutJS::seq)
+        .field("running", &SnapshotLayoutJS::running)
+        .field("halted", &SnapshotLayoutJS::halted)
+        .field("finished", &SnapshotLayoutJS::finished)
+        .field("cycle", &SnapshotLayoutJS::cycle)
+        .field("pc", &SnapshotLayoutJS::pc)
+        .field("regs", &SnapshotLayoutJS::regs)
+        .field("mem_size", &SnapshotLayoutJS::mem_size)
+        .field("mem", &SnapshotLayoutJS::mem)
+        .field("history_count", &SnapshotLayoutJS::history_count)
+        .field("history", &SnapshotLayoutJS::history)
+        .field("history_capacity", &SnapshotLayoutJS::history_capacity)
+        .field("record_words", &SnapshotLayoutJS::record_words);
+
+    value_object<ReloadStatsJS>("ReloadStatsJS")
+        .field("text_changed", &ReloadStatsJS::text_changed)
+        .field("data_changed", &ReloadStatsJS::data_changed)
+        .field("symbols_changed", &ReloadStatsJS::symbols_changed)
+        .field("kept_state", &ReloadStatsJS::kept_state);
+
+    value_object<EditorAsmJS>("EditorAsmJS")
+        .field("lines", &EditorAsmJS::lines)
+        .field("instructions", &EditorAsmJS::instructions)
+        .field("data_words", &EditorAsmJS::data_words)
+        .field("labels", &EditorAsmJS::labels)
+        .field("last_parsed", &EditorAsmJS::last_parsed)
+        .field("last_encoded", &EditorAsmJS::last_encoded)
+        .field("error_line", &EditorAsmJS::error_line);
+
+    value_object<LaneSweepJS>("LaneSweepJS")
+        .field("lanes", &LaneSweepJS::lanes)
+        .field("instance_instructions", &LaneSweepJS::instance_instructions)
+        .field("steps", &LaneSweepJS::steps)
+        .field("divergent_steps", &LaneSweepJS::divergent_steps)
+        .field("utilization", &LaneSweepJS::utilization)
+        .field("simd_ms", &LaneSweepJS::simd_ms)
+        .field("scalar_ms", &LaneSweepJS::scalar_ms)
+        .field("simd_ips", &LaneSweepJS::simd_ips)
+        .field("scalar_ips", &LaneSweepJS::scalar_ips)
+        .field("speedup", &LaneSweepJS::speedup)
+        .field("faulted", &LaneSweepJS::faulted);
+
+    value_object<CodeSizeStats>("CodeSizeStats")
+        .field("instructions", &CodeSizeStats::instructions)
+        .field("compressed", &CodeSizeStats::compressed)
+        .field("bytes", &CodeSizeStats::bytes)
+        .field("uncompressed_bytes", &CodeSizeStats::uncompressed_bytes);
 }
\ No newline at end of file
@@ -0,0 +1,202 @@
+#include "../hpp_files/memory.hpp"
+#include <cstring>
+
+PagedMemory::PagedMemory(uint64_t limit)
+    : mem_limit(limit), arena(nullptr), out_of_pages(false), last_page_num(0), last_page(nullptr) {}
+
+PagedMemory::~PagedMemory() {
+    clear();
+}
+
+uint8_t* PagedMemory::new_page() {
+    if (arena != nullptr) return arena->acquire();
+    uint8_t* page = new uint8_t[PAGE_SIZE];
+    std::memset(page, 0, PAGE_SIZE);
+    return page;
+}
+
+void PagedMemory::free_page(uint8_t* page) {
+    if (arena != nullptr) arena->release(page);
+    else delete[] page;
+}
+
+const uint8_t* PagedMemory::page_for_read(uint32_t addr) const {
+    uint32_t page_num = addr >> PAGE_SHIFT;
+    if (last_page != nullptr && last_page_num == page_num) return last_page;
+
+    auto it = pages.find(page_num);
+    if (it == pages.end()) return nullptr;
+
+    last_page_num = page_num;
+    last_page = it->second;
+    return last_page;
+}
+
+uint8_t* PagedMemory::page_for_write(uint32_t addr) {
+    uint32_t page_num = addr >> PAGE_SHIFT;
+    if (last_page != nullptr && last_page_num == page_num) return last_page;
+
+    auto it = pages.find(page_num);
+    if (it == pages.end()) {
+        uint8_t* page = new_page();
+        if (page == nullptr) {
+            out_of_pages = true;
+            return nullptr;
+        }
+        it = pages.emplace(page_num, page).first;
+    }
+
+    last_page_num = page_num;
+    last_page = it->second;
+    return last_page;
+}
+
+uint8_t PagedMemory::read8(uint32_t addr) const {
+    const uint8_t* page = page_for_read(addr);
+    return page ? page[addr & PAGE_MASK] : 0;
+}
+
+void PagedMemory::write8(uint32_t addr, uint8_t val) {
+    uint8_t* page = page_for_write(addr);
+    if (page) page[addr & PAGE_MASK] = val;
+}
+
+uint32_t PagedMemory::read32(uint32_t addr) const {
+    if ((addr & PAGE_MASK) <= PAGE_SIZE - 4) {
+        const uint8_t* page = page_for_read(addr);
+        if (page == nullptr) return 0;
+        const uint8_t* p = page + (addr & PAGE_MASK);
+        return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+    }
+
+    // Word straddles a page boundary
+    return read8(addr) | (read8(addr + 1) << 8) | (read8(addr + 2) << 16) | ((uint32_t)read8(addr + 3) << 24);
+}
+
+void PagedMemory::write32(uint32_t addr, uint32_t val) {
+    if ((addr & PAGE_MASK) <= PAGE_SIZE - 4) {
+        uint8_t* page = page_for_write(addr);
+        if (page == nullptr) return;
+        uint8_t* p = page + (addr & PAGE_MASK);
+        p[0] = val & 0xFF;
+        p[1] = (val >> 8) & 0xFF;
+        p[2] = (val >> 16) & 0xFF;
+        p[3] = (val >> 24) & 0xFF;
+        return;
+    }
+
+    write8(addr,     val & 0xFF);
+    write8(addr + 1, (val >> 8) & 0xFF);
+    write8(addr + 2, (val >> 16) & 0xFF);
+    write8(addr + 3, (val >> 24) & 0xFF);
+}
+
+void PagedMemory::read_block(uint32_t addr, uint8_t* dst, uint32_t len) const {
+    while (len > 0) {
+        uint32_t offset = addr & PAGE_MASK;
+        uint32_t chunk = PAGE_SIZE - offset;
+        if (chunk > len) chunk = len;
+
+        const uint8_t* page = page_for_read(addr);
+        if (page) std::memcpy(dst, page + offset, chunk);
+        else      std::memset(dst, 0, chunk);
+
+        addr += chunk;
+        dst += chunk;
+        len -= chunk;
+    }
+}
+
+bool PagedMemory::write_block(uint32_t addr, const uint8_t* src, uint32_t len) {
+    bool ok = true;
+    while (len > 0) {
+        uint32_t offset = addr & PAGE_MASK;
+        uint32_t chunk = PAGE_SIZE - offset;
+        if (chunk > len) chunk = len;
+
+        uint8_t* page = page_for_write(addr);
+        if (page) std::memcpy(page + offset, src, chunk);
+        else ok = false;
+
+        addr += chunk;
+        src += chunk;
+        len -= chunk;
+    }
+    return ok;
+}
+
+/**
+ * Pages present in both are memcpy'd, pages only in image are allocated
+ * once. Pages only here are zeroed and kept for the next run, or with an
+ * arena go back to it, since the next run may need its pages elsewhere.
+ */
+void PagedMemory::restore_from(const PagedMemory& image) {
+    out_of_pages = false;
+    for (auto it = pages.begin(); it != pages.end();) {
+        auto src = image.pages.find(it->first);
+        if (src != image.pages.end()) {
+            std::memcpy(it->second, src->second, PAGE_SIZE);
+        } else if (arena != nullptr) {
+            arena->release(it->second);
+            it = pages.erase(it);
+            last_page = nullptr;
+            continue;
+        } else {
+            std::memset(it->second, 0, PAGE_SIZE);
+        }
+        ++it;
+    }
+    for (auto const& [num, page] : image.pages) {
+        if (pages.count(num)) continue;
+        uint8_t* copy = page_for_write(num << PAGE_SHIFT);
+        if (copy) std::memcpy(copy, page, PAGE_SIZE);
+    }
+    mem_limit = image.mem_limit;
+}
+
+void PagedMemory::clear() {
+    for (auto& [num, page] : pages) free_page(page);
+    pages.clear();
+    last_page = nullptr;
+    out_of_pages = false;
+}
+
+void PagedMemory::set_arena(PageArena* to) {
+    std::unordered_map<uint32_t, uint8_t*> moved;
+    for (auto& [num, page] : pages) {
+        uint8_t* copy = to ? to->acquire() : new uint8_t[PAGE_SIZE];
+        if (copy) {
+            std::memcpy(copy, page, PAGE_SIZE);
+            moved.emplace(num, copy);
+        } else {
+            out_of_pages = true;
+        }
+        free_page(page);
+    }
+    pages.swap(moved);
+    arena = to;
+    last_page = nullptr;
+    // Pages for the whole arena up front, so inserts never rehash
+    if (arena) pages.reserve(arena->capacity());
+}
+
+// --- PageArena ---
+
+PageArena::PageArena(uint32_t pages)
+    : block(new uint8_t[(size_t)pages * PagedMemory::PAGE_SIZE]), total(pages)
+{
+    free_pages.reserve(pages);
+    for (uint32_t i = pages; i > 0; i--) free_pages.push_back(block.get() + (size_t)(i - 1) * PagedMemory::PAGE_SIZE);
+}
+
+uint8_t* PageArena::acquire() {
+    if (free_pages.empty()) return nullptr;
+    uint8_t* page = free_pages.back();
+    free_pages.pop_back();
+    std::memset(page, 0, PagedMemory::PAGE_SIZE);
+    return page;
+}
+
+void PageArena::release(uint8_t* page) {
+    free_pages.push_back(page);
+}
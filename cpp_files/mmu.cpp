@@ -0,0 +1,156 @@
+#include "../hpp_files/mmu.hpp"
+
+static uint32_t page_fault_cause(AccessType type) {
+    if (type == AccessType::Fetch) return CAUSE_FETCH_PAGE_FAULT;
+    if (type == AccessType::Load)  return CAUSE_LOAD_PAGE_FAULT;
+    return CAUSE_STORE_PAGE_FAULT;
+}
+
+static uint32_t access_fault_cause(AccessType type) {
+    if (type == AccessType::Fetch) return CAUSE_FETCH_ACCESS;
+    if (type == AccessType::Load)  return CAUSE_LOAD_ACCESS;
+    return CAUSE_STORE_ACCESS;
+}
+
+static bool permits(uint32_t perms, AccessType type) {
+    if (type == AccessType::Fetch) return perms & PTE_X;
+    if (type == AccessType::Load)  return perms & PTE_R;
+    return (perms & PTE_W) && (perms & PTE_D);
+}
+
+// =================================================================
+// TLB
+// =================================================================
+TLB::TLB(size_t n) : hits(0), misses(0), stamp(0) {
+    resize(n);
+}
+
+void TLB::resize(size_t n) {
+    entries.assign(n, TLBEntry{false, false, 0, 0, 0, 0});
+}
+
+void TLB::flush() {
+    for (TLBEntry& e : entries) e.valid = false;
+}
+
+const TLBEntry* TLB::lookup(uint32_t vaddr) {
+    uint32_t vpn = vaddr >> 12;
+    for (TLBEntry& e : entries) {
+        if (!e.valid) continue;
+        bool match = e.megapage ? ((e.vpn >> 10) == (vpn >> 10)) : (e.vpn == vpn);
+        if (match) {
+            e.last_use = ++stamp;
+            hits++;
+            return &e;
+        }
+    }
+    misses++;
+    return nullptr;
+}
+
+void TLB::insert(uint32_t vaddr, uint32_t ppn, uint32_t perms, bool megapage) {
+    if (entries.empty()) return;
+
+    // Refresh an existing mapping (e.g. after the D bit was set), else pick
+    // an invalid slot, else the least recently used one
+    TLBEntry* victim = &entries[0];
+    for (TLBEntry& e : entries) {
+        if (e.valid && e.vpn == (vaddr >> 12)) { victim = &e; break; }
+        if (!victim->valid) continue;
+        if (!e.valid || e.last_use < victim->last_use) victim = &e;
+    }
+
+    victim->valid = true;
+    victim->megapage = megapage;
+    victim->vpn = vaddr >> 12;
+    victim->ppn = ppn;
+    victim->perms = perms;
+    victim->last_use = ++stamp;
+}
+
+// =================================================================
+// Sv32 MMU
+// =================================================================
+Sv32MMU::Sv32MMU(PagedMemory& mem) : walks(0), memory(mem), satp(0) {}
+
+void Sv32MMU::set_satp(uint32_t value) {
+    satp = value;
+    itlb.flush();
+    dtlb.flush();
+}
+
+/**
+ * Two-level Sv32 walk. VA: [31:22 VPN[1]] [21:12 VPN[0]] [11:0 offset]
+ */
+uint32_t Sv32MMU::walk(uint32_t vaddr, AccessType type, uint32_t& ppn, uint32_t& perms,
+                       bool& megapage, unsigned int& walk_cycles) {
+    walks++;
+    uint64_t table = (uint64_t)(satp & SATP_PPN_MASK) << 12;
+
+    for (int level = 1; level >= 0; level--) {
+        uint32_t vpn_i = (vaddr >> (12 + 10 * level)) & 0x3FF;
+        uint64_t pte_addr = table + vpn_i * 4;
+
+        walk_cycles += PTE_ACCESS_CYCLES;
+        if (pte_addr > 0xFFFFFFFFull || !memory.in_bounds((uint32_t)pte_addr, 4)) {
+            return access_fault_cause(type);
+        }
+
+        uint32_t pte = memory.read32((uint32_t)pte_addr);
+        if (!(pte & PTE_V) || (!(pte & PTE_R) && (pte & PTE_W))) {
+            return page_fault_cause(type);
+        }
+
+        uint32_t pte_ppn = pte >> 10;
+        if (pte & (PTE_R | PTE_X)) {
+            // Leaf PTE; a megapage must be aligned (PPN[0] == 0)
+            if (level == 1 && (pte_ppn & 0x3FF) != 0) return page_fault_cause(type);
+
+            // Hardware-managed A/D bits
+            uint32_t updated = pte | PTE_A | (type == AccessType::Store ? PTE_D : 0);
+            if (updated != pte) memory.write32((uint32_t)pte_addr, updated);
+
+            ppn = pte_ppn;
+            perms = updated & (PTE_R | PTE_W | PTE_X | PTE_D);
+            megapage = (level == 1);
+            return 0;
+        }
+
+        table = (uint64_t)pte_ppn << 12;
+    }
+
+    return page_fault_cause(type);
+}
+
+uint32_t Sv32MMU::translate(uint32_t vaddr, AccessType type, uint32_t& paddr, unsigned int& walk_cycles) {
+    walk_cycles = 0;
+    if (!enabled()) {
+        paddr = vaddr;
+        return 0;
+    }
+
+    TLB& tlb = (type == AccessType::Fetch) ? itlb : dtlb;
+    const TLBEntry* entry = tlb.lookup(vaddr);
+
+    uint32_t ppn, perms;
+    bool megapage;
+    if (entry != nullptr && permits(entry->perms, type)) {
+        ppn = entry->ppn;
+        perms = entry->perms;
+        megapage = entry->megapage;
+    } else {
+        // Miss, or a hit that needs the D bit set first: walk the tables
+        uint32_t cause = walk(vaddr, type, ppn, perms, megapage, walk_cycles);
+        if (cause != 0) return cause;
+        if (!permits(perms, type)) return page_fault_cause(type);
+        tlb.insert(vaddr, ppn, perms, megapage);
+    }
+
+    uint64_t pa = megapage
+        ? ((uint64_t)(ppn >> 10) << 22) | (vaddr & 0x3FFFFF)
+        : ((uint64_t)ppn << 12) | (vaddr & 0xFFF);
+    if (pa > 0xFFFFFFFFull) return access_fault_cause(type);
+
+    paddr = (uint32_t)pa;
+    return 0;
+}
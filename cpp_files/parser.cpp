@@ -1,15 +1,26 @@
 #include "../hpp_files/assembler.hpp"
 #include "../hpp_files/utils.hpp"
+#include "../hpp_files/compressed.hpp"
+#include "../hpp_files/asm_arena.hpp"
+#include <cstring>
+#include <stdexcept>
 
 vector<string> readAndPreprocess(const string& filename);
 map<string, unsigned int> buildSymbolTable(const vector<string>& lines);
-vector<ParsedInstruction> parseInstructions(const vector<string>& lines);
+map<string, unsigned int> buildSymbolTable(const vector<string>& lines, const vector<unsigned int>& sizes);
+vector<ParsedInstruction> parseInstructions(const vector<string>& lines, AsmArena& arena);
+bool parseInstructionLine(const string& line, size_t start, AsmArena& arena, ParsedInstruction& pInst, string& error);
+void copyToArena(vector<ParsedInstruction>& instructions, AsmArena& arena);
 bool validateInstructions(const vector<ParsedInstruction>& instructions);
 void parseDataSection(const vector<string>& lines);
+void relaxCompressed(vector<ParsedInstruction>& instructions, const vector<string>& lines);
 
 // Definition of the global data map (declared extern in assembler.hpp)
 map<unsigned int, int32_t> DATA_SEGMENT;
 
+// Text of the instructions parsed by default (declared extern in parser.hpp)
+AsmArena PARSE_ARENA;
+
 /**
  * Reads the file, ignores comments, and collects non-empty lines.
  * UPDATED: Now keeps lines starting with '.' (directives like .data, .text)
@@ -47,7 +58,16 @@ vector<string> readAndPreprocess(const string& filename) {
  * UPDATED: Handles separate counters for .text (0x80) and .data (0x00)
  */
 map<string, unsigned int> buildSymbolTable(const vector<string>& lines) {
+    return buildSymbolTable(lines, vector<unsigned int>());
+}
+
+/**
+ * Pass 1 with known instruction sizes: the i-th instruction in .text takes
+ * sizes[i] bytes (4 if sizes is shorter). Used when RVC encodings are emitted.
+ */
+map<string, unsigned int> buildSymbolTable(const vector<string>& lines, const vector<unsigned int>& sizes) {
     map<string, unsigned int> symbolTable;
+    size_t instIndex = 0;
     unsigned int textAddress = INSTRUCTION_MEMORY_START; // 0x80
     unsigned int dataAddress = DATA_MEMORY_START;        // 0x00
     bool inDataSegment = false; // Default to text
@@ -67,10 +87,7 @@ map<string, unsigned int> buildSymbolTable(const vector<string>& lines) {
             string label = tempLine.substr(0, labelPos);
             label.erase(remove_if(label.begin(), label.end(), ::isspace), label.end());
             
-            if (symbolTable.count(label)) {
-                cerr << "ERROR: Duplicate label definition: " << label << endl;
-                exit(1);
-            }
+            if (symbolTable.count(label)) throw std::runtime_error("Duplicate label definition: " + label);
             
             // Assign address based on current section
             if (inDataSegment) {
@@ -95,9 +112,10 @@ map<string, unsigned int> buildSymbolTable(const vector<string>& lines) {
             if (firstWord == ".word") {
                 dataAddress += 4;
             }
-        } else {
-            // Instructions in .text segment take 4 bytes
-            textAddress += 4;
+        } else if (tempLine[0] != '.') {
+            // Instructions in .text segment take 4 bytes (2 if compressed)
+            textAddress += (instIndex < sizes.size()) ? sizes[instIndex] : 4;
+            instIndex++;
         }
     }
     return symbolTable;
@@ -146,95 +164,239 @@ void parseDataSection(const vector<string>& lines) {
 
 // Assembler Phase 2: Parsing, Validation & Encoding Setup
 
+// Whitespace test on a raw char (::isspace needs a non-negative value)
+static bool isSpace(char c) { return isspace((unsigned char)c) != 0; }
+
+/**
+ * Splits record[begin, end) at commas like split(): whitespace is removed and
+ * empty fields are dropped. A field without inner whitespace is a span of the
+ * line itself; otherwise its characters are appended to the record at
+ * recordLength. Returns the field count (only the first max are stored).
+ */
+static size_t splitOperands(char* record, size_t begin, size_t end, size_t& recordLength,
+                            TextSpan* out, size_t max) {
+    size_t count = 0;
+    size_t i = begin;
+    while (i < end) {
+        size_t fieldEnd = i;
+        while (fieldEnd < end && record[fieldEnd] != ',') fieldEnd++;
+
+        size_t first = i, last = fieldEnd;
+        while (first < last && isSpace(record[first])) first++;
+        while (last > first && isSpace(record[last - 1])) last--;
+        if (first < last) {
+            TextSpan span = {(uint16_t)first, (uint16_t)(last - first)};
+            if (std::any_of(record + first, record + last, isSpace)) {
+                span.offset = (uint16_t)recordLength;
+                for (size_t k = first; k < last; k++) {
+                    if (!isSpace(record[k])) record[recordLength++] = record[k];
+                }
+                span.length = (uint16_t)(recordLength - span.offset);
+            }
+            if (count < max) out[count] = span;
+            count++;
+        }
+        i = fieldEnd + 1;
+    }
+    return count;
+}
+
+/**
+ * Parses the instruction in line[start..] (label already removed; line has no
+ * comment) into pInst, copying line into arena as its text record.
+ * Leaves pInst.mnemonic() empty for a blank line; address and rvc are set by the caller.
+ * Returns false with a message in error for malformed operands.
+ */
+bool parseInstructionLine(const string& line, size_t start, AsmArena& arena, ParsedInstruction& pInst, string& error) {
+    pInst = ParsedInstruction();
+    pInst.mnemonic_id = NO_MNEMONIC;
+    pInst.size = 4;
+
+    // Split into mnemonic and the rest of the operands
+    const size_t n = line.size();
+    size_t mnemonicStart = start;
+    while (mnemonicStart < n && isSpace(line[mnemonicStart])) mnemonicStart++;
+    size_t mnemonicEnd = mnemonicStart;
+    while (mnemonicEnd < n && !isSpace(line[mnemonicEnd])) mnemonicEnd++;
+
+    if (mnemonicEnd == mnemonicStart) return true;
+    if (n > MAX_LINE_LENGTH) {
+        error = "Line is longer than " + to_string(MAX_LINE_LENGTH) + " characters";
+        return false;
+    }
+
+    // Record: the line, then room for operands that need their whitespace removed
+    char* record = arena.alloc(2 * n);
+    memcpy(record, line.data(), n);
+    size_t recordLength = n;
+
+    pInst.text = record;
+    pInst.text_length = (uint16_t)n;
+    pInst.mnemonic_span = {(uint16_t)mnemonicStart, (uint16_t)(mnemonicEnd - mnemonicStart)};
+    const string_view mnemonic = pInst.mnemonic();
+    pInst.mnemonic_id = mnemonicId(mnemonic);
+
+    TextSpan parts[MAX_OPERANDS + 1];
+    size_t count = splitOperands(record, mnemonicEnd, n, recordLength, parts, MAX_OPERANDS + 1);
+    auto part = [&](size_t i) { return string_view(record + parts[i].offset, parts[i].length); };
+    auto finish = [&](bool ok) {
+        arena.shrink_last(record, recordLength);
+        pInst.record_length = (uint16_t)recordLength;
+        return ok;
+    };
+
+    // Handle the special format for loads/stores: lw rd, imm(rs1)
+    if (mnemonic == "lw" || mnemonic == "sw" || mnemonic == "ld" || mnemonic == "sd") {
+        // Split the rest by comma: "rd/rs2, imm(rs1)"
+        if (count != 2) {
+            error = "Incorrect operand count for " + string(mnemonic);
+            return finish(false);
+        }
+
+        // Find the opening '(' and closing ')' in imm(rs1)
+        string_view immAndBase = part(1);
+        size_t openParen = immAndBase.find('(');
+        size_t closeParen = immAndBase.find(')');
+
+        if (openParen == string::npos || closeParen == string::npos || closeParen < openParen) {
+            error = "Invalid address format for " + string(mnemonic) + ". Expected: imm(rs1)";
+            return finish(false);
+        }
+
+        // Operands: rd (rs2 for sw), rs1, imm
+        uint16_t base = parts[1].offset;
+        pInst.operand_spans[0] = parts[0];
+        pInst.operand_spans[1] = {(uint16_t)(base + openParen + 1), (uint16_t)(closeParen - openParen - 1)};
+        pInst.operand_spans[2] = {base, (uint16_t)openParen};
+        pInst.operand_count = 3;
+
+    } else if (mnemonic == "vle32.v" || mnemonic == "vse32.v") {
+        // Unit-stride vector access: "vd, (rs1)"; a zero offset "0(rs1)" is also accepted
+        string_view address = (count == 2) ? part(1) : string_view();
+        size_t openParen = address.find('(');
+        size_t closeParen = address.find(')');
+        if (openParen == string::npos || closeParen == string::npos || closeParen < openParen ||
+            getImmediateValue(openParen == 0 ? "0" : address.substr(0, openParen)) != 0) {
+            error = "Invalid address format for " + string(mnemonic) + ". Expected: vd, (rs1)";
+            return finish(false);
+        }
+
+        pInst.operand_spans[0] = parts[0];
+        pInst.operand_spans[1] = {(uint16_t)(parts[1].offset + openParen + 1), (uint16_t)(closeParen - openParen - 1)};
+        pInst.operand_count = 2;
+
+    } else {
+        if (count > MAX_OPERANDS) {
+            error = "Too many operands for " + string(mnemonic);
+            return finish(false);
+        }
+        for (size_t i = 0; i < count; i++) pInst.operand_spans[i] = parts[i];
+        pInst.operand_count = (uint8_t)count;
+    }
+    return finish(true);
+}
+
 /**
  * Pass 2: Parses instructions and prepares them for encoding.
  * UPDATED: Now skips over .data sections and directives.
+ * Instruction text is kept in arena, which must outlive the result.
  */
-vector<ParsedInstruction> parseInstructions(const vector<string>& lines) {
+vector<ParsedInstruction> parseInstructions(const vector<string>& lines, AsmArena& arena) {
     vector<ParsedInstruction> instructions;
+    instructions.reserve(lines.size());
     unsigned int currentAddress = INSTRUCTION_MEMORY_START;
     bool inTextSegment = true; // Assume start in text unless .data seen first
+    bool rvcEnabled = false;   // ".option rvc" / ".option norvc"
 
-    // Initial scan to set correct start state if file starts with .data
-    bool hasDirectives = false;
-    for(const auto& l : lines) if(l == ".text" || l == ".data") hasDirectives = true;
-    if(!hasDirectives) inTextSegment = true;
-
-    for (const string& line : lines) {
-        string currentLine = line;
+    for (size_t lineIndex = 0; lineIndex < lines.size(); lineIndex++) {
+        const string& line = lines[lineIndex];
         
         // Handle Section switching
-        if (currentLine == ".data") { inTextSegment = false; continue; }
-        if (currentLine == ".text") { inTextSegment = true; continue; }
-        if (currentLine.find(".global") != string::npos) continue;
+        if (line == ".data") { inTextSegment = false; continue; }
+        if (line == ".text") { inTextSegment = true; continue; }
+        if (line.find(".global") != string::npos) continue;
 
         // If we are in the data segment, DO NOT parse as instructions
         if (!inTextSegment) continue;
 
-        size_t labelPos = currentLine.find(':');
+        // Instruction text starts after the label, if any
+        size_t start = 0;
+        size_t labelPos = line.find(':');
         if (labelPos != string::npos) {
-            currentLine = currentLine.substr(labelPos + 1);
-            currentLine.erase(0, currentLine.find_first_not_of(" \t\r\n"));
-            if (currentLine.empty()) {
-                continue; 
-            }
+            start = line.find_first_not_of(" \t\r\n", labelPos + 1);
+            if (start == string::npos) continue;
         }
 
         // Check for directives inside .text (like .word shouldn't be here usually, but safety check)
-        if (currentLine[0] == '.') continue;
-
-        // Split into mnemonic and the rest of the operands
-        stringstream ss(currentLine);
-        string mnemonic;
-        ss >> mnemonic;
-
-        if (mnemonic.empty()) continue;
-
-        string restOfLine;
-        getline(ss, restOfLine);
+        if (line[start] == '.') {
+            if (line.compare(start, string::npos, ".option rvc") == 0) rvcEnabled = true;
+            if (line.compare(start, string::npos, ".option norvc") == 0) rvcEnabled = false;
+            continue;
+        }
 
         ParsedInstruction pInst;
-        pInst.mnemonic = mnemonic;
+        string error;
+        if (!parseInstructionLine(line, start, arena, pInst, error)) {
+            throw std::runtime_error("Line " + to_string(lineIndex + 1) + ": " + line.substr(start) + " -> " + error);
+        }
+        if (pInst.mnemonic().empty()) continue;
         pInst.address = currentAddress;
-        pInst.originalLine = line;
-
-        // Handle the special format for loads/stores: lw rd, imm(rs1)
-        if (mnemonic == "lw" || mnemonic == "sw") {
-            // Split the rest by comma: "rd/rs2, imm(rs1)"
-            vector<string> parts = split(restOfLine, ',');
-            if (parts.size() != 2) {
-                cerr << "ERROR on line: " << line << " -> Incorrect operand count for " << mnemonic << endl;
-                exit(1);
-            }
-            
-            string destReg = parts[0]; // rd for lw, rs2 for sw
-            string immAndBase = parts[1]; // imm(rs1)
+        pInst.rvc = rvcEnabled;
+        pInst.line = (unsigned int)lineIndex + 1;
 
-            // Find the opening '(' and closing ')'
-            size_t openParen = immAndBase.find('(');
-            size_t closeParen = immAndBase.find(')');
+        instructions.push_back(pInst);
+        currentAddress += 4;
+    }
 
-            if (openParen == string::npos || closeParen == string::npos || closeParen < openParen) {
-                cerr << "ERROR on line: " << line << " -> Invalid address format for " << mnemonic << ". Expected: imm(rs1)" << endl;
-                exit(1);
-            }
+    return instructions;
+}
 
-            string imm = immAndBase.substr(0, openParen);
-            string baseReg = immAndBase.substr(openParen + 1, closeParen - (openParen + 1));
+/**
+ * Copies each instruction's text record into arena, so the instructions
+ * outlive the arena they were parsed into.
+ */
+void copyToArena(vector<ParsedInstruction>& instructions, AsmArena& arena) {
+    for (ParsedInstruction& inst : instructions) {
+        inst.text = arena.copy(inst.text, inst.record_length);
+    }
+}
 
-            baseReg.erase(remove_if(baseReg.begin(), baseReg.end(), ::isspace), baseReg.end());
-            
-            pInst.operands.push_back(destReg);
-            pInst.operands.push_back(baseReg);
-            pInst.operands.push_back(imm);
+/**
+ * Pass 2b: pick 16-bit encodings under ".option rvc".
+ * Shrinking instructions moves labels, so branch ranges are re-checked until
+ * the layout is stable; a C.BEQZ that no longer reaches its target is widened
+ * back to 4 bytes (sizes only ever grow, so this terminates).
+ * Updates SYMBOL_TABLE and instruction addresses.
+ */
+void relaxCompressed(vector<ParsedInstruction>& instructions, const vector<string>& lines) {
+    bool anyCompressed = false;
+    for (ParsedInstruction& inst : instructions) {
+        inst.size = isCompressible(inst) ? 2 : 4;
+        if (inst.size == 2) anyCompressed = true;
+    }
+    if (!anyCompressed) return;
+
+    bool changed = true;
+    while (changed) {
+        changed = false;
+
+        vector<unsigned int> sizes;
+        for (const ParsedInstruction& inst : instructions) sizes.push_back(inst.size);
+        SYMBOL_TABLE = buildSymbolTable(lines, sizes);
 
-        } else {
-            pInst.operands = split(restOfLine, ',');
+        unsigned int address = INSTRUCTION_MEMORY_START;
+        for (ParsedInstruction& inst : instructions) {
+            inst.address = address;
+            address += inst.size;
         }
 
-        instructions.push_back(pInst);
-        currentAddress += 4;
+        for (ParsedInstruction& inst : instructions) {
+            if (inst.size != 2 || inst.mnemonic() != "beq") continue;
+            int offset = (int)SYMBOL_TABLE.at(string(inst.operand(2))) - (int)inst.address;
+            if (!fitsCompressedBranch(offset)) {
+                inst.size = 4;
+                changed = true;
+            }
+        }
     }
-
-    return instructions;
-}
\ No newline at end of file
+}
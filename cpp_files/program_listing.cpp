@@ -0,0 +1,43 @@
+#include "../hpp_files/program_listing.hpp"
+#include <cstdio>
+
+ProgramListing::ProgramListing() {}
+
+void ProgramListing::clear() {
+    listing.clear();
+    slots.clear();
+    lines.clear();
+}
+
+void ProgramListing::build(const vector<ParsedInstruction>& instructions, const map<unsigned int, unsigned int>& imem) {
+    clear();
+    if (instructions.empty()) return;
+
+    const ParsedInstruction& last = instructions.back();
+    slots.assign((last.address + last.size - INSTRUCTION_MEMORY_START) / 2, -1);
+    lines.reserve(instructions.size());
+
+    // ~40 bytes of address and encoding per row plus the source text
+    size_t bytes = 0;
+    for (const ParsedInstruction& inst : instructions) bytes += 40 + inst.text_length;
+    listing.reserve(bytes);
+
+    char prefix[40];
+    for (size_t row = 0; row < instructions.size(); row++) {
+        const ParsedInstruction& inst = instructions[row];
+        auto word = imem.find(inst.address);
+        unsigned int opcode = (word != imem.end()) ? word->second : 0;
+
+        if (inst.size == 2) {
+            snprintf(prefix, sizeof(prefix), "0x%08x | 0x%04x     | ", inst.address, opcode);
+        } else {
+            snprintf(prefix, sizeof(prefix), "0x%08x | 0x%08x | ", inst.address, opcode);
+        }
+        listing += prefix;
+        listing += inst.source_line();
+        listing += '\n';
+
+        slots[(inst.address - INSTRUCTION_MEMORY_START) / 2] = (int32_t)row;
+        lines.push_back(inst.line);
+    }
+}
@@ -0,0 +1,839 @@
+#include "../hpp_files/riscvsim.h"
+#include "../hpp_files/riscvsim_program.hpp"
+#include "../hpp_files/parser.hpp"
+#include "../hpp_files/encoder.hpp"
+#include "../hpp_files/simulator.hpp"
+#include "../hpp_files/compressed.hpp"
+#include "../hpp_files/sim_status.hpp"
+#include <cstdarg>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <streambuf>
+
+static_assert(RVSIM_ERR_LIMIT == (int)SIM_ERR_LIMIT, "rvsim_status must match SimStatus");
+static_assert(sizeof(rvsim_stats) == sizeof(SimStats) && VOP_COUNT == 6, "rvsim_stats must mirror SimStats");
+static_assert(RVSIM_DELTA_MAX_WORDS == DELTA_MAX_MEM_WORDS, "delta word limit");
+
+// --- Errors ---
+
+// Per thread, so sessions on other threads cannot overwrite the message
+static thread_local char lastError[256] = "";
+
+static int fail(int status, const char* format, ...) {
+    va_list args;
+    va_start(args, format);
+    vsnprintf(lastError, sizeof(lastError), format, args);
+    va_end(args);
+    return status;
+}
+
+static int succeed() {
+    lastError[0] = '\0';
+    return RVSIM_OK;
+}
+
+// --- Trace output ---
+
+// Buffers the TraceLog text and hands it to the session's callback in chunks
+class TraceBuffer : public std::streambuf {
+public:
+    TraceBuffer() : fn(nullptr), user(nullptr) { setp(buf, buf + sizeof(buf)); }
+
+    void set_target(rvsim_trace_fn fn, void* user) {
+        sync();
+        this->fn = fn;
+        this->user = user;
+    }
+
+protected:
+    int overflow(int c) override {
+        sync();
+        if (traits_type::eq_int_type(c, traits_type::eof())) return traits_type::not_eof(c);
+        *pptr() = traits_type::to_char_type(c);
+        pbump(1);
+        return c;
+    }
+
+    int sync() override {
+        if (fn && pptr() > pbase()) fn(pbase(), (size_t)(pptr() - pbase()), user);
+        setp(buf, buf + sizeof(buf));
+        return 0;
+    }
+
+private:
+    char buf[4096];
+    rvsim_trace_fn fn;
+    void* user;
+};
+
+// --- Simulators behind a session ---
+
+// One simulator of either width, with or without the trace, behind one interface
+class SessionSim {
+public:
+    virtual ~SessionSim() {}
+
+    virtual void step() = 0;
+    virtual uint64_t run(uint64_t max_cycles, uint64_t text_end) = 0;
+    virtual bool is_drained(uint64_t text_end) const = 0;
+    virtual void load(const map<unsigned int, int32_t>& data) = 0; // Data segment, then the reset point
+    virtual void reset() = 0;
+    virtual void reload_code(uint32_t addr, uint32_t len) = 0;
+    virtual bool patch_reset_memory(uint32_t addr, const uint8_t* src, uint32_t len) = 0;
+
+    virtual uint64_t get_pc() const = 0;
+    virtual int64_t get_reg(int idx) const = 0;
+    virtual void set_reg(int idx, int64_t value) = 0;
+    virtual uint32_t get_mem_size() const = 0;
+    virtual void read_mem(uint32_t addr, uint8_t* dst, uint32_t len) const = 0;
+    virtual bool write_mem(uint32_t addr, const uint8_t* src, uint32_t len) = 0;
+    virtual int32_t get_vreg(int idx, int elem) const = 0;
+    virtual uint32_t get_vl() const = 0;
+    virtual unsigned int get_vlen() const = 0;
+    virtual bool is_halted() const = 0;
+    virtual uint32_t get_trap_cause() const = 0;
+    virtual SimStats get_stats() const = 0;
+    virtual void get_pipeline(rvsim_pipeline& p) = 0;
+    virtual const StepDelta& get_delta() const = 0;
+    virtual void clear_delta() = 0;
+
+    virtual void set_mem_size(uint32_t bytes) = 0;
+    virtual void set_satp(uint32_t value) = 0;
+    virtual void configure_tlbs(uint32_t itlb_entries, uint32_t dtlb_entries) = 0;
+    virtual void set_trap_vector(uint64_t addr) = 0;
+    virtual void set_unified_memory(bool enable) = 0;
+    virtual bool is_unified_memory() const = 0;
+    virtual bool set_vlen(unsigned int bits) = 0;
+    virtual void set_trace(std::ostream& out) = 0;
+    virtual void set_trace_enabled(bool on) = 0;
+    virtual void set_page_arena(PageArena* arena) = 0;
+    virtual bool memory_exhausted() const = 0;
+    virtual uint32_t resident_pages() const = 0;
+};
+
+template <int XLEN, class Plugins>
+class SessionSimT : public SessionSim {
+public:
+    typedef typename XlenTraits<XLEN>::uxlen_t uxlen_t;
+    typedef typename XlenTraits<XLEN>::sxlen_t sxlen_t;
+
+    SessionSimT(std::map<unsigned int, unsigned int>& text) : sim(text), arena(false) {}
+
+    void step() override { sim.step(); }
+    uint64_t run(uint64_t max_cycles, uint64_t text_end) override {
+        uint64_t n = 0;
+        if (text_end == 0) return 0;
+        if (arena) {
+            // Stop on the cycle the arena runs dry; sessions without one skip the check
+            while (n < max_cycles && !sim.is_drained((uxlen_t)text_end) && !sim.memory_exhausted()) {
+                sim.step();
+                n++;
+            }
+            return n;
+        }
+        while (n < max_cycles && !sim.is_drained((uxlen_t)text_end)) {
+            sim.step();
+            n++;
+        }
+        return n;
+    }
+    bool is_drained(uint64_t text_end) const override { return sim.is_drained((uxlen_t)text_end); }
+    void load(const map<unsigned int, int32_t>& data) override {
+        sim.load_data(data);
+        sim.save_reset_point();
+    }
+    void reset() override { sim.reset(); }
+    void reload_code(uint32_t addr, uint32_t len) override { sim.reload_code(addr, len); }
+    bool patch_reset_memory(uint32_t addr, const uint8_t* src, uint32_t len) override {
+        return sim.patch_reset_memory(addr, src, len);
+    }
+
+    uint64_t get_pc() const override { return sim.get_pc(); }
+    int64_t get_reg(int idx) const override { return sim.get_reg(idx); }
+    void set_reg(int idx, int64_t value) override { sim.set_reg(idx, (sxlen_t)value); }
+    uint32_t get_mem_size() const override { return sim.get_mem_size(); }
+    void read_mem(uint32_t addr, uint8_t* dst, uint32_t len) const override { sim.read_mem_block(addr, dst, len); }
+    bool write_mem(uint32_t addr, const uint8_t* src, uint32_t len) override { return sim.write_mem_block(addr, src, len); }
+    int32_t get_vreg(int idx, int elem) const override { return sim.get_vreg(idx, elem); }
+    uint32_t get_vl() const override { return sim.get_vl(); }
+    unsigned int get_vlen() const override { return sim.get_vlen(); }
+    bool is_halted() const override { return sim.is_halted(); }
+    uint32_t get_trap_cause() const override { return sim.get_trap_cause(); }
+    SimStats get_stats() const override { return sim.get_stats(); }
+
+    void get_pipeline(rvsim_pipeline& p) override {
+        IF_ID_T<XLEN> if_id = sim.get_if_id();
+        ID_EX_T<XLEN> id_ex = sim.get_id_ex();
+        EX_MEM_T<XLEN> ex_mem = sim.get_ex_mem();
+        MEM_WB_T<XLEN> mem_wb = sim.get_mem_wb();
+
+        p.cycle = sim.get_stats().cycles;
+        p.pc = sim.get_pc();
+        p.if_id_pc = if_id.PC;
+        p.if_id_npc = if_id.NPC;
+        p.if_id_ir = if_id.IR;
+        p.id_ex_ir = id_ex.IR;
+        p.id_ex_pc = id_ex.PC;
+        p.id_ex_npc = id_ex.NPC;
+        p.id_ex_a = (sxlen_t)id_ex.A;
+        p.id_ex_b = (sxlen_t)id_ex.B;
+        p.id_ex_imm = id_ex.IMM;
+        p.ex_mem_ir = ex_mem.IR;
+        p.ex_mem_cond = (ex_mem.ctrl & CTRL_COND) != 0;
+        p.ex_mem_pc = ex_mem.PC;
+        p.ex_mem_aluoutput = ex_mem.ALUOutput;
+        p.ex_mem_b = (sxlen_t)ex_mem.B;
+        p.mem_wb_ir = mem_wb.IR;
+        p.mem_wb_rd = mem_wb.rd;
+        p.mem_wb_regwrite = (mem_wb.ctrl & CTRL_REG_WRITE) != 0;
+        p.mem_wb_pc = mem_wb.PC;
+        p.mem_wb_aluoutput = mem_wb.ALUOutput;
+        p.mem_wb_lmd = mem_wb.LMD;
+    }
+    const StepDelta& get_delta() const override { return sim.get_delta(); }
+    void clear_delta() override { sim.clear_delta(); }
+
+    void set_mem_size(uint32_t bytes) override { sim.set_mem_size(bytes); }
+    void set_satp(uint32_t value) override { sim.set_satp(value); }
+    void configure_tlbs(uint32_t itlb_entries, uint32_t dtlb_entries) override { sim.configure_tlbs(itlb_entries, dtlb_entries); }
+    void set_trap_vector(uint64_t addr) override { sim.set_trap_vector((uxlen_t)addr); }
+    void set_unified_memory(bool enable) override { sim.set_unified_memory(enable); }
+    bool is_unified_memory() const override { return sim.is_unified_memory(); }
+    bool set_vlen(unsigned int bits) override { return sim.set_vlen(bits); }
+    void set_trace(std::ostream& out) override { sim.set_trace(out); }
+    void set_trace_enabled(bool on) override { sim.set_trace_enabled(on); }
+    void set_page_arena(PageArena* pages) override {
+        sim.set_page_arena(pages);
+        arena = pages != nullptr;
+    }
+    bool memory_exhausted() const override { return sim.memory_exhausted(); }
+    uint32_t resident_pages() const override { return (uint32_t)sim.resident_pages(); }
+
+private:
+    RISCV_SimulatorT<XLEN, Plugins> sim;
+    bool arena; // Pages come from a PageArena
+};
+
+// Sessions without RVSIM_TRACE use StatsPlugins: the trace is compiled out
+template <int XLEN>
+static SessionSim* newSessionSim(std::map<unsigned int, unsigned int>& text, bool trace) {
+    if (trace) return new SessionSimT<XLEN, DefaultPlugins>(text);
+    return new SessionSimT<XLEN, StatsPlugins>(text);
+}
+
+// --- Handles ---
+
+struct rvsim_session {
+    std::mutex lock; // Held by every call on the session
+    unsigned int flags;
+    int xlen;
+
+    // The loaded program. The simulator holds text by reference, so it is
+    // declared before sim; symbols and data are what a reload diffs against.
+    map<unsigned int, unsigned int> text;
+    map<string, unsigned int> symbols;
+    map<unsigned int, int32_t> data;
+    uint64_t text_end; // 0 for a program without instructions
+
+    // Settings a reset keeps
+    bool unified_memory;
+    unsigned int vlen;
+
+    // Limits (all zero for rvsim_create). The arena is declared before sim
+    // because the simulator's memories hand their pages back to it.
+    rvsim_limits limits;
+    uint64_t cycles_used; // Toward limits.max_cycles since the last reset
+    std::unique_ptr<PageArena> arena;
+
+    TraceBuffer trace_buffer;
+    std::ostream trace_stream;
+    std::unique_ptr<SessionSim> sim;
+
+    rvsim_session() : flags(0), xlen(0), text_end(0), unified_memory(false), vlen(DEFAULT_VLEN), limits(),
+                      cycles_used(0), trace_stream(&trace_buffer) {}
+
+    bool finished() const { return text_end == 0 || sim->is_drained(text_end); }
+    bool out_of_cycles() const { return limits.max_cycles != 0 && cycles_used >= limits.max_cycles; }
+};
+
+#define LOCK_SESSION(session) \
+    if (session == nullptr) return fail(RVSIM_ERR_NOT_INITIALIZED, "No session"); \
+    std::lock_guard<std::mutex> sessionLock(session->lock)
+
+// Value getters return 0 instead of a status
+#define LOCK_SESSION_OR_ZERO(session) \
+    if (session == nullptr) return 0; \
+    std::lock_guard<std::mutex> sessionLock(session->lock)
+
+unsigned int rvsim_api_version(void) {
+    return RVSIM_API_VERSION;
+}
+
+const char* rvsim_last_error(void) {
+    return lastError;
+}
+
+// --- Programs ---
+
+// The assembler passes share SYMBOL_TABLE and DATA_SEGMENT; one assembly at a time
+static std::mutex assemblerLock;
+
+// Comment-free, trimmed source lines. Blank lines are kept (the passes skip
+// them) so ParsedInstruction::line is the editor line number.
+static vector<string> sourceLines(const char* source, size_t length) {
+    std::istringstream stream(string(source, length));
+    vector<string> lines;
+    string line;
+
+    while (getline(stream, line)) {
+        size_t commentPos = line.find('#');
+        if (commentPos != string::npos) line = line.substr(0, commentPos);
+
+        line.erase(0, line.find_first_not_of(" \t\r\n"));
+        line.erase(line.find_last_not_of(" \t\r\n") + 1);
+        lines.push_back(line);
+    }
+    return lines;
+}
+
+int rvsim_assemble(const char* source, size_t length, int xlen, rvsim_program** out) {
+    if (out == nullptr) return fail(RVSIM_ERR_INVALID_ARGUMENT, "No output handle");
+    *out = nullptr;
+    if (source == nullptr && length > 0) return fail(RVSIM_ERR_INVALID_ARGUMENT, "No source");
+    if (xlen != 32 && xlen != 64) return fail(RVSIM_ERR_INVALID_ARGUMENT, "XLEN must be 32 or 64, got %d", xlen);
+
+    vector<string> lines = sourceLines(source, length);
+    if (std::all_of(lines.begin(), lines.end(), [](const string& l) { return l.empty(); })) {
+        return fail(RVSIM_ERR_ASSEMBLY, "No valid assembly code provided");
+    }
+
+    std::unique_ptr<rvsim_program> program(new rvsim_program());
+    program->xlen = xlen;
+    try {
+        std::lock_guard<std::mutex> guard(assemblerLock);
+        SYMBOL_TABLE = buildSymbolTable(lines);
+        DATA_SEGMENT.clear();
+        parseDataSection(lines);
+        program->instructions = parseInstructions(lines, program->arena);
+        relaxCompressed(program->instructions, lines);
+        program->text = (xlen == 64) ? translateToOpcode<64>(program->instructions)
+                                     : translateToOpcode<32>(program->instructions);
+        program->symbols = SYMBOL_TABLE;
+        program->data = DATA_SEGMENT;
+    } catch (const std::exception& e) {
+        return fail(RVSIM_ERR_ASSEMBLY, "%s", e.what());
+    }
+    program->listing.build(program->instructions, program->text);
+
+    *out = program.release();
+    return succeed();
+}
+
+rvsim_program* rvsimProgramFromParts(int xlen, vector<ParsedInstruction> instructions,
+                                     map<unsigned int, unsigned int> text,
+                                     map<string, unsigned int> symbols,
+                                     map<unsigned int, int32_t> data) {
+    rvsim_program* program = new rvsim_program();
+    program->xlen = xlen;
+    program->instructions = std::move(instructions);
+    copyToArena(program->instructions, program->arena);
+    program->text = std::move(text);
+    program->symbols = std::move(symbols);
+    program->data = std::move(data);
+    program->listing.build(program->instructions, program->text);
+    return program;
+}
+
+void rvsim_program_free(rvsim_program* program) {
+    delete program;
+}
+
+int rvsim_program_xlen(const rvsim_program* program) {
+    return program ? program->xlen : 0;
+}
+
+uint32_t rvsim_program_instruction_count(const rvsim_program* program) {
+    return program ? (uint32_t)program->instructions.size() : 0;
+}
+
+uint64_t rvsim_program_text_end(const rvsim_program* program) {
+    return program ? program->text_end() : 0;
+}
+
+const char* rvsim_program_listing(const rvsim_program* program) {
+    return program ? program->listing.text().c_str() : "";
+}
+
+int rvsim_program_row_for_pc(const rvsim_program* program, uint64_t pc) {
+    return program ? program->listing.row_for_pc(pc) : -1;
+}
+
+uint32_t rvsim_program_line_for_pc(const rvsim_program* program, uint64_t pc) {
+    return program ? program->listing.line_for_pc(pc) : 0;
+}
+
+// --- Sessions ---
+
+static int createSession(const rvsim_program* program, unsigned int flags, const rvsim_limits& limits,
+                         rvsim_session** out) {
+    if (out == nullptr) return fail(RVSIM_ERR_INVALID_ARGUMENT, "No output handle");
+    *out = nullptr;
+    if (program == nullptr) return fail(RVSIM_ERR_NOT_INITIALIZED, "No program");
+
+    try {
+        std::unique_ptr<rvsim_session> session(new rvsim_session());
+        session->flags = flags;
+        session->xlen = program->xlen;
+        session->text = program->text;
+        session->symbols = program->symbols;
+        session->data = program->data;
+        session->text_end = program->text_end();
+        session->limits = limits;
+
+        bool trace = (flags & RVSIM_TRACE) != 0;
+        if (program->xlen == 64) session->sim.reset(newSessionSim<64>(session->text, trace));
+        else session->sim.reset(newSessionSim<32>(session->text, trace));
+        if (limits.max_pages != 0) {
+            session->arena.reset(new PageArena(limits.max_pages));
+            session->sim->set_page_arena(session->arena.get());
+        }
+        session->sim->load(session->data);
+        if (session->sim->memory_exhausted()) {
+            return fail(RVSIM_ERR_LIMIT, ".data and its reset image need more than %u pages", limits.max_pages);
+        }
+        session->vlen = session->sim->get_vlen();
+
+        *out = session.release();
+        return succeed();
+    } catch (const std::exception& e) {
+        return fail(RVSIM_ERR_EXCEPTION, "%s", e.what());
+    }
+}
+
+int rvsim_create(const rvsim_program* program, unsigned int flags, rvsim_session** out) {
+    return createSession(program, flags, rvsim_limits(), out);
+}
+
+int rvsim_create_limited(const rvsim_program* program, unsigned int flags, const rvsim_limits* limits, size_t size,
+                         rvsim_session** out) {
+    rvsim_limits l = {};
+    if (limits) std::memcpy(&l, limits, std::min(size, sizeof(l)));
+    return createSession(program, flags, l, out);
+}
+
+void rvsim_destroy(rvsim_session* session) {
+    delete session;
+}
+
+// Restores the post-create state in place (registers, latches, memory image);
+// settings changed since create still apply. The caller holds the lock.
+static void resetSession(rvsim_session* session) {
+    SessionSim& sim = *session->sim;
+    // Memory mode first: reset() maps the text back in while unified mode is on
+    if (sim.is_unified_memory() != session->unified_memory) sim.set_unified_memory(session->unified_memory);
+    sim.reset();
+    sim.set_vlen(session->vlen);
+    session->cycles_used = 0;
+}
+
+int rvsim_reset(rvsim_session* session) {
+    LOCK_SESSION(session);
+    try {
+        resetSession(session);
+        return succeed();
+    } catch (const std::exception& e) {
+        return fail(RVSIM_ERR_EXCEPTION, "%s", e.what());
+    }
+}
+
+int rvsim_reload(rvsim_session* session, const rvsim_program* program, int keep_state, rvsim_reload_stats* out) {
+    if (program == nullptr) return fail(RVSIM_ERR_NOT_INITIALIZED, "No program");
+    LOCK_SESSION(session);
+    if (program->xlen != session->xlen) {
+        return fail(RVSIM_ERR_INVALID_ARGUMENT, "Program is RV%d, session is RV%d", program->xlen, session->xlen);
+    }
+
+    try {
+        rvsim_reload_stats stats = {0, 0, 0};
+        SessionSim& sim = *session->sim;
+
+        // Walk both address-ordered images together. session->text is
+        // patched in place because the simulator holds it by reference.
+        auto slot = [](unsigned int word) -> uint32_t { return isCompressedEncoding(word) ? 2 : 4; };
+        vector<std::pair<uint32_t, uint32_t>> patched; // (addr, bytes)
+        map<unsigned int, unsigned int>& text = session->text;
+        auto oi = text.begin();
+        auto ni = program->text.begin();
+        while (oi != text.end() || ni != program->text.end()) {
+            if (ni == program->text.end() || (oi != text.end() && oi->first < ni->first)) {
+                patched.push_back({oi->first, slot(oi->second)});
+                oi = text.erase(oi);
+            } else if (oi == text.end() || ni->first < oi->first) {
+                patched.push_back({ni->first, slot(ni->second)});
+                oi = std::next(text.insert(oi, *ni));
+                ++ni;
+            } else {
+                if (oi->second != ni->second) {
+                    patched.push_back({oi->first, std::max(slot(oi->second), slot(ni->second))});
+                    oi->second = ni->second;
+                }
+                ++oi;
+                ++ni;
+            }
+        }
+        for (auto const& [addr, len] : patched) sim.reload_code(addr, len);
+        stats.text_changed = (uint32_t)patched.size();
+
+        // .data words that differ go into the reset image; removed words become 0.
+        // A word outside memory or past the page limit stops the reload there.
+        auto noRoom = [](uint32_t addr) {
+            return fail(RVSIM_ERR_LIMIT, ".data word at 0x%x does not fit in memory or the page limit", addr);
+        };
+        for (auto const& [addr, val] : session->data) {
+            if (!program->data.count(addr)) {
+                uint8_t zero[4] = {0, 0, 0, 0};
+                if (!sim.patch_reset_memory(addr, zero, 4)) return noRoom(addr);
+                stats.data_changed++;
+            }
+        }
+        for (auto const& [addr, val] : program->data) {
+            auto old = session->data.find(addr);
+            if (old != session->data.end() && old->second == val) continue;
+            uint8_t bytes[4];
+            for (int b = 0; b < 4; b++) bytes[b] = ((uint32_t)val >> (8 * b)) & 0xFF;
+            if (!sim.patch_reset_memory(addr, bytes, 4)) return noRoom(addr);
+            stats.data_changed++;
+        }
+
+        for (auto const& [name, addr] : program->symbols) {
+            auto old = session->symbols.find(name);
+            if (old == session->symbols.end() || old->second != addr) stats.symbols_changed++;
+        }
+        for (auto const& [name, addr] : session->symbols) {
+            if (!program->symbols.count(name)) stats.symbols_changed++;
+        }
+
+        session->symbols = program->symbols;
+        session->data = program->data;
+        session->text_end = program->text_end();
+
+        if (!keep_state) resetSession(session);
+        if (out) *out = stats;
+        return succeed();
+    } catch (const std::exception& e) {
+        return fail(RVSIM_ERR_EXCEPTION, "%s", e.what());
+    }
+}
+
+// RVSIM_ERR_LIMIT once a run has used up the cycle budget or the page arena
+static int limitReached(rvsim_session* session) {
+    if (session->sim->memory_exhausted()) {
+        return fail(RVSIM_ERR_LIMIT, "Data memory limit of %u pages reached", session->limits.max_pages);
+    }
+    return fail(RVSIM_ERR_LIMIT, "Cycle budget of %llu cycles used up", (unsigned long long)session->limits.max_cycles);
+}
+
+int rvsim_step(rvsim_session* session) {
+    LOCK_SESSION(session);
+    if (session->out_of_cycles() || session->sim->memory_exhausted()) return limitReached(session);
+    try {
+        session->sim->step();
+        session->cycles_used++;
+        session->trace_stream.flush();
+        if (session->sim->memory_exhausted()) return limitReached(session);
+        return succeed();
+    } catch (const std::exception& e) {
+        return fail(RVSIM_ERR_EXCEPTION, "%s", e.what());
+    }
+}
+
+int rvsim_run(rvsim_session* session, uint64_t max_cycles, uint64_t* cycles_run) {
+    if (cycles_run) *cycles_run = 0;
+    LOCK_SESSION(session);
+    if (session->out_of_cycles() || session->sim->memory_exhausted()) return limitReached(session);
+    try {
+        // The budget shortens the run; stopping on it is a failure, stopping on max_cycles is not
+        uint64_t allowed = max_cycles;
+        if (session->limits.max_cycles != 0) allowed = std::min(max_cycles, session->limits.max_cycles - session->cycles_used);
+        uint64_t n = session->sim->run(allowed, session->text_end);
+        session->cycles_used += n;
+        session->trace_stream.flush();
+        if (cycles_run) *cycles_run = n;
+        if (session->sim->memory_exhausted()) return limitReached(session);
+        if (allowed < max_cycles && n == allowed && !session->finished()) return limitReached(session);
+        return succeed();
+    } catch (const std::exception& e) {
+        return fail(RVSIM_ERR_EXCEPTION, "%s", e.what());
+    }
+}
+
+int rvsim_is_finished(rvsim_session* session) {
+    LOCK_SESSION_OR_ZERO(session);
+    return session->finished();
+}
+
+int rvsim_is_halted(rvsim_session* session) {
+    LOCK_SESSION_OR_ZERO(session);
+    return session->sim->is_halted();
+}
+
+// --- State ---
+
+uint64_t rvsim_get_pc(rvsim_session* session) {
+    LOCK_SESSION_OR_ZERO(session);
+    return session->sim->get_pc();
+}
+
+int64_t rvsim_get_reg(rvsim_session* session, int idx) {
+    LOCK_SESSION_OR_ZERO(session);
+    if (idx < 0 || idx > 31) return 0;
+    return session->sim->get_reg(idx);
+}
+
+int rvsim_set_reg(rvsim_session* session, int idx, int64_t value) {
+    LOCK_SESSION(session);
+    if (idx < 1 || idx > 31) {
+        return fail(RVSIM_ERR_INVALID_ARGUMENT, "Invalid register index %d (must be 1-31)", idx);
+    }
+    session->sim->set_reg(idx, value);
+    return succeed();
+}
+
+uint32_t rvsim_get_mem_size(rvsim_session* session) {
+    LOCK_SESSION_OR_ZERO(session);
+    return session->sim->get_mem_size();
+}
+
+int rvsim_read_mem(rvsim_session* session, uint32_t addr, void* dst, uint32_t length) {
+    LOCK_SESSION(session);
+    uint32_t size = session->sim->get_mem_size();
+    if ((uint64_t)addr + length > size || (dst == nullptr && length > 0)) {
+        return fail(RVSIM_ERR_INVALID_ARGUMENT, "Range [%u, %llu) is outside memory (size %u)",
+                    addr, (unsigned long long)addr + length, size);
+    }
+    session->sim->read_mem(addr, (uint8_t*)dst, length);
+    return succeed();
+}
+
+int rvsim_write_mem(rvsim_session* session, uint32_t addr, const void* src, uint32_t length) {
+    LOCK_SESSION(session);
+    uint32_t size = session->sim->get_mem_size();
+    if ((uint64_t)addr + length > size || (src == nullptr && length > 0)) {
+        return fail(RVSIM_ERR_INVALID_ARGUMENT, "Range [%u, %llu) is outside memory (size %u)",
+                    addr, (unsigned long long)addr + length, size);
+    }
+    if (!session->sim->write_mem(addr, (const uint8_t*)src, length)) {
+        return fail(RVSIM_ERR_LIMIT, "Data memory limit of %u pages reached", session->limits.max_pages);
+    }
+    return succeed();
+}
+
+int32_t rvsim_get_vreg(rvsim_session* session, int idx, int elem) {
+    LOCK_SESSION_OR_ZERO(session);
+    return session->sim->get_vreg(idx, elem);
+}
+
+uint32_t rvsim_get_vl(rvsim_session* session) {
+    LOCK_SESSION_OR_ZERO(session);
+    return session->sim->get_vl();
+}
+
+uint32_t rvsim_get_trap_cause(rvsim_session* session) {
+    LOCK_SESSION_OR_ZERO(session);
+    return session->sim->get_trap_cause();
+}
+
+int rvsim_get_stats(rvsim_session* session, rvsim_stats* out, size_t size) {
+    if (out == nullptr) return fail(RVSIM_ERR_INVALID_ARGUMENT, "No output struct");
+    LOCK_SESSION(session);
+    SimStats s = session->sim->get_stats();
+    std::memcpy(out, &s, std::min(size, sizeof(s)));
+    return succeed();
+}
+
+int rvsim_get_usage(rvsim_session* session, rvsim_usage* out, size_t size) {
+    if (out == nullptr) return fail(RVSIM_ERR_INVALID_ARGUMENT, "No output struct");
+    LOCK_SESSION(session);
+    rvsim_usage u;
+    u.pages = session->sim->resident_pages();
+    u.page_capacity = session->limits.max_pages;
+    u.cycles = session->cycles_used;
+    u.cycle_budget = session->limits.max_cycles;
+    std::memcpy(out, &u, std::min(size, sizeof(u)));
+    return succeed();
+}
+
+int rvsim_get_pipeline(rvsim_session* session, rvsim_pipeline* out, size_t size) {
+    if (out == nullptr) return fail(RVSIM_ERR_INVALID_ARGUMENT, "No output struct");
+    LOCK_SESSION(session);
+    rvsim_pipeline p;
+    session->sim->get_pipeline(p);
+    std::memcpy(out, &p, std::min(size, sizeof(p)));
+    return succeed();
+}
+
+int rvsim_take_delta(rvsim_session* session, rvsim_delta* out, uint32_t* words, uint32_t capacity) {
+    if (out == nullptr || (words == nullptr && capacity > 0)) return fail(RVSIM_ERR_INVALID_ARGUMENT, "No output buffer");
+    LOCK_SESSION(session);
+    const StepDelta& d = session->sim->get_delta();
+    out->cycles = d.cycles;
+    out->regs = d.regs;
+    out->vregs = d.vregs;
+    out->latches = d.latches;
+    out->pc = d.pc;
+    out->mem_overflow = d.mem_overflow;
+    out->mem_words = (uint32_t)std::min<size_t>(capacity, d.mem_words.size());
+    std::copy(d.mem_words.begin(), d.mem_words.begin() + out->mem_words, words);
+    session->sim->clear_delta();
+    return succeed();
+}
+
+// --- Configuration ---
+
+int rvsim_set_mem_size(rvsim_session* session, uint32_t bytes) {
+    LOCK_SESSION(session);
+    if (session->limits.max_mem_bytes != 0 && bytes > session->limits.max_mem_bytes) {
+        return fail(RVSIM_ERR_LIMIT, "Memory size %u is over the session limit of %u bytes", bytes, session->limits.max_mem_bytes);
+    }
+    session->sim->set_mem_size(bytes);
+    return succeed();
+}
+
+int rvsim_set_satp(rvsim_session* session, uint32_t value) {
+    LOCK_SESSION(session);
+    session->sim->set_satp(value);
+    return succeed();
+}
+
+int rvsim_configure_tlb(rvsim_session* session, uint32_t itlb_entries, uint32_t dtlb_entries) {
+    LOCK_SESSION(session);
+    uint32_t cap = session->limits.max_tlb_entries;
+    if (cap != 0 && (itlb_entries > cap || dtlb_entries > cap)) {
+        return fail(RVSIM_ERR_LIMIT, "TLB sizes %u/%u are over the session limit of %u entries", itlb_entries, dtlb_entries, cap);
+    }
+    session->sim->configure_tlbs(itlb_entries, dtlb_entries);
+    return succeed();
+}
+
+int rvsim_set_trap_vector(rvsim_session* session, uint64_t addr) {
+    LOCK_SESSION(session);
+    session->sim->set_trap_vector(addr);
+    return succeed();
+}
+
+int rvsim_set_unified_memory(rvsim_session* session, int enable) {
+    LOCK_SESSION(session);
+    session->unified_memory = enable != 0;
+    session->sim->set_unified_memory(session->unified_memory);
+    return succeed();
+}
+
+int rvsim_set_vlen(rvsim_session* session, uint32_t bits) {
+    LOCK_SESSION(session);
+    if (!session->sim->set_vlen(bits)) {
+        return fail(RVSIM_ERR_INVALID_ARGUMENT, "VLEN must be a power of two between 32 and %u", MAX_VLEN);
+    }
+    session->vlen = bits;
+    return succeed();
+}
+
+int rvsim_set_trace(rvsim_session* session, rvsim_trace_fn fn, void* user) {
+    LOCK_SESSION(session);
+    if (!(session->flags & RVSIM_TRACE)) {
+        return fail(RVSIM_ERR_UNSUPPORTED, "Session was created without RVSIM_TRACE");
+    }
+    session->trace_buffer.set_target(fn, user);
+    if (fn) session->sim->set_trace(session->trace_stream);
+    else session->sim->set_trace(std::cout);
+    return succeed();
+}
+
+int rvsim_set_trace_enabled(rvsim_session* session, int enabled) {
+    LOCK_SESSION(session);
+    if (!(session->flags & RVSIM_TRACE)) {
+        return fail(RVSIM_ERR_UNSUPPORTED, "Session was created without RVSIM_TRACE");
+    }
+    session->sim->set_trace_enabled(enabled != 0);
+    return succeed();
+}
+
+// --- Session pools ---
+
+struct rvsim_pool {
+    std::mutex lock;
+    const rvsim_program* program; // Sessions are created from it on demand
+    unsigned int flags;
+    rvsim_limits limits;
+    uint32_t capacity;
+    vector<std::unique_ptr<rvsim_session>> sessions; // Every session created
+    vector<rvsim_session*> idle;
+};
+
+int rvsim_pool_create(const rvsim_program* program, unsigned int flags, const rvsim_limits* limits, size_t size,
+                      uint32_t capacity, rvsim_pool** out) {
+    if (out == nullptr) return fail(RVSIM_ERR_INVALID_ARGUMENT, "No output handle");
+    *out = nullptr;
+    if (program == nullptr) return fail(RVSIM_ERR_NOT_INITIALIZED, "No program");
+    if (capacity == 0) return fail(RVSIM_ERR_INVALID_ARGUMENT, "Pool capacity must be at least 1");
+
+    rvsim_pool* pool = new rvsim_pool();
+    pool->program = program;
+    pool->flags = flags;
+    pool->limits = rvsim_limits();
+    if (limits) std::memcpy(&pool->limits, limits, std::min(size, sizeof(pool->limits)));
+    pool->capacity = capacity;
+    pool->sessions.reserve(capacity);
+    pool->idle.reserve(capacity);
+    *out = pool;
+    return succeed();
+}
+
+void rvsim_pool_destroy(rvsim_pool* pool) {
+    delete pool;
+}
+
+int rvsim_pool_acquire(rvsim_pool* pool, rvsim_session** out) {
+    if (out == nullptr) return fail(RVSIM_ERR_INVALID_ARGUMENT, "No output handle");
+    *out = nullptr;
+    if (pool == nullptr) return fail(RVSIM_ERR_NOT_INITIALIZED, "No pool");
+
+    std::lock_guard<std::mutex> guard(pool->lock);
+    if (!pool->idle.empty()) {
+        *out = pool->idle.back();
+        pool->idle.pop_back();
+        return succeed();
+    }
+    if (pool->sessions.size() >= pool->capacity) {
+        return fail(RVSIM_ERR_LIMIT, "All %u sessions of the pool are in use", pool->capacity);
+    }
+    rvsim_session* session;
+    int status = createSession(pool->program, pool->flags, pool->limits, &session);
+    if (status != RVSIM_OK) return status;
+    pool->sessions.emplace_back(session);
+    *out = session;
+    return succeed();
+}
+
+void rvsim_pool_release(rvsim_pool* pool, rvsim_session* session) {
+    if (pool == nullptr || session == nullptr) return;
+    {
+        // Back to the after-create state, settings included, for the next job
+        std::lock_guard<std::mutex> sessionLock(session->lock);
+        try {
+            session->unified_memory = false;
+            session->vlen = DEFAULT_VLEN;
+            resetSession(session);
+            session->sim->configure_tlbs(DEFAULT_TLB_ENTRIES, DEFAULT_TLB_ENTRIES);
+            if (session->flags & RVSIM_TRACE) {
+                session->trace_buffer.set_target(nullptr, nullptr);
+                session->sim->set_trace(std::cout);
+                session->sim->set_trace_enabled(true);
+            }
+        } catch (const std::exception&) {
+            // Left as is; the next rvsim_reset or job setup reports the problem
+        }
+    }
+    std::lock_guard<std::mutex> guard(pool->lock);
+    pool->idle.push_back(session);
+}
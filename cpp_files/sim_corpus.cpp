@@ -0,0 +1,476 @@
+#include "../hpp_files/sim_corpus.hpp"
+#include "../hpp_files/riscvsim.h"
+#include "../hpp_files/sim_threads.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+
+static bool readFile(const std::string& path, std::string& text) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in.is_open()) return false;
+    std::stringstream ss;
+    ss << in.rdbuf();
+    text = ss.str();
+    return true;
+}
+
+static std::vector<std::string> splitLines(const std::string& text) {
+    std::vector<std::string> lines;
+    size_t start = 0;
+    while (start < text.size()) {
+        size_t end = text.find('\n', start);
+        if (end == std::string::npos) end = text.size();
+        std::string line = text.substr(start, end - start);
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        lines.push_back(line);
+        start = end + 1;
+    }
+    return lines;
+}
+
+// "#@ ..." / "#< ..." / "#= ..." after leading blanks; rest is what follows the marker
+static bool isMarked(const std::string& line, char marker, std::string& rest) {
+    size_t i = line.find_first_not_of(" \t");
+    if (i == std::string::npos || line.compare(i, 2, std::string("#") + marker) != 0) return false;
+    rest = line.substr(i + 2);
+    return true;
+}
+
+// Decimal or 0x hex with an optional '-'; the whole token must be used
+static bool parseNumber(const std::string& token, int64_t& value) {
+    size_t i = token[0] == '-' ? 1 : 0;
+    bool hex = token.compare(i, 2, "0x") == 0 || token.compare(i, 2, "0X") == 0;
+    const char* digits = token.c_str() + i + (hex ? 2 : 0);
+    if (*digits == '\0' || *digits == '-' || *digits == '+') return false;
+    char* end;
+    uint64_t v = strtoull(digits, &end, hex ? 16 : 10);
+    if (*end != '\0') return false;
+    value = (int64_t)(i ? 0 - v : v);
+    return true;
+}
+
+static std::string baseName(const std::string& path) {
+    size_t slash = path.find_last_of('/');
+    std::string name = slash == std::string::npos ? path : path.substr(slash + 1);
+    size_t dot = name.find_last_of('.');
+    return dot == std::string::npos || dot == 0 ? name : name.substr(0, dot);
+}
+
+static std::string sidecarPath(const std::string& path) {
+    size_t slash = path.find_last_of('/');
+    size_t dot = path.find_last_of('.');
+    if (dot == std::string::npos || (slash != std::string::npos && dot < slash)) return path + ".expect";
+    return path.substr(0, dot) + ".expect";
+}
+
+bool parseExpectations(const std::string& text, std::vector<CorpusExpect>& out, std::string& error) {
+    std::string line = text.substr(0, text.find('#'));
+    size_t i = 0, n = line.size();
+    auto skipBlanks = [&] { while (i < n && (line[i] == ' ' || line[i] == '\t')) i++; };
+
+    for (skipBlanks(); i < n; skipBlanks()) {
+        std::string key;
+        if (line.compare(i, 4, "mem[") == 0) {
+            size_t close = line.find(']', i);
+            if (close == std::string::npos) {
+                error = "missing ] after mem[";
+                return false;
+            }
+            key = "mem[";
+            for (size_t k = i + 4; k < close; k++) {
+                if (line[k] != ' ' && line[k] != '\t') key += line[k];
+            }
+            key += ']';
+            i = close + 1;
+        } else {
+            while (i < n && (isalnum((unsigned char)line[i]) || line[i] == '_')) key += line[i++];
+        }
+        skipBlanks();
+        if (key.empty() || i >= n || line[i] != '=') {
+            error = "expected KEY = VALUE at \"" + line.substr(i) + "\"";
+            return false;
+        }
+        i++;
+        skipBlanks();
+        std::string token;
+        while (i < n && line[i] != ' ' && line[i] != '\t') token += line[i++];
+
+        CorpusExpect e;
+        e.where = 0;
+        int64_t where = 0;
+        if (token.empty() || !parseNumber(token, e.value)) {
+            error = "bad value \"" + token + "\" for " + key;
+            return false;
+        }
+        if (key.size() >= 2 && key.size() <= 3 && key[0] == 'x' && isdigit((unsigned char)key[1]) &&
+            (key.size() == 2 || isdigit((unsigned char)key[2])) && (where = atoi(key.c_str() + 1)) < 32) {
+            e.key = EXPECT_REG;
+            e.where = (uint32_t)where;
+        } else if (key.compare(0, 4, "mem[") == 0 && parseNumber(key.substr(4, key.size() - 5), where) &&
+                   where >= 0 && where <= 0xFFFFFFFCll) {
+            e.key = EXPECT_MEM;
+            e.where = (uint32_t)where;
+        } else if (key == "pc") {
+            e.key = EXPECT_PC;
+        } else if (key == "cycles") {
+            e.key = EXPECT_CYCLES;
+        } else if (key == "instructions") {
+            e.key = EXPECT_INSTRUCTIONS;
+        } else if (key == "stalls") {
+            e.key = EXPECT_STALLS;
+        } else if (key == "halted") {
+            e.key = EXPECT_HALTED;
+        } else if (key == "cause") {
+            e.key = EXPECT_CAUSE;
+        } else if (key == "itlb_hits") {
+            e.key = EXPECT_ITLB_HITS;
+        } else if (key == "itlb_misses") {
+            e.key = EXPECT_ITLB_MISSES;
+        } else if (key == "dtlb_hits") {
+            e.key = EXPECT_DTLB_HITS;
+        } else if (key == "dtlb_misses") {
+            e.key = EXPECT_DTLB_MISSES;
+        } else if (key == "walks") {
+            e.key = EXPECT_WALKS;
+        } else {
+            error = "unknown key " + key;
+            return false;
+        }
+        out.push_back(e);
+    }
+    return true;
+}
+
+// "#@ NAME opt=value ..." into test
+static bool parseHeader(const std::string& rest, CorpusTest& test, std::string& error) {
+    std::istringstream in(rest.substr(0, rest.find('#')));
+    if (!(in >> test.name)) {
+        error = "test has no name";
+        return false;
+    }
+    std::string opt;
+    while (in >> opt) {
+        size_t eq = opt.find('=');
+        int64_t v = 0;
+        if (eq == std::string::npos || !parseNumber(opt.substr(eq + 1), v) || v < 0) {
+            error = "bad option \"" + opt + "\"";
+            return false;
+        }
+        std::string key = opt.substr(0, eq);
+        if (key == "xlen" && (v == 32 || v == 64)) test.xlen = (int)v;
+        else if (key == "mem" && v <= 0xFFFFFFFFll) test.mem_bytes = (uint32_t)v;
+        else if (key == "cycles" && v > 0) test.max_cycles = (uint64_t)v;
+        else if (key == "unified" && v <= 1) test.unified = v != 0;
+        else if (key == "vlen" && v <= 0xFFFFFFFFll) test.vlen = (uint32_t)v;
+        else if (key == "satp" && v <= 0xFFFFFFFFll) test.satp = (uint32_t)v;
+        else {
+            error = "bad option \"" + opt + "\"";
+            return false;
+        }
+    }
+    return true;
+}
+
+bool parseCorpus(const std::string& text, const std::string& file, std::vector<CorpusTest>& tests, std::string& error) {
+    std::vector<std::string> lines = splitLines(text);
+    std::string rest;
+    bool sections = false;
+    for (const std::string& line : lines) sections = sections || isMarked(line, '@', rest);
+
+    CorpusTest* current = nullptr;
+    if (!sections) {
+        // The whole file is one test
+        tests.emplace_back();
+        current = &tests.back();
+        current->name = baseName(file);
+        current->file = file;
+        current->source = text;
+    }
+
+    for (size_t i = 0; i < lines.size(); i++) {
+        std::string where = file + ":" + std::to_string(i + 1) + ": ";
+        if (isMarked(lines[i], '@', rest)) {
+            tests.emplace_back();
+            current = &tests.back();
+            current->file = file;
+            current->line = (uint32_t)(i + 1);
+            current->source.assign(i, '\n'); // Keeps assembler line numbers those of the file
+            if (!parseHeader(rest, *current, error)) {
+                error = where + error;
+                return false;
+            }
+        }
+        if (current == nullptr) continue; // Preamble before the first test
+
+        if (sections) {
+            current->source += lines[i];
+            current->source += '\n';
+        }
+        if (isMarked(lines[i], '=', rest) && !parseExpectations(rest, current->expects, error)) {
+            error = where + error;
+            return false;
+        }
+        if (isMarked(lines[i], '<', rest)) {
+            size_t first = current->inits.size();
+            if (!parseExpectations(rest, current->inits, error)) {
+                error = where + error;
+                return false;
+            }
+            for (size_t k = first; k < current->inits.size(); k++) {
+                const CorpusExpect& e = current->inits[k];
+                if (e.key != EXPECT_REG && !(e.key == EXPECT_MEM && e.where % 4 == 0)) {
+                    error = where + "only xN and word-aligned mem[ADDR] can be set";
+                    return false;
+                }
+            }
+        }
+    }
+    return true;
+}
+
+bool loadCorpusFile(const std::string& path, std::vector<CorpusTest>& tests, std::string& error) {
+    std::string text;
+    if (!readFile(path, text)) {
+        error = "cannot read " + path;
+        return false;
+    }
+    size_t first = tests.size();
+    if (!parseCorpus(text, path, tests, error)) return false;
+
+    // A whole-file test may keep its expectations in prog.expect
+    std::string sidecar = sidecarPath(path), expect;
+    if (tests.size() == first + 1 && tests[first].line == 0 && readFile(sidecar, expect)) {
+        CorpusTest& t = tests[first];
+        t.expect_file = sidecar;
+        std::vector<std::string> lines = splitLines(expect);
+        for (size_t i = 0; i < lines.size(); i++) {
+            if (!parseExpectations(lines[i], t.expects, error)) {
+                error = sidecar + ":" + std::to_string(i + 1) + ": " + error;
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+void runCorpusTest(const CorpusTest& test, CorpusState& state) {
+    state = CorpusState();
+    rvsim_program* program = nullptr;
+    rvsim_session* s = nullptr;
+
+    int status = rvsim_assemble(test.source.data(), test.source.size(), test.xlen, &program);
+    if (status == RVSIM_OK) status = rvsim_create(program, 0, &s);
+    if (status == RVSIM_OK && test.mem_bytes) status = rvsim_set_mem_size(s, test.mem_bytes);
+    if (status == RVSIM_OK && test.unified) status = rvsim_set_unified_memory(s, 1);
+    if (status == RVSIM_OK && test.vlen) status = rvsim_set_vlen(s, test.vlen);
+    for (size_t k = 0; k < test.inits.size() && status == RVSIM_OK; k++) {
+        const CorpusExpect& e = test.inits[k];
+        int32_t word = (int32_t)e.value;
+        if (e.key == EXPECT_REG) status = rvsim_set_reg(s, (int)e.where, e.value);
+        else status = rvsim_write_mem(s, e.where, &word, sizeof(word));
+    }
+    if (status == RVSIM_OK && test.satp) status = rvsim_set_satp(s, test.satp);
+    if (status == RVSIM_OK) status = rvsim_run(s, test.max_cycles, nullptr);
+    state.status = status;
+    if (status != RVSIM_OK) state.error = rvsim_last_error();
+
+    if (s != nullptr) {
+        rvsim_stats stats;
+        rvsim_get_stats(s, &stats, sizeof(stats));
+        state.finished = rvsim_is_finished(s) != 0;
+        state.halted = rvsim_is_halted(s) != 0;
+        state.pc = rvsim_get_pc(s);
+        state.cycles = stats.cycles;
+        state.instructions = stats.instructions;
+        state.stalls = stats.stall_cycles;
+        state.cause = rvsim_get_trap_cause(s);
+        state.itlb_hits = stats.itlb_hits;
+        state.itlb_misses = stats.itlb_misses;
+        state.dtlb_hits = stats.dtlb_hits;
+        state.dtlb_misses = stats.dtlb_misses;
+        state.walks = stats.page_walks;
+        for (int i = 0; i < 32; i++) state.regs[i] = rvsim_get_reg(s, i);
+        state.memory.resize(rvsim_get_mem_size(s) / 4);
+        rvsim_read_mem(s, 0, state.memory.data(), (uint32_t)state.memory.size() * 4);
+    }
+    rvsim_destroy(s);
+    rvsim_program_free(program);
+}
+
+static int64_t stateValue(const CorpusState& state, const CorpusExpect& e, bool& known) {
+    known = true;
+    switch (e.key) {
+    case EXPECT_REG:          return state.regs[e.where];
+    case EXPECT_PC:           return (int64_t)state.pc;
+    case EXPECT_CYCLES:       return (int64_t)state.cycles;
+    case EXPECT_INSTRUCTIONS: return (int64_t)state.instructions;
+    case EXPECT_STALLS:       return (int64_t)state.stalls;
+    case EXPECT_HALTED:       return state.halted ? 1 : 0;
+    case EXPECT_CAUSE:        return state.cause;
+    case EXPECT_ITLB_HITS:    return (int64_t)state.itlb_hits;
+    case EXPECT_ITLB_MISSES:  return (int64_t)state.itlb_misses;
+    case EXPECT_DTLB_HITS:    return (int64_t)state.dtlb_hits;
+    case EXPECT_DTLB_MISSES:  return (int64_t)state.dtlb_misses;
+    case EXPECT_WALKS:        return (int64_t)state.walks;
+    case EXPECT_MEM:
+        if (e.where % 4 == 0 && e.where / 4 < state.memory.size()) return state.memory[e.where / 4];
+        break;
+    }
+    known = false; // Unaligned or past the end of memory
+    return 0;
+}
+
+static std::string keyName(const CorpusExpect& e) {
+    switch (e.key) {
+    case EXPECT_REG:          return "x" + std::to_string(e.where);
+    case EXPECT_MEM:          return "mem[" + std::to_string(e.where) + "]";
+    case EXPECT_PC:           return "pc";
+    case EXPECT_CYCLES:       return "cycles";
+    case EXPECT_INSTRUCTIONS: return "instructions";
+    case EXPECT_STALLS:       return "stalls";
+    case EXPECT_HALTED:       return "halted";
+    case EXPECT_CAUSE:        return "cause";
+    case EXPECT_ITLB_HITS:    return "itlb_hits";
+    case EXPECT_ITLB_MISSES:  return "itlb_misses";
+    case EXPECT_DTLB_HITS:    return "dtlb_hits";
+    case EXPECT_DTLB_MISSES:  return "dtlb_misses";
+    case EXPECT_WALKS:        return "walks";
+    }
+    return "?";
+}
+
+std::vector<std::string> diffCorpusState(const CorpusTest& test, const CorpusState& state) {
+    std::vector<std::string> diffs;
+    if (state.status != RVSIM_OK) {
+        diffs.push_back("status " + std::to_string(state.status) + ": " + state.error);
+        if (state.memory.empty()) return diffs; // Never ran
+    } else if (!state.finished) {
+        diffs.push_back("did not finish within " + std::to_string(test.max_cycles) + " cycles");
+    }
+    for (const CorpusExpect& e : test.expects) {
+        // Memory words and RV32 registers are read back sign-extended, so 0xffffffff means -1
+        int64_t expected = e.value;
+        if (e.key == EXPECT_MEM || (e.key == EXPECT_REG && test.xlen == 32)) expected = (int32_t)expected;
+        bool known;
+        int64_t actual = stateValue(state, e, known);
+        if (!known) diffs.push_back(keyName(e) + ": expected " + std::to_string(expected) + ", not a word of memory");
+        else if (actual != expected) diffs.push_back(keyName(e) + ": expected " + std::to_string(expected) + ", got " + std::to_string(actual));
+    }
+    return diffs;
+}
+
+void runCorpus(const std::vector<CorpusTest>& tests, unsigned int threads, std::vector<CorpusResult>& results) {
+    results.assign(tests.size(), CorpusResult());
+    std::atomic<size_t> next(0);
+
+    // Tests differ a lot in length, so workers take one at a time
+    auto worker = [&] {
+        for (size_t i = next++; i < tests.size(); i = next++) {
+            auto start = std::chrono::steady_clock::now();
+            runCorpusTest(tests[i], results[i].state);
+            results[i].diffs = diffCorpusState(tests[i], results[i].state);
+            results[i].seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        }
+    };
+
+#ifdef SIM_HAS_THREADS
+    if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+    threads = (unsigned int)std::min<size_t>(threads, std::max<size_t>(1, tests.size()));
+    std::vector<std::thread> pool;
+    for (unsigned int t = 1; t < threads; t++) pool.emplace_back(worker);
+    worker();
+    for (std::thread& t : pool) t.join();
+#else
+    (void)threads;
+    worker();
+#endif
+}
+
+std::vector<std::string> recordExpectations(const CorpusState& state) {
+    const size_t PER_LINE = 8;
+    std::vector<std::string> lines;
+    std::string line;
+    size_t count = 0;
+    auto add = [&](const std::string& pair) {
+        if (count++ % PER_LINE) line += "  ";
+        line += pair;
+        if (count % PER_LINE == 0) {
+            lines.push_back(line);
+            line.clear();
+        }
+    };
+    auto flush = [&] {
+        if (!line.empty()) lines.push_back(line);
+        line.clear();
+        count = 0;
+    };
+
+    for (int i = 1; i < 32; i++) {
+        if (state.regs[i] != 0) add("x" + std::to_string(i) + " = " + std::to_string(state.regs[i]));
+    }
+    flush();
+    for (size_t w = 0; w < state.memory.size(); w++) {
+        if (state.memory[w] != 0) add("mem[" + std::to_string(w * 4) + "] = " + std::to_string(state.memory[w]));
+    }
+    flush();
+    lines.push_back("pc = " + std::to_string(state.pc) + "  cycles = " + std::to_string(state.cycles) +
+                    "  instructions = " + std::to_string(state.instructions) + "  stalls = " + std::to_string(state.stalls) +
+                    "  halted = " + (state.halted ? "1" : "0") +
+                    (state.halted ? "  cause = " + std::to_string(state.cause) : ""));
+    if (state.itlb_hits + state.itlb_misses + state.dtlb_hits + state.dtlb_misses > 0) {
+        lines.push_back("itlb_hits = " + std::to_string(state.itlb_hits) + "  itlb_misses = " + std::to_string(state.itlb_misses) +
+                        "  dtlb_hits = " + std::to_string(state.dtlb_hits) + "  dtlb_misses = " + std::to_string(state.dtlb_misses) +
+                        "  walks = " + std::to_string(state.walks));
+    }
+    return lines;
+}
+
+static bool writeFile(const std::string& path, const std::string& text, std::string& error) {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out << text;
+    if (!out.good()) {
+        error = "cannot write " + path;
+        return false;
+    }
+    return true;
+}
+
+bool saveRecordedCorpus(const std::string& path, const std::vector<const CorpusTest*>& tests,
+                        const std::vector<const CorpusState*>& states, std::string& error) {
+    if (tests.size() == 1 && !tests[0]->expect_file.empty()) {
+        std::string text;
+        for (const std::string& line : recordExpectations(*states[0])) text += line + "\n";
+        return writeFile(tests[0]->expect_file, text, error);
+    }
+
+    std::string text;
+    if (!readFile(path, text)) {
+        error = "cannot read " + path;
+        return false;
+    }
+    std::vector<std::string> lines = splitLines(text);
+
+    // Section k runs from its header (line 1 of the file for a whole-file test) to the next header
+    std::vector<size_t> starts;
+    for (const CorpusTest* t : tests) starts.push_back(t->line ? t->line - 1 : 0);
+    starts.push_back(lines.size());
+
+    std::string out, rest;
+    for (size_t i = 0; i < starts[0]; i++) out += lines[i] + "\n";
+    for (size_t k = 0; k < tests.size(); k++) {
+        std::vector<std::string> kept;
+        for (size_t i = starts[k]; i < starts[k + 1]; i++) {
+            if (!isMarked(lines[i], '=', rest)) kept.push_back(lines[i]);
+        }
+        size_t last = kept.size();
+        while (last > 0 && kept[last - 1].find_first_not_of(" \t") == std::string::npos) last--;
+        for (size_t i = 0; i < last; i++) out += kept[i] + "\n";
+        for (const std::string& line : recordExpectations(*states[k])) out += "#= " + line + "\n";
+        for (size_t i = last; i < kept.size(); i++) out += kept[i] + "\n";
+    }
+    return writeFile(path, out, error);
+}
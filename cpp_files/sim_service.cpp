@@ -0,0 +1,173 @@
+#include "../hpp_files/sim_service.hpp"
+#include "../hpp_files/sim_threads.hpp"
+#include <algorithm>
+#include <cstring>
+
+const uint32_t PAGE_BYTES = 4096; // Page size behind rvsim_limits::max_pages
+
+rvsim_pool* SharedProgram::pool(const rvsim_limits& limits, uint32_t capacity) {
+    std::call_once(once, [&] {
+        status = rvsim_assemble(source.data(), source.size(), xlen, &program);
+        if (status == RVSIM_OK) status = rvsim_pool_create(program, 0, &limits, sizeof(limits), capacity, &sessions);
+        if (status != RVSIM_OK) error = rvsim_last_error();
+        source = std::string(); // Not needed once assembled
+    });
+    return sessions;
+}
+
+SimService::SimService(unsigned int threads, const ServiceLimits& limits)
+    : caps(limits), stopping(false), done_count(0)
+{
+    // Room for the largest allowed memory twice over: live pages and the reset image
+    uint32_t pages = (uint32_t)(((uint64_t)caps.max_mem_bytes + PAGE_BYTES - 1) / PAGE_BYTES);
+    session_limits.max_pages = 2 * std::max(pages, 1u);
+    session_limits.max_cycles = caps.max_cycles;
+    session_limits.max_mem_bytes = caps.max_mem_bytes;
+    session_limits.max_tlb_entries = 0; // Jobs cannot resize TLBs
+
+#ifdef SIM_HAS_THREADS // Otherwise there are no workers and submit() runs jobs inline
+    if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+    for (unsigned int i = 0; i < threads; i++) workers.emplace_back(&SimService::worker_main, this);
+#else
+    (void)threads;
+#endif
+}
+
+SimService::~SimService() {
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        stopping = true;
+    }
+    work_ready.notify_all();
+    for (std::thread& t : workers) t.join();
+}
+
+void SimService::submit(SimJob job, ResultFn done) {
+    Pending p;
+    p.job = std::move(job);
+    p.done = std::move(done);
+    p.queued = Clock::now();
+
+    if (workers.empty()) {
+        SimJobResult r;
+        run_job(p, r);
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            done_count++;
+        }
+        p.done(r);
+        return;
+    }
+
+    std::unique_lock<std::mutex> guard(lock);
+    space_ready.wait(guard, [this] { return queue.size() < caps.max_queued; });
+    queue.push_back(std::move(p));
+    guard.unlock();
+    work_ready.notify_one();
+}
+
+uint64_t SimService::completed() const {
+    std::lock_guard<std::mutex> guard(lock);
+    return done_count;
+}
+
+void SimService::worker_main() {
+    SimJobResult r;
+
+    for (;;) {
+        Pending p;
+        {
+            std::unique_lock<std::mutex> guard(lock);
+            work_ready.wait(guard, [this] { return stopping || !queue.empty(); });
+            if (queue.empty()) break; // Stopping and drained
+            p = std::move(queue.front());
+            queue.pop_front();
+        }
+        space_ready.notify_one();
+
+        run_job(p, r);
+        p.done(r);
+        p = Pending(); // Drop the program reference before waiting again
+
+        std::lock_guard<std::mutex> guard(lock);
+        done_count++;
+    }
+}
+
+void SimService::run_job(const Pending& p, SimJobResult& r) {
+    const SimJob& job = p.job;
+    Clock::time_point start = Clock::now();
+
+    r.id = job.id;
+    r.outcome = JOB_ERROR;
+    r.status = RVSIM_OK;
+    r.cycles = r.instructions = r.stall_cycles = 0;
+    r.queue_us = (uint32_t)std::chrono::duration_cast<std::chrono::microseconds>(start - p.queued).count();
+    r.run_us = 0;
+    std::memset(r.regs, 0, sizeof(r.regs));
+    r.memory.clear();
+    r.error.clear();
+
+    auto elapsed = [&] {
+        return (uint32_t)std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start).count();
+    };
+    auto fail = [&](int status, const std::string& message) {
+        r.outcome = JOB_ERROR;
+        r.status = status;
+        r.error = message;
+        r.run_us = elapsed();
+    };
+
+    if (!job.program) return fail(RVSIM_ERR_NOT_INITIALIZED, "No program");
+    rvsim_pool* pool = job.program->pool(session_limits, std::max(1u, thread_count()));
+    if (pool == nullptr) return fail(job.program->get_status(), job.program->get_error());
+
+    // At most one session per worker is in use, so the pool never runs dry
+    rvsim_session* s;
+    int status = rvsim_pool_acquire(pool, &s);
+    if (status != RVSIM_OK) return fail(status, rvsim_last_error());
+
+    if (job.mem_bytes) status = rvsim_set_mem_size(s, std::min(job.mem_bytes, caps.max_mem_bytes));
+    for (size_t i = 0; i < job.inits.size() && status == RVSIM_OK; i++) {
+        const JobInit& init = job.inits[i];
+        if (init.kind == INIT_REG) {
+            status = rvsim_set_reg(s, (int)init.where, init.value);
+        } else {
+            int32_t word = (int32_t)init.value;
+            status = rvsim_write_mem(s, init.where, &word, 4);
+        }
+    }
+    if (status != RVSIM_OK) {
+        fail(status, rvsim_last_error());
+        rvsim_pool_release(pool, s);
+        return;
+    }
+
+    // A limit stops the run part way; the state it reached is still reported
+    uint64_t max_cycles = job.max_cycles ? std::min(job.max_cycles, caps.max_cycles) : caps.max_cycles;
+    status = rvsim_run(s, max_cycles, nullptr);
+    if (status != RVSIM_OK) fail(status, rvsim_last_error());
+
+    rvsim_stats stats;
+    rvsim_get_stats(s, &stats, sizeof(stats));
+    r.cycles = stats.cycles;
+    r.instructions = stats.instructions;
+    r.stall_cycles = stats.stall_cycles;
+    for (int i = 0; i < 32; i++) r.regs[i] = rvsim_get_reg(s, i);
+    if (status == RVSIM_OK) {
+        if (rvsim_is_halted(s)) r.outcome = JOB_HALTED;
+        else if (rvsim_is_finished(s)) r.outcome = JOB_FINISHED;
+        else r.outcome = JOB_TIMEOUT;
+    }
+
+    uint32_t dump_len = std::min(job.dump_len, caps.max_dump_bytes);
+    if (dump_len > 0) {
+        r.memory.resize(dump_len);
+        if (rvsim_read_mem(s, job.dump_addr, r.memory.data(), dump_len) != RVSIM_OK) {
+            r.memory.clear();
+            if (r.error.empty()) r.error = rvsim_last_error(); // The run itself succeeded
+        }
+    }
+    rvsim_pool_release(pool, s);
+    r.run_us = elapsed();
+}
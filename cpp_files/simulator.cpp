@@ -1,6 +1,9 @@
 #include "../hpp_files/simulator.hpp"
+#include "../hpp_files/compressed.hpp"
+#include "../hpp_files/vector_kernels.hpp"
 #include <iostream>
 #include <cstring>
+#include <algorithm>
 
 // Opcode Constants
 #define OP_R_TYPE 0x33
@@ -8,15 +11,43 @@
 #define OP_LW     0x03
 #define OP_SW     0x23
 #define OP_BRANCH 0x63
+#define OP_FENCE  0x0F
+#define OP_V      0x57 // OP-V (vector arithmetic, vsetvli)
+#define OP_VL     0x07 // LOAD-FP (vle32.v)
+#define OP_VS     0x27 // STORE-FP (vse32.v)
 
-RISCV_Simulator::RISCV_Simulator(std::map<unsigned int, unsigned int>& imem) 
-    : inst_memory(imem) 
+#define FUNC3_FENCE_I 0x1
+
+// OP-V funct3 categories and funct6 codes
+#define FUNC3_OPIVV 0x0
+#define FUNC3_OPMVV 0x2
+#define FUNC3_OPIVI 0x3
+#define FUNC3_OPCFG 0x7
+#define FUNCT6_VADD    0x00 // OPIVV
+#define FUNCT6_VREDSUM 0x00 // OPMVV
+#define FUNCT6_VSLL    0x25 // OPIVV / OPIVI
+#define FUNCT6_VMUL    0x25 // OPMVV
+
+template <int XLEN, class Plugins>
+RISCV_SimulatorT<XLEN, Plugins>::RISCV_SimulatorT(std::map<unsigned int, unsigned int>& imem) 
+    : data_memory(DATA_MEMORY_SIZE), inst_memory(imem), mmu(data_memory)
 {
     std::memset(registers, 0, sizeof(registers));
-    std::memset(data_memory, 0, sizeof(data_memory));
     pc = INSTRUCTION_MEMORY_START; 
     cycle = 0;
     stall_pipeline = false;
+    halted = false;
+    halt_pending = false;
+    fetch_fault_pending = false;
+
+    unified_memory = false;
+    text_start = text_end = 0;
+    split_mem_limit = unified_mem_limit = DATA_MEMORY_SIZE;
+    code_writes = 0;
+
+    walk_stall = 0;
+    mtvec = 0;
+    mepc = mcause = mtval = 0;
     
     std::memset(&if_id, 0, sizeof(if_id));
     std::memset(&id_ex, 0, sizeof(id_ex));
@@ -27,9 +58,66 @@ RISCV_Simulator::RISCV_Simulator(std::map<unsigned int, unsigned int>& imem)
     id_ex_next = id_ex;
     ex_mem_next = ex_mem;
     mem_wb_next = mem_wb;
+
+    save_reset_point();
+}
+
+template <int XLEN, class Plugins>
+void RISCV_SimulatorT<XLEN, Plugins>::save_reset_point() {
+    std::memcpy(reset_registers, registers, sizeof(registers));
+    reset_pc = pc;
+    reset_memory.restore_from(data_memory);
+    reset_satp = mmu.get_satp();
+    reset_mtvec = mtvec;
+    reset_vlen = vector.vlen;
 }
 
-int32_t RISCV_Simulator::sign_extend(uint32_t inst, int type) {
+template <int XLEN, class Plugins>
+void RISCV_SimulatorT<XLEN, Plugins>::reset() {
+    // Decodes stay valid unless a store patched code since the reset point
+    if (code_writes > 0) decode_cache.flush();
+
+    std::memcpy(registers, reset_registers, sizeof(registers));
+    pc = reset_pc;
+    data_memory.restore_from(reset_memory);
+    // The image may predate switching unified mode on; put the text back
+    if (unified_memory) {
+        split_mem_limit = data_memory.limit();
+        map_text();
+        unified_mem_limit = data_memory.limit();
+    }
+    cycle = 0;
+    stall_pipeline = false;
+    halted = false;
+    halt_pending = false;
+    fetch_fault_pending = false;
+
+    walk_stall = 0;
+    mtvec = reset_mtvec;
+    mepc = mcause = mtval = 0;
+    mmu.set_satp(reset_satp); // Flushes both TLBs
+    mmu.walks = 0;
+    mmu.itlb.hits = mmu.itlb.misses = 0;
+    mmu.dtlb.hits = mmu.dtlb.misses = 0;
+    code_writes = 0;
+    plugins.on_reset();
+
+    std::memset(&if_id, 0, sizeof(if_id));
+    std::memset(&id_ex, 0, sizeof(id_ex));
+    std::memset(&ex_mem, 0, sizeof(ex_mem));
+    std::memset(&mem_wb, 0, sizeof(mem_wb));
+    if_id_next = if_id;
+    id_ex_next = id_ex;
+    ex_mem_next = ex_mem;
+    mem_wb_next = mem_wb;
+
+    vector.reset();
+    vector.set_vlen(reset_vlen);
+    delta.clear();
+}
+
+template <int XLEN, class Plugins>
+typename RISCV_SimulatorT<XLEN, Plugins>::sxlen_t RISCV_SimulatorT<XLEN, Plugins>::sign_extend(uint32_t inst, int type) {
     int32_t value = 0;
     if (type == 0) { // I-type
         value = (inst >> 20);
@@ -38,280 +126,830 @@ int32_t RISCV_Simulator::sign_extend(uint32_t inst, int type) {
         value = ((inst >> 25) << 5) | ((inst >> 7) & 0x1F);
         if (value & 0x800) value |= 0xFFFFF000;
     } else if (type == 2) { // B-type
-        value = ((inst >> 31) << 12) | ((inst & 0x7E000000) >> 20) | ((inst & 0xF00) >> 8) | ((inst & 0x80) >> 7); 
+        // imm[12|10:5] in [31:25], imm[4:1|11] in [11:7]; byte offset, bit 0 implied 0
+        value = ((inst >> 31) << 12) | (((inst >> 7) & 0x1) << 11) | (((inst >> 25) & 0x3F) << 5) | (((inst >> 8) & 0xF) << 1);
         value = (value << 19) >> 19;
     }
     return value;
 }
 
-void RISCV_Simulator::step() {
+/**
+ * Full decode of one instruction word into the fields the ID stage latches.
+ */
+template <int XLEN, class Plugins>
+void RISCV_SimulatorT<XLEN, Plugins>::decode(uint32_t inst, DecodedInst& d) {
+    d.IR = inst;
+    d.opcode = inst & 0x7F;
+    d.rd = (inst >> 7) & 0x1F;
+    d.func3 = (inst >> 12) & 0x07;
+    d.rs1 = (inst >> 15) & 0x1F;
+    d.rs2 = (inst >> 20) & 0x1F;
+    d.func7 = (inst >> 25) & 0x7F;
+
+    // Set control signals
+    bool is_vcfg = (d.opcode == OP_V && d.func3 == FUNC3_OPCFG);
+    bool is_varith = (d.opcode == OP_V && !is_vcfg);
+    bool reg_write = (d.opcode == OP_R_TYPE || d.opcode == OP_I_TYPE || d.opcode == OP_LW || is_vcfg);
+    d.ctrl = (reg_write ? CTRL_REG_WRITE : 0)
+           | (d.opcode == OP_LW ? CTRL_MEM_READ : 0)
+           | (d.opcode == OP_SW ? CTRL_MEM_WRITE : 0)
+           | (d.opcode == OP_BRANCH ? CTRL_BRANCH : 0);
+
+    // Sign extend immediate
+    if (d.opcode == OP_I_TYPE || d.opcode == OP_LW) {
+        d.IMM = sign_extend(inst, 0);
+    }
+    else if (d.opcode == OP_SW) {
+        d.IMM = sign_extend(inst, 1);
+    }
+    else if (d.opcode == OP_BRANCH) {
+        d.IMM = sign_extend(inst, 2);
+    }
+    else {
+        d.IMM = 0;
+    }
+
+    // Check if instruction needs rs1 or rs2
+    d.needs_rs1 = (d.opcode == OP_R_TYPE || d.opcode == OP_I_TYPE || 
+                   d.opcode == OP_LW || d.opcode == OP_SW || 
+                   d.opcode == OP_BRANCH ||
+                   d.opcode == OP_VL || d.opcode == OP_VS || is_vcfg);
+    d.needs_rs2 = (d.opcode == OP_R_TYPE || d.opcode == OP_SW || 
+                   d.opcode == OP_BRANCH);
+
+    // Vector register operands (vs1 = rs1 field, vs2 = rs2 field, vs3 = rd field)
+    if (is_varith || d.opcode == OP_VL) d.ctrl |= CTRL_VREG_WRITE;
+    d.needs_vs1 = is_varith && (d.func3 == FUNC3_OPIVV || d.func3 == FUNC3_OPMVV);
+    d.needs_vs2 = is_varith;
+    d.needs_vs3 = (d.opcode == OP_VS);
+}
+
+template <int XLEN, class Plugins>
+const DecodedInst& RISCV_SimulatorT<XLEN, Plugins>::decode_cached(uint32_t addr, uint32_t inst, bool& hit) {
+    const DecodedInst* cached = decode_cache.lookup(addr);
+    hit = (cached != nullptr);
+    if (hit) return *cached;
+
+    DecodedInst& d = decode_cache.slot(addr);
+    decode(inst, d);
+    d.tag = addr;
+    d.valid = true;
+    return d;
+}
+
+/**
+ * Unified address space: the text image is copied into data memory so
+ * loads/stores can reach it. Per-page "contains code" bits keep ordinary
+ * stores on the fast path. Switching back removes the text again, so a
+ * session can return to its after-create state.
+ */
+template <int XLEN, class Plugins>
+void RISCV_SimulatorT<XLEN, Plugins>::set_unified_memory(bool enable) {
+    if (enable == unified_memory) {
+        if (enable) map_text();
+        return;
+    }
+    unified_memory = enable;
+    if (enable) {
+        split_mem_limit = data_memory.limit();
+        map_text();
+        unified_mem_limit = data_memory.limit();
+        return;
+    }
+
+    // Back to split memories: the text bytes leave data memory, which shrinks
+    // to its size from before unless it was resized since
+    for (auto const& [addr, word] : inst_memory) {
+        uint32_t size = isCompressedEncoding(word) ? 2 : 4;
+        for (uint32_t i = 0; i < size; i++) data_memory.write8(addr + i, 0);
+    }
+    if (data_memory.limit() == unified_mem_limit) data_memory.set_limit(split_mem_limit);
+    code_pages.clear();
+    // Decodes of patched code must not outlive the code they came from
+    if (code_writes > 0) decode_cache.flush();
+}
+
+// Copies the text image into data memory, growing it to hold the text
+template <int XLEN, class Plugins>
+void RISCV_SimulatorT<XLEN, Plugins>::map_text() {
+    code_pages.clear();
+    text_start = inst_memory.empty() ? 0 : inst_memory.begin()->first;
+    text_end = text_start;
+    for (auto const& [addr, word] : inst_memory) {
+        uint32_t size = isCompressedEncoding(word) ? 2 : 4;
+        data_memory.write8(addr, word & 0xFF);
+        data_memory.write8(addr + 1, (word >> 8) & 0xFF);
+        if (size == 4) {
+            data_memory.write8(addr + 2, (word >> 16) & 0xFF);
+            data_memory.write8(addr + 3, (word >> 24) & 0xFF);
+        }
+        text_end = std::max(text_end, addr + size);
+
+        uint32_t page = addr >> CODE_PAGE_SHIFT;
+        if (page >= code_pages.size()) code_pages.resize(page + 1, false);
+        code_pages[page] = true;
+    }
+    if (data_memory.limit() < text_end) data_memory.set_limit(text_end);
+}
+
+// Drop predecoded entries for any instruction overlapping [addr, addr + len)
+template <int XLEN, class Plugins>
+void RISCV_SimulatorT<XLEN, Plugins>::invalidate_code(uint32_t addr, uint32_t len) {
+    code_writes++;
+    drop_decodes(addr, len);
+}
+
+template <int XLEN, class Plugins>
+void RISCV_SimulatorT<XLEN, Plugins>::drop_decodes(uint32_t addr, uint32_t len) {
+    uint32_t first = (addr >= 3) ? ((addr - 3) & ~1u) : 0;
+    for (uint32_t a = first; a < addr + len; a += 2) {
+        decode_cache.invalidate(a);
+    }
+}
+
+template <int XLEN, class Plugins>
+void RISCV_SimulatorT<XLEN, Plugins>::reload_code(uint32_t addr, uint32_t len) {
+    // Not a store: leaves code_writes alone, so reset() keeps the cache
+    drop_decodes(addr, len);
+    if (!unified_memory || len == 0) return;
+
+    // Each byte comes from whichever instruction now covers it, or 0 if none
+    // does (an instruction that shrank or was deleted)
+    for (uint32_t a = addr; a < addr + len; a++) {
+        uint8_t byte = 0;
+        auto it = inst_memory.upper_bound(a);
+        if (it != inst_memory.begin()) {
+            --it;
+            uint32_t size = isCompressedEncoding(it->second) ? 2 : 4;
+            if (a < it->first + size) byte = (it->second >> (8 * (a - it->first))) & 0xFF;
+        }
+        if (data_memory.limit() <= a) data_memory.set_limit(a + 1);
+        if (reset_memory.limit() <= a) reset_memory.set_limit(a + 1);
+        data_memory.write8(a, byte);
+        reset_memory.write8(a, byte);
+
+        uint32_t page = a >> CODE_PAGE_SHIFT;
+        if (page >= code_pages.size()) code_pages.resize(page + 1, false);
+        code_pages[page] = true;
+    }
+    delta.note_mem(addr, len);
+}
+
+template <int XLEN, class Plugins>
+bool RISCV_SimulatorT<XLEN, Plugins>::patch_reset_memory(uint32_t addr, const uint8_t* src, uint32_t len) {
+    if (!reset_memory.in_bounds(addr, len)) return false;
+    return reset_memory.write_block(addr, src, len);
+}
+
+template <int XLEN, class Plugins>
+bool RISCV_SimulatorT<XLEN, Plugins>::write_mem_block(uint32_t addr, const uint8_t* src, uint32_t len) {
+    if (!data_memory.in_bounds(addr, len)) return false;
+    bool ok = data_memory.write_block(addr, src, len);
+    delta.note_mem(addr, len);
+
+    // Host writes over code must drop stale decodes, like stores do
+    for (uint32_t page = addr >> CODE_PAGE_SHIFT; len > 0 && page <= (addr + len - 1) >> CODE_PAGE_SHIFT; page++) {
+        if (is_code(page << CODE_PAGE_SHIFT)) {
+            invalidate_code(addr, len);
+            break;
+        }
+    }
+    return ok;
+}
+
+template <int XLEN, class Plugins>
+void RISCV_SimulatorT<XLEN, Plugins>::load_data(const std::map<unsigned int, int32_t>& data) {
+    // Words are ordered by address: pack each contiguous run and write it
+    // once. Bytes past the end of memory are dropped, as with set_memory().
+    std::vector<uint8_t> run;
+    uint32_t run_start = 0;
+    auto flush = [&]() {
+        uint64_t limit = data_memory.limit();
+        if (run.empty() || run_start >= limit) return;
+        uint32_t len = (uint32_t)std::min<uint64_t>(run.size(), limit - run_start);
+        write_mem_block(run_start, run.data(), len);
+    };
+
+    for (auto const& [addr, val] : data) {
+        if (!run.empty() && addr != run_start + run.size()) {
+            flush();
+            run.clear();
+        }
+        if (run.empty()) run_start = addr;
+        for (int b = 0; b < 4; b++) run.push_back(((uint32_t)val >> (8 * b)) & 0xFF);
+    }
+    flush();
+}
+
+template <int XLEN, class Plugins>
+SimStats RISCV_SimulatorT<XLEN, Plugins>::get_stats() const {
+    SimStats s;
+    if constexpr (std::is_base_of<StatsCounter, Plugins>::value) s = plugins.StatsCounter::stats;
+    else std::memset(&s, 0, sizeof(s));
+    s.code_writes = code_writes;
+    s.itlb_hits   = mmu.itlb.hits;
+    s.itlb_misses = mmu.itlb.misses;
+    s.dtlb_hits   = mmu.dtlb.hits;
+    s.dtlb_misses = mmu.dtlb.misses;
+    s.page_walks  = mmu.walks;
+    return s;
+}
+
+/**
+ * Virtual to physical. RV64 has no Sv39 here: it runs bare on the same
+ * 32-bit physical space, and addresses above 4 GiB raise an access fault.
+ */
+template <int XLEN, class Plugins>
+uint32_t RISCV_SimulatorT<XLEN, Plugins>::translate(uxlen_t vaddr, AccessType type, uint32_t& paddr, unsigned int& walk_cycles) {
+    if constexpr (XLEN == 32) {
+        return mmu.translate(vaddr, type, paddr, walk_cycles);
+    } else {
+        walk_cycles = 0;
+        if (vaddr > 0xFFFFFFFFull) {
+            if (type == AccessType::Fetch) return CAUSE_FETCH_ACCESS;
+            return (type == AccessType::Load) ? CAUSE_LOAD_ACCESS : CAUSE_STORE_ACCESS;
+        }
+        paddr = (uint32_t)vaddr;
+        return 0;
+    }
+}
+
+/**
+ * Precise trap, taken from the EX stage: younger instructions in IF/ID and
+ * ID/EX are flushed and the faulting instruction does not reach MEM. With no
+ * handler the simulator halts once the older instructions in MEM and WB have
+ * retired (see the end of step()).
+ */
+template <int XLEN, class Plugins>
+void RISCV_SimulatorT<XLEN, Plugins>::take_trap(uint32_t cause, uxlen_t epc, uxlen_t tval) {
+    mcause = cause;
+    mepc = epc;
+    mtval = tval;
+
+    if_id_next = {};
+    id_ex_next = {};
+    ex_mem_next = {};
+    stall_pipeline = true;
+    fetch_fault_pending = false;
+
+    if (mtvec != 0) pc = mtvec;
+    else halt_pending = true;
+
+    FlushEvent<XLEN> ev = {};
+    ev.kind = FLUSH_TRAP;
+    ev.target = pc;
+    ev.cause = cause;
+    ev.epc = epc;
+    ev.tval = tval;
+    ev.halted = halt_pending;
+    plugins.on_flush(ev);
+}
+
+/**
+ * EX stage for vector instructions. Element loops run on host SIMD through
+ * the vector kernels; results go to the vector unit's EX/MEM staging buffer.
+ * A fault is left in ev for step() to take once the hooks have seen it.
+ */
+template <int XLEN, class Plugins>
+void RISCV_SimulatorT<XLEN, Plugins>::execute_vector(ExecEvent<XLEN>& ev) {
+    VecStage& out = vector.ex_mem_next();
+    uint32_t funct6 = id_ex.IR >> 26;
+
+    if (id_ex.opcode == OP_V && id_ex.func3 == FUNC3_OPCFG) {
+        // vsetvli rd, rs1, vtypei: rs1 = x0 asks for VLMAX (or keeps vl when rd = x0 too)
+        uint32_t zimm = (id_ex.IR >> 20) & 0x7FF;
+        bool use_vlmax = (id_ex.rs1 == 0 && id_ex.rd != 0);
+        bool keep_vl = (id_ex.rs1 == 0 && id_ex.rd == 0);
+        ex_mem_next.ALUOutput = vector.configure(zimm, (uint64_t)id_ex.A, keep_vl, use_vlmax);
+        ev.vl = vector.vl;
+        ev.vill = vector.vill;
+        return;
+    }
+
+    unsigned int vl = vector.vl;
+    ev.vl = vl;
+    ev.vill = vector.vill;
+    bool masked = ((id_ex.IR >> 25) & 0x1) == 0;
+    if (vector.vill || masked) {
+        ev.fault = CAUSE_ILLEGAL_INSTRUCTION;
+        ev.tval = id_ex.IR;
+        return;
+    }
+
+    out.vl = vl;
+    VectorOpClass op_class;
+
+    if (id_ex.opcode == OP_VL || id_ex.opcode == OP_VS) {
+        op_class = (id_ex.opcode == OP_VL) ? VOP_LOAD : VOP_STORE;
+        AccessType type = (id_ex.opcode == OP_VL) ? AccessType::Load : AccessType::Store;
+        uxlen_t vaddr = id_ex.A;
+        ex_mem_next.ALUOutput = vaddr;
+        out.pa = out.pa_next = 0;
+        out.split = vl;
+
+        if (vl > 0) {
+            // Unit-stride access spans at most two pages (vl * 4 <= 128 bytes)
+            unsigned int walk_cycles = 0;
+            uxlen_t fault_va = vaddr;
+            uint32_t cause = translate(vaddr, type, out.pa, walk_cycles);
+            uxlen_t last = vaddr + (uxlen_t)(vl * 4 - 1);
+            if (cause == 0 && mmu.enabled() && (last >> 12) != (vaddr >> 12)) {
+                unsigned int more_cycles = 0;
+                fault_va = (last >> 12) << 12;
+                out.split = (unsigned int)((fault_va - vaddr + 3) / 4);
+                cause = translate(fault_va, type, out.pa_next, more_cycles);
+                walk_cycles += more_cycles;
+            }
+            walk_stall += walk_cycles;
+            if (cause != 0) {
+                ev.fault = cause;
+                ev.tval = fault_va;
+                return;
+            }
+        }
+
+        // Store data is read here, once older vector writes have retired
+        if (id_ex.opcode == OP_VS) vector.write_stage(out, id_ex.rd, vl);
+    }
+    else {
+        const int32_t* vs1 = vector.vreg[id_ex.rs1];
+        const int32_t* vs2 = vector.vreg[id_ex.rs2];
+
+        if (id_ex.func3 == FUNC3_OPIVV && funct6 == FUNCT6_VADD) {
+            op_class = VOP_ADD;
+            vk_add_i32(out.data, vs2, vs1, vl);
+        }
+        else if (id_ex.func3 == FUNC3_OPMVV && funct6 == FUNCT6_VMUL) {
+            op_class = VOP_MUL;
+            vk_mul_i32(out.data, vs2, vs1, vl);
+        }
+        else if (id_ex.func3 == FUNC3_OPIVV && funct6 == FUNCT6_VSLL) {
+            op_class = VOP_SLL;
+            vk_sll_i32(out.data, vs2, vs1, vl);
+        }
+        else if (id_ex.func3 == FUNC3_OPIVI && funct6 == FUNCT6_VSLL) {
+            op_class = VOP_SLL;
+            vk_slli_i32(out.data, vs2, id_ex.rs1, vl); // uimm5 sits in the vs1 field
+        }
+        else if (id_ex.func3 == FUNC3_OPMVV && funct6 == FUNCT6_VREDSUM) {
+            op_class = VOP_REDSUM;
+            // vd[0] = vs1[0] + sum(vs2[0..vl-1]); nothing is written when vl = 0
+            out.vl = (vl > 0) ? 1 : 0;
+            out.data[0] = (int32_t)((uint32_t)vs1[0] + (uint32_t)vk_redsum_i32(vs2, vl));
+            ev.vresult = out.data[0];
+        }
+        else {
+            ev.fault = CAUSE_ILLEGAL_INSTRUCTION;
+            ev.tval = id_ex.IR;
+            return;
+        }
+    }
+
+    ev.vop = op_class;
+    ev.vlmax = vector.vlmax();
+}
+
+/**
+ * MEM stage for vector instructions: element-wise physical accesses for
+ * vle32/vse32, plain hand-off of the staged result for everything else.
+ */
+template <int XLEN, class Plugins>
+void RISCV_SimulatorT<XLEN, Plugins>::memory_vector(MemEvent<XLEN>& ev) {
+    uint32_t opcode = ex_mem.IR & 0x7F;
+    if (opcode != OP_VL && opcode != OP_VS) {
+        if (ex_mem.ctrl & CTRL_VREG_WRITE) vector.pass_through();
+        return;
+    }
+
+    const VecStage& in = vector.ex_mem();
+    unsigned int tail = in.vl - in.split;
+    bool ok = data_memory.in_bounds(in.pa, in.split * 4) &&
+              (tail == 0 || data_memory.in_bounds(in.pa_next, tail * 4));
+    ev.kind = (opcode == OP_VL) ? MEM_LOAD : MEM_STORE;
+    ev.vector = true;
+    ev.ok = ok;
+    ev.pa = in.pa;
+    ev.elements = in.vl;
+
+    if (opcode == OP_VL) {
+        VecStage& out = vector.mem_wb_next();
+        out.vl = in.vl;
+        for (unsigned int i = 0; i < in.vl; i++) {
+            uint32_t addr = (i < in.split) ? in.pa + 4 * i : in.pa_next + 4 * (i - in.split);
+            out.data[i] = ok ? (int32_t)data_memory.read32(addr) : 0;
+        }
+        return;
+    }
+
+    if (!ok) return;
+    for (unsigned int i = 0; i < in.vl; i++) {
+        uint32_t addr = (i < in.split) ? in.pa + 4 * i : in.pa_next + 4 * (i - in.split);
+        data_memory.write32(addr, (uint32_t)in.data[i]);
+        delta.note_mem(addr, 4);
+        if (is_code(addr)) {
+            invalidate_code(addr, 4);
+            ev.hit_code = true;
+        }
+    }
+}
+
+template <int XLEN, class Plugins>
+void RISCV_SimulatorT<XLEN, Plugins>::step() {
+    if (halted) return;
+
     cycle++;
-    
-    std::cout << "\n========== CYCLE " << cycle << " ==========\n";
+    delta.cycles++;
+    uxlen_t pc_before = pc;
+    plugins.on_cycle(cycle);
+
+    // A page-table walk freezes the whole pipeline until it completes
+    if (walk_stall > 0) {
+        walk_stall--;
+        StallEvent ev = {};
+        ev.kind = STALL_WALK;
+        ev.walk_left = walk_stall;
+        plugins.on_stall(ev);
+        plugins.on_cycle_end();
+        return;
+    }
 
     // =================================================================
     // 1. WRITE BACK (WB) STAGE
     // =================================================================
-    if (mem_wb.RegWrite && mem_wb.rd != 0) {
-        int32_t data = (mem_wb.IR & 0x7F) == OP_LW ? mem_wb.LMD : mem_wb.ALUOutput;
-        registers[mem_wb.rd] = data;
-        registers[0] = 0; // Hardwire x0
-        
-        std::cout << "[WB] Wrote " << data << " to x" << (int)mem_wb.rd << "\n";
-    } else if (mem_wb.IR != 0) {
-        std::cout << "[WB] No write back (NOP or x0)\n";
+    if (mem_wb.IR != 0) {
+        WritebackEvent<XLEN> ev = {};
+        ev.PC = mem_wb.PC;
+        ev.IR = mem_wb.IR;
+        ev.rd = mem_wb.rd;
+        ev.kind = WB_NONE; // NOP or x0
+
+        if ((mem_wb.ctrl & CTRL_REG_WRITE) && mem_wb.rd != 0) {
+            sxlen_t data = (mem_wb.IR & 0x7F) == OP_LW ? mem_wb.LMD : mem_wb.ALUOutput;
+            if (registers[mem_wb.rd] != data) delta.regs |= 1u << mem_wb.rd;
+            registers[mem_wb.rd] = data;
+            registers[0] = 0; // Hardwire x0
+            ev.kind = WB_REG;
+            ev.value = data;
+        } else if (mem_wb.ctrl & CTRL_VREG_WRITE) {
+            const VecStage& result = vector.mem_wb();
+            vector.write(mem_wb.rd, result.data, result.vl);
+            delta.vregs |= 1u << mem_wb.rd;
+            ev.kind = WB_VREG;
+            ev.elements = result.vl;
+        }
+        plugins.on_writeback(ev);
     }
 
     // =================================================================
     // 2. MEMORY (MEM) STAGE
     // =================================================================
-    mem_wb_next.IR = ex_mem.IR;
+    mem_wb_next.PC = ex_mem.PC;
     mem_wb_next.ALUOutput = ex_mem.ALUOutput;
-    mem_wb_next.rd = ex_mem.rd;
-    mem_wb_next.RegWrite = ex_mem.RegWrite;
     mem_wb_next.LMD = 0;
+    mem_wb_next.IR = ex_mem.IR;
+    mem_wb_next.rd = ex_mem.rd;
+    mem_wb_next.ctrl = ex_mem.ctrl;
 
     if (ex_mem.IR != 0) {
-        // HANDLE LOAD WORD (Read 4 Bytes)
-        if (ex_mem.MemRead) { 
-            if (ex_mem.ALUOutput >= 0 && ex_mem.ALUOutput <= 124) {
-                uint32_t b0 = data_memory[ex_mem.ALUOutput];
-                uint32_t b1 = data_memory[ex_mem.ALUOutput + 1];
-                uint32_t b2 = data_memory[ex_mem.ALUOutput + 2];
-                uint32_t b3 = data_memory[ex_mem.ALUOutput + 3];
-                
-                mem_wb_next.LMD = b0 | (b1 << 8) | (b2 << 16) | (b3 << 24);
-                
-                std::cout << "[MEM] LW: Read " << mem_wb_next.LMD << " from addr " << ex_mem.ALUOutput << "\n";
-            } else {
-                std::cout << "[MEM] LW ERROR: Address " << ex_mem.ALUOutput << " out of bounds\n";
-            }
+        MemEvent<XLEN> ev = {};
+        ev.PC = ex_mem.PC;
+        ev.IR = ex_mem.IR;
+        ev.addr = ex_mem.ALUOutput;
+        ev.pa = ex_mem.PA;
+        ev.kind = MEM_NONE;
+
+        uint32_t mem_opcode = ex_mem.IR & 0x7F;
+        if ((ex_mem.ctrl & CTRL_VREG_WRITE) || mem_opcode == OP_VS) {
+            memory_vector(ev);
         }
-        
-        // HANDLE STORE WORD (Write 4 Bytes)
-        if (ex_mem.MemWrite) { 
-            if (ex_mem.ALUOutput >= 0 && ex_mem.ALUOutput <= 124) {
-                uint32_t val = ex_mem.B;
-                
-                data_memory[ex_mem.ALUOutput]     = val & 0xFF;
-                data_memory[ex_mem.ALUOutput + 1] = (val >> 8) & 0xFF;
-                data_memory[ex_mem.ALUOutput + 2] = (val >> 16) & 0xFF;
-                data_memory[ex_mem.ALUOutput + 3] = (val >> 24) & 0xFF;
-                
-                std::cout << "[MEM] SW: Wrote " << val << " to addr " << ex_mem.ALUOutput << "\n";
-            } else {
-                std::cout << "[MEM] SW ERROR: Address " << ex_mem.ALUOutput << " out of bounds\n";
+        else {
+            // LW/SW move 4 bytes; LD/SD (funct3 = 011, RV64 only) move 8
+            uint32_t width = (XLEN == 64 && ((ex_mem.IR >> 12) & 0x7) == 0x3) ? 8 : 4;
+            ev.ok = data_memory.in_bounds(ex_mem.PA, width);
+
+            // HANDLE LOAD WORD (Read 4 Bytes)
+            if ((ex_mem.ctrl & CTRL_MEM_READ) && ev.ok) {
+                if (width == 8) {
+                    uint64_t lo = data_memory.read32(ex_mem.PA);
+                    uint64_t hi = data_memory.read32(ex_mem.PA + 4);
+                    mem_wb_next.LMD = (sxlen_t)(lo | (hi << 32));
+                } else {
+                    mem_wb_next.LMD = (int32_t)data_memory.read32(ex_mem.PA); // Sign-extends on RV64
+                }
+            }
+
+            // HANDLE STORE WORD (Write 4 Bytes)
+            if ((ex_mem.ctrl & CTRL_MEM_WRITE) && ev.ok) {
+                uxlen_t val = ex_mem.B;
+
+                data_memory.write32(ex_mem.PA, (uint32_t)val);
+                if (width == 8) data_memory.write32(ex_mem.PA + 4, (uint32_t)((uint64_t)val >> 32));
+                delta.note_mem(ex_mem.PA, width);
+                if (is_code(ex_mem.PA)) {
+                    invalidate_code(ex_mem.PA, width);
+                    ev.hit_code = true;
+                }
+            }
+
+            if (ex_mem.ctrl & CTRL_MEM_READ) {
+                ev.kind = MEM_LOAD;
+                ev.value = mem_wb_next.LMD;
+            } else if (ex_mem.ctrl & CTRL_MEM_WRITE) {
+                ev.kind = MEM_STORE;
+                ev.value = ex_mem.B;
             }
         }
-        
-        if (!ex_mem.MemRead && !ex_mem.MemWrite) {
-            std::cout << "[MEM] No memory operation\n";
-        }
+        plugins.on_mem_access(ev);
     }
 
     // =================================================================
     // 3. EXECUTE (EX) STAGE
     // =================================================================
-    ex_mem_next.IR = id_ex.IR;
+    ex_mem_next.PC = id_ex.PC;
     ex_mem_next.B = id_ex.B;
-    ex_mem_next.rd = id_ex.rd;
-    ex_mem_next.RegWrite = id_ex.RegWrite;
-    ex_mem_next.MemRead = id_ex.MemRead;
-    ex_mem_next.MemWrite = id_ex.MemWrite;
-    ex_mem_next.Branch = id_ex.Branch;
-    ex_mem_next.cond = false;
     ex_mem_next.ALUOutput = 0;
+    ex_mem_next.IR = id_ex.IR;
+    ex_mem_next.PA = 0;
+    ex_mem_next.rd = id_ex.rd;
+    ex_mem_next.ctrl = id_ex.ctrl; // CTRL_COND is added by a taken compare
+    bool fence_i = false;
+    bool trapped = false;
+
+    if (id_ex.trap != 0) {
+        // Instruction fetch faulted; the trap becomes precise here. An illegal
+        // RVC encoding reports mtval 0, which the privileged spec allows
+        take_trap(id_ex.trap, id_ex.PC, id_ex.trap == CAUSE_ILLEGAL_INSTRUCTION ? 0 : id_ex.PC);
+        trapped = true;
+    }
+    else if (id_ex.IR != 0) {
+        sxlen_t op1 = id_ex.A;
+        sxlen_t op2 = (id_ex.opcode == OP_I_TYPE || id_ex.opcode == OP_LW || id_ex.opcode == OP_SW) ? id_ex.IMM : id_ex.B;
+
+        ExecEvent<XLEN> ev = {};
+        ev.PC = id_ex.PC;
+        ev.NPC = id_ex.NPC;
+        ev.IR = id_ex.IR;
+        ev.opcode = id_ex.opcode;
+        ev.func3 = id_ex.func3;
+        ev.func7 = id_ex.func7;
+        ev.rd = id_ex.rd;
+        ev.rs1 = id_ex.rs1;
+        ev.rs2 = id_ex.rs2;
+        ev.op1 = op1;
+        ev.op2 = op2;
+        ev.vop = -1;
 
-    if (id_ex.IR != 0) {
-        int32_t op1 = id_ex.A;
-        int32_t op2 = (id_ex.opcode == OP_I_TYPE || id_ex.opcode == OP_LW || id_ex.opcode == OP_SW) ? id_ex.IMM : id_ex.B;
-        
-        std::cout << "[EX] Opcode=0x" << std::hex << (int)id_ex.opcode << std::dec;
-        
         if (id_ex.opcode == OP_R_TYPE) {
             if (id_ex.func3 == 0x0) { // ADD, SUB
-                if (id_ex.func7 == 0x20) {
-                    ex_mem_next.ALUOutput = op1 - op2;
-                    std::cout << " SUB: " << op1 << " - " << op2 << " = " << ex_mem_next.ALUOutput << "\n";
-                } else {
-                    ex_mem_next.ALUOutput = op1 + op2;
-                    std::cout << " ADD: " << op1 << " + " << op2 << " = " << ex_mem_next.ALUOutput << "\n";
-                }
-            }
-            else if (id_ex.func3 == 0x1) {
-                ex_mem_next.ALUOutput = op1 << (op2 & 0x1F);
-                std::cout << " SLL: " << op1 << " << " << (op2 & 0x1F) << " = " << ex_mem_next.ALUOutput << "\n";
-            }
-            else if (id_ex.func3 == 0x2) {
-                ex_mem_next.ALUOutput = (op1 < op2) ? 1 : 0;
-                std::cout << " SLT: " << op1 << " < " << op2 << " = " << ex_mem_next.ALUOutput << "\n";
+                if (id_ex.func7 == 0x20) ex_mem_next.ALUOutput = op1 - op2;
+                else                     ex_mem_next.ALUOutput = op1 + op2;
             }
-        } 
+            else if (id_ex.func3 == 0x1) ex_mem_next.ALUOutput = op1 << (op2 & XlenTraits<XLEN>::SHAMT_MASK); // SLL
+            else if (id_ex.func3 == 0x2) ex_mem_next.ALUOutput = (op1 < op2) ? 1 : 0;                          // SLT
+        }
         else if (id_ex.opcode == OP_I_TYPE) {
-             if (id_ex.func3 == 0x0) {
-                 ex_mem_next.ALUOutput = op1 + op2;
-                 std::cout << " ADDI: " << op1 << " + " << op2 << " = " << ex_mem_next.ALUOutput << "\n";
-             }
-             else if (id_ex.func3 == 0x1) {
-                 ex_mem_next.ALUOutput = op1 << (op2 & 0x1F);
-                 std::cout << " SLLI: " << op1 << " << " << (op2 & 0x1F) << " = " << ex_mem_next.ALUOutput << "\n";
-             }
+            if (id_ex.func3 == 0x0)      ex_mem_next.ALUOutput = op1 + op2;                                    // ADDI
+            else if (id_ex.func3 == 0x1) ex_mem_next.ALUOutput = op1 << (op2 & XlenTraits<XLEN>::SHAMT_MASK); // SLLI
         }
         else if (id_ex.opcode == OP_LW || id_ex.opcode == OP_SW) {
             ex_mem_next.ALUOutput = op1 + op2;
-            std::cout << " ADDR: " << op1 << " + " << op2 << " = " << ex_mem_next.ALUOutput << "\n";
+
+            // Address translation sits between EX and MEM
+            uxlen_t vaddr = (uxlen_t)ex_mem_next.ALUOutput;
+            AccessType type = (id_ex.opcode == OP_LW) ? AccessType::Load : AccessType::Store;
+            ev.fault = translate(vaddr, type, ex_mem_next.PA, ev.walk_cycles);
+            ev.tval = vaddr;
+            ev.pa = ex_mem_next.PA;
+            ev.translated = mmu.enabled();
+            walk_stall += ev.walk_cycles;
+        }
+        else if (id_ex.opcode == OP_V || id_ex.opcode == OP_VL || id_ex.opcode == OP_VS) {
+            execute_vector(ev);
+        }
+        else if (id_ex.opcode == OP_FENCE && id_ex.func3 == FUNC3_FENCE_I) {
+            // Older stores have completed in MEM; refetch everything younger
+            decode_cache.flush();
+            fence_i = true;
         }
         else if (id_ex.opcode == OP_BRANCH) {
-            if (id_ex.func3 == 0x0) {
-                ex_mem_next.cond = (op1 == op2);
-                std::cout << " BEQ: " << op1 << " == " << op2 << " ? " << ex_mem_next.cond << "\n";
-            }
-            else if (id_ex.func3 == 0x4) {
-                ex_mem_next.cond = (op1 < op2);
-                std::cout << " BLT: " << op1 << " < " << op2 << " ? " << ex_mem_next.cond << "\n";
-            }
+            if (id_ex.func3 == 0x0)      ev.cond = (op1 == op2); // BEQ
+            else if (id_ex.func3 == 0x4) ev.cond = (op1 < op2);  // BLT
+            ex_mem_next.ctrl |= ev.cond ? CTRL_COND : 0;
+        }
+
+        ev.result = ex_mem_next.ALUOutput;
+        plugins.on_execute(ev);
+        if (ev.fault != 0) {
+            take_trap(ev.fault, id_ex.PC, ev.tval);
+            trapped = true;
         }
     }
 
     // =================================================================
     // CONTROL HAZARD: Pipeline Freeze on Branch Taken
     // =================================================================
-    bool branch_taken = ex_mem_next.Branch && ex_mem_next.cond;
-    if (branch_taken) {
-        // Calculate branch target
-        uint32_t branch_target = id_ex.NPC + (id_ex.IMM << 1) - 4;
-        pc = branch_target;
-        
-        std::cout << "[CONTROL HAZARD] Branch taken! Flushing IF/ID and ID/EX. New PC: 0x" 
-                  << std::hex << pc << std::dec << "\n";
-        
+    const uint8_t TAKEN = CTRL_BRANCH | CTRL_COND;
+    bool branch_taken = (ex_mem_next.ctrl & TAKEN) == TAKEN;
+    if (branch_taken || fence_i) {
+        fetch_fault_pending = false; // A faulting fetch on the wrong path is discarded
+
+        // Branch target is PC-relative (NPC is PC+2 for RVC); FENCE.I refetches the next instruction
+        pc = branch_taken ? id_ex.PC + id_ex.IMM : id_ex.NPC;
+
+        FlushEvent<XLEN> ev = {};
+        ev.kind = branch_taken ? FLUSH_BRANCH : FLUSH_FENCE_I;
+        ev.target = pc;
+        plugins.on_flush(ev);
+
         // Flush the two instructions that were incorrectly fetched
-        std::memset(&if_id_next, 0, sizeof(if_id_next));
-        std::memset(&id_ex_next, 0, sizeof(id_ex_next));
-        stall_pipeline = true; 
+        if_id_next = {};
+        id_ex_next = {};
+        stall_pipeline = true;
     }
 
     // =================================================================
     // 4. DECODE (ID) STAGE - DATA HAZARD DETECTION (NO FORWARDING)
     // =================================================================
-    id_ex_next.IR = if_id.IR;
-    id_ex_next.NPC = if_id.NPC;
-    
-    bool data_hazard_detected = false;
-    
+    if (!trapped && !branch_taken && !fence_i) { // A flushed IF/ID instruction never reaches EX
+        id_ex_next.IR = if_id.IR;
+        id_ex_next.NPC = if_id.NPC;
+        id_ex_next.PC = if_id.PC;
+    }
+
     if (if_id.IR != 0 && !stall_pipeline) {
         uint32_t inst = if_id.IR;
-        id_ex_next.opcode = inst & 0x7F;
-        id_ex_next.rd = (inst >> 7) & 0x1F;
-        id_ex_next.func3 = (inst >> 12) & 0x07;
-        uint8_t rs1 = (inst >> 15) & 0x1F;
-        uint8_t rs2 = (inst >> 20) & 0x1F;
-        id_ex_next.func7 = (inst >> 25) & 0x7F;
+        bool cache_hit;
+        const DecodedInst& d = decode_cached(if_id.PA, inst, cache_hit);
 
+        uint8_t rs1 = d.rs1;
+        uint8_t rs2 = d.rs2;
+        id_ex_next.opcode = d.opcode;
+        id_ex_next.func3 = d.func3;
+        id_ex_next.func7 = d.func7;
+        id_ex_next.rd = d.rd;
         id_ex_next.rs1 = rs1;
         id_ex_next.rs2 = rs2;
 
-        // Set control signals
-        id_ex_next.RegWrite = (id_ex_next.opcode == OP_R_TYPE || id_ex_next.opcode == OP_I_TYPE || id_ex_next.opcode == OP_LW);
-        id_ex_next.MemRead  = (id_ex_next.opcode == OP_LW);
-        id_ex_next.MemWrite = (id_ex_next.opcode == OP_SW);
-        id_ex_next.Branch   = (id_ex_next.opcode == OP_BRANCH);
+        // Control signals and sign-extended immediate
+        id_ex_next.ctrl = d.ctrl;
+        id_ex_next.IMM  = d.IMM;
 
-        // Sign extend immediate
-        if (id_ex_next.opcode == OP_I_TYPE || id_ex_next.opcode == OP_LW) {
-            id_ex_next.IMM = sign_extend(inst, 0);
-        }
-        else if (id_ex_next.opcode == OP_SW) {
-            id_ex_next.IMM = sign_extend(inst, 1);
-        }
-        else if (id_ex_next.opcode == OP_BRANCH) {
-            id_ex_next.IMM = sign_extend(inst, 2);
-        }
-        else {
-            id_ex_next.IMM = 0;
-        }
+        DecodeEvent<XLEN> ev = {};
+        ev.PC = if_id.PC;
+        ev.IR = inst;
+        ev.rs1 = rs1;
+        ev.rs2 = rs2;
+        ev.cache_hit = cache_hit;
 
         // =================================================================
         // DATA HAZARD DETECTION: NO FORWARDING - Must stall until data is written back
         // =================================================================
-        // Check if current instruction needs rs1 or rs2
-        bool needs_rs1 = (id_ex_next.opcode == OP_R_TYPE || id_ex_next.opcode == OP_I_TYPE || 
-                          id_ex_next.opcode == OP_LW || id_ex_next.opcode == OP_SW || 
-                          id_ex_next.opcode == OP_BRANCH);
-        bool needs_rs2 = (id_ex_next.opcode == OP_R_TYPE || id_ex_next.opcode == OP_SW || 
-                          id_ex_next.opcode == OP_BRANCH);
-
-        std::cout << "[ID] Decoding IR=0x" << std::hex << inst << std::dec 
-                  << " rs1=x" << (int)rs1 << " rs2=x" << (int)rs2 << "\n";
-
-        // Check for RAW hazards in EX stage (1 cycle away)
-        if (id_ex.RegWrite && id_ex.rd != 0) {
-            if ((needs_rs1 && id_ex.rd == rs1) || (needs_rs2 && id_ex.rd == rs2)) {
-                data_hazard_detected = true;
-                std::cout << "[DATA HAZARD] RAW detected with EX stage (rd=x" << (int)id_ex.rd << ")\n";
-            }
-        }
-
-        // Check for RAW hazards in MEM stage (2 cycles away)
-        if (ex_mem.RegWrite && ex_mem.rd != 0) {
-            if ((needs_rs1 && ex_mem.rd == rs1) || (needs_rs2 && ex_mem.rd == rs2)) {
-                data_hazard_detected = true;
-                std::cout << "[DATA HAZARD] RAW detected with MEM stage (rd=x" << (int)ex_mem.rd << ")\n";
-            }
-        }
+        // RAW hazards as register bitmasks: what this instruction reads
+        // against what each older instruction will write back (x0 never)
+        uint32_t reads = (d.needs_rs1 ? 1u << rs1 : 0) | (d.needs_rs2 ? 1u << rs2 : 0);
+        auto writes = [](uint8_t ctrl, uint8_t rd) -> uint32_t {
+            return (ctrl & CTRL_REG_WRITE) ? (1u << rd) & ~1u : 0;
+        };
+        uint32_t ex_hit  = reads & writes(id_ex.ctrl, id_ex.rd);   // EX stage (1 cycle away)
+        uint32_t mem_hit = reads & writes(ex_mem.ctrl, ex_mem.rd); // MEM stage (2 cycles away)
+        uint32_t wb_hit  = reads & writes(mem_wb.ctrl, mem_wb.rd); // WB stage (3 cycles away)
 
-        // Check for RAW hazards in WB stage (3 cycles away)
-        if (mem_wb.RegWrite && mem_wb.rd != 0) {
-            if ((needs_rs1 && mem_wb.rd == rs1) || (needs_rs2 && mem_wb.rd == rs2)) {
-                data_hazard_detected = true;
-                std::cout << "[DATA HAZARD] RAW detected with WB stage (rd=x" << (int)mem_wb.rd << ")\n";
-            }
-        }
+        // Vector RAW hazards: vector results are written to the register file in WB
+        uint32_t vreads = (d.needs_vs1 ? 1u << d.rs1 : 0) | (d.needs_vs2 ? 1u << d.rs2 : 0) | (d.needs_vs3 ? 1u << d.rd : 0);
+        auto vwrites = [](uint8_t ctrl, uint8_t rd) -> uint32_t {
+            return (ctrl & CTRL_VREG_WRITE) ? 1u << rd : 0;
+        };
+        bool vector_hit = (vreads & (vwrites(id_ex.ctrl, id_ex.rd) | vwrites(ex_mem.ctrl, ex_mem.rd) | vwrites(mem_wb.ctrl, mem_wb.rd))) != 0;
 
         // If hazard detected, insert bubble (NOP) and stall
-        if (data_hazard_detected) {
-            std::cout << "[STALL] Inserting bubble, keeping IF/ID unchanged\n";
-            std::memset(&id_ex_next, 0, sizeof(id_ex_next)); // Insert NOP
+        if ((ex_hit | mem_hit | wb_hit) != 0 || vector_hit) {
+            ev.stalled = true;
+            plugins.on_decode(ev);
+
+            StallEvent stall = {};
+            stall.kind = STALL_DATA;
+            stall.ex_hit = ex_hit;
+            stall.mem_hit = mem_hit;
+            stall.wb_hit = wb_hit;
+            stall.ex_rd = id_ex.rd;
+            stall.mem_rd = ex_mem.rd;
+            stall.wb_rd = mem_wb.rd;
+            stall.vector = vector_hit;
+            plugins.on_stall(stall);
+
+            id_ex_next = {}; // Insert NOP
             if_id_next = if_id; // Keep IF/ID unchanged
             stall_pipeline = true;
         } else {
             // No hazard, read register values
             id_ex_next.A = registers[rs1];
             id_ex_next.B = registers[rs2];
-            std::cout << "[ID] Read A=x" << (int)rs1 << "=" << id_ex_next.A 
-                      << ", B=x" << (int)rs2 << "=" << id_ex_next.B << "\n";
+            ev.A = id_ex_next.A;
+            ev.B = id_ex_next.B;
+            plugins.on_decode(ev);
         }
     } else if (if_id.IR == 0) {
-        std::cout << "[ID] Bubble (NOP)\n";
-        std::memset(&id_ex_next, 0, sizeof(id_ex_next));
+        DecodeEvent<XLEN> ev = {}; // Bubble
+        ev.PC = if_id.PC;
+        plugins.on_decode(ev);
+        id_ex_next = {};
+        if (if_id.trap != 0 && !stall_pipeline) {
+            id_ex_next.trap = if_id.trap;
+            id_ex_next.PC = if_id.PC;
+        }
     }
 
     // =================================================================
     // 5. FETCH (IF) STAGE
     // =================================================================
-    if (!stall_pipeline) {
-        if (inst_memory.count(pc)) {
-            if_id_next.IR = inst_memory[pc];
+    FetchEvent<XLEN> fetch = {};
+    fetch.PC = pc;
+    if (!stall_pipeline && halt_pending) {
+        fetch.kind = FETCH_STALLED; // Draining towards a halt
+        if_id_next = {};
+    } else if (!stall_pipeline && fetch_fault_pending) {
+        fetch.kind = FETCH_WAIT;
+        if_id_next = {};
+    } else if (!stall_pipeline) {
+        uint32_t fetch_pa = 0;
+        unsigned int walk_cycles = 0;
+        uint32_t cause = translate(pc, AccessType::Fetch, fetch_pa, walk_cycles);
+        walk_stall += walk_cycles;
+
+        if (cause != 0) {
+            fetch.kind = FETCH_FAULT;
+            fetch.cause = cause;
+            if_id_next = {};
             if_id_next.PC = pc;
-            if_id_next.NPC = pc + 4;
-            std::cout << "[IF] Fetched IR=0x" << std::hex << if_id_next.IR << " from PC=0x" << pc << std::dec << "\n";
-            pc += 4;
+            if_id_next.trap = cause;
+            fetch_fault_pending = true;
+        } else if (unified_memory ? (fetch_pa >= text_start && fetch_pa < text_end) : inst_memory.count(fetch_pa) != 0) {
+            // Unified: whatever the text bytes hold now, so a patch may change instruction sizes
+            uint32_t raw = unified_memory ? data_memory.read32(fetch_pa) : inst_memory[fetch_pa];
+            uint32_t size = 4;
+            uint32_t inst = raw;
+
+            // Mixed 16/32-bit stream: low bits != 11 mark an RVC encoding
+            if (isCompressedEncoding(raw)) {
+                size = 2;
+                inst = expandCompressed(raw & 0xFFFF);
+            }
+
+            fetch.raw = raw;
+            fetch.size = size;
+            if (inst == 0) {
+                // Unsupported or all-zero RVC: an illegal instruction, taken from EX like a fetch fault
+                fetch.kind = FETCH_FAULT;
+                fetch.cause = CAUSE_ILLEGAL_INSTRUCTION;
+                if_id_next = {};
+                if_id_next.PC = pc;
+                if_id_next.trap = CAUSE_ILLEGAL_INSTRUCTION;
+                fetch_fault_pending = true;
+            } else {
+                if_id_next.IR = inst;
+                if_id_next.PC = pc;
+                if_id_next.PA = fetch_pa;
+                if_id_next.NPC = pc + size;
+                if_id_next.trap = 0;
+                fetch.kind = FETCH_OK;
+                fetch.IR = inst;
+                pc += size;
+            }
         } else {
-            std::cout << "[IF] No instruction at PC=0x" << std::hex << pc << std::dec << " (End of program)\n";
+            fetch.kind = FETCH_END;
             if_id_next.IR = 0;
         }
     } else {
-        std::cout << "[IF] Pipeline stalled (not fetching)\n";
+        fetch.kind = FETCH_STALLED;
         stall_pipeline = false; // Reset stall flag for next cycle
     }
+    plugins.on_fetch(fetch);
 
     // =================================================================
     // UPDATE PIPELINE REGISTERS
     // =================================================================
+    if (mem_wb != mem_wb_next) delta.latches |= DELTA_MEM_WB;
+    if (ex_mem != ex_mem_next) delta.latches |= DELTA_EX_MEM;
+    if (id_ex != id_ex_next)   delta.latches |= DELTA_ID_EX;
+    if (if_id != if_id_next)   delta.latches |= DELTA_IF_ID;
+    if (pc != pc_before) delta.pc = true;
+
     mem_wb = mem_wb_next;
     ex_mem = ex_mem_next;
     id_ex  = id_ex_next;
     if_id  = if_id_next;
-    
-    std::cout << "========================================\n";
-}
\ No newline at end of file
+    vector.advance();
+
+    // A trap with no handler halts once nothing older than it is left to retire
+    if (halt_pending && !ex_mem.IR && !mem_wb.IR) halted = true;
+
+    plugins.on_cycle_end();
+}
+
+// Every plugin set a simulator is built with needs its instantiation here
+template class RISCV_SimulatorT<32, DefaultPlugins>;
+template class RISCV_SimulatorT<64, DefaultPlugins>;
+template class RISCV_SimulatorT<32, StatsPlugins>;
+template class RISCV_SimulatorT<64, StatsPlugins>;
+template class RISCV_SimulatorT<32, NoPlugins>;
+template class RISCV_SimulatorT<64, NoPlugins>;
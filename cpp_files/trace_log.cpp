@@ -0,0 +1,236 @@
+#include "../hpp_files/trace_log.hpp"
+#include "../hpp_files/mmu.hpp"
+#include "../hpp_files/vector_kernels.hpp"
+#include <iostream>
+
+// Opcode Constants
+#define OP_R_TYPE 0x33
+#define OP_I_TYPE 0x13
+#define OP_LW     0x03
+#define OP_SW     0x23
+#define OP_BRANCH 0x63
+#define OP_FENCE  0x0F
+#define OP_V      0x57
+#define OP_VL     0x07
+#define OP_VS     0x27
+
+#define FUNC3_FENCE_I 0x1
+
+#define FUNC3_OPIVV 0x0
+#define FUNC3_OPMVV 0x2
+#define FUNC3_OPIVI 0x3
+#define FUNC3_OPCFG 0x7
+#define FUNCT6_VADD    0x00
+#define FUNCT6_VREDSUM 0x00
+#define FUNCT6_VSLL    0x25
+#define FUNCT6_VMUL    0x25
+
+TraceLog::TraceLog() : out(&std::cout), enabled(true) {}
+
+void TraceLog::on_cycle(uint64_t cycle) {
+    if (!enabled) return;
+    *out << "\n========== CYCLE " << cycle << " ==========\n";
+}
+
+void TraceLog::on_cycle_end() {
+    if (!enabled) return;
+    *out << "========================================\n";
+}
+
+template <int XLEN>
+void TraceLog::on_fetch(const FetchEvent<XLEN>& e) {
+    if (!enabled) return;
+    switch (e.kind) {
+    case FETCH_OK:
+        if (e.size == 2) {
+            *out << "[IF] Compressed 0x" << std::hex << (e.raw & 0xFFFF) << " expanded" << std::dec << "\n";
+        }
+        *out << "[IF] Fetched IR=0x" << std::hex << e.IR << " from PC=0x" << e.PC << std::dec << "\n";
+        break;
+    case FETCH_FAULT:
+        if (e.cause == CAUSE_ILLEGAL_INSTRUCTION) {
+            *out << "[IF] Illegal compressed instruction 0x" << std::hex << (e.raw & 0xFFFF) << " at PC=0x" << e.PC
+                 << std::dec << "\n";
+            break;
+        }
+        *out << "[IF] Fetch fault (cause " << e.cause << ") at PC=0x" << std::hex << e.PC << std::dec << "\n";
+        break;
+    case FETCH_WAIT:
+        *out << "[IF] Waiting for fetch fault at PC=0x" << std::hex << e.PC << std::dec << " to reach EX\n";
+        break;
+    case FETCH_END:
+        *out << "[IF] No instruction at PC=0x" << std::hex << e.PC << std::dec << " (End of program)\n";
+        break;
+    case FETCH_STALLED:
+        *out << "[IF] Pipeline stalled (not fetching)\n";
+        break;
+    }
+}
+
+template <int XLEN>
+void TraceLog::on_decode(const DecodeEvent<XLEN>& e) {
+    if (!enabled) return;
+    if (e.IR == 0) {
+        *out << "[ID] Bubble (NOP)\n";
+        return;
+    }
+    *out << "[ID] Decoding IR=0x" << std::hex << e.IR << std::dec
+         << " (" << disasm.lookup(e.IR) << ")"
+         << " rs1=x" << (int)e.rs1 << " rs2=x" << (int)e.rs2 << "\n";
+    if (!e.stalled) {
+        *out << "[ID] Read A=x" << (int)e.rs1 << "=" << e.A
+             << ", B=x" << (int)e.rs2 << "=" << e.B << "\n";
+    }
+}
+
+void TraceLog::on_stall(const StallEvent& e) {
+    if (!enabled) return;
+    if (e.kind == STALL_WALK) {
+        *out << "[MMU] Page-table walk in progress (" << e.walk_left << " cycles left)\n";
+        return;
+    }
+    if (e.ex_hit)  *out << "[DATA HAZARD] RAW detected with EX stage (rd=x" << (int)e.ex_rd << ")\n";
+    if (e.mem_hit) *out << "[DATA HAZARD] RAW detected with MEM stage (rd=x" << (int)e.mem_rd << ")\n";
+    if (e.wb_hit)  *out << "[DATA HAZARD] RAW detected with WB stage (rd=x" << (int)e.wb_rd << ")\n";
+    if (e.vector)  *out << "[DATA HAZARD] Vector RAW detected with an older vector write\n";
+    *out << "[STALL] Inserting bubble, keeping IF/ID unchanged\n";
+}
+
+template <int XLEN>
+void TraceLog::on_execute(const ExecEvent<XLEN>& e) {
+    if (!enabled) return;
+    const unsigned int SHAMT_MASK = XlenTraits<XLEN>::SHAMT_MASK;
+    *out << "[EX] Opcode=0x" << std::hex << (int)e.opcode << std::dec;
+
+    if (e.opcode == OP_R_TYPE) {
+        if (e.func3 == 0x0) {
+            if (e.func7 == 0x20) *out << " SUB: " << e.op1 << " - " << e.op2 << " = " << e.result << "\n";
+            else                 *out << " ADD: " << e.op1 << " + " << e.op2 << " = " << e.result << "\n";
+        }
+        else if (e.func3 == 0x1) *out << " SLL: " << e.op1 << " << " << (e.op2 & SHAMT_MASK) << " = " << e.result << "\n";
+        else if (e.func3 == 0x2) *out << " SLT: " << e.op1 << " < " << e.op2 << " = " << e.result << "\n";
+    }
+    else if (e.opcode == OP_I_TYPE) {
+        if (e.func3 == 0x0)      *out << " ADDI: " << e.op1 << " + " << e.op2 << " = " << e.result << "\n";
+        else if (e.func3 == 0x1) *out << " SLLI: " << e.op1 << " << " << (e.op2 & SHAMT_MASK) << " = " << e.result << "\n";
+    }
+    else if (e.opcode == OP_LW || e.opcode == OP_SW) {
+        *out << " ADDR: " << e.op1 << " + " << e.op2 << " = " << e.result << "\n";
+        if (e.fault == 0 && e.translated) {
+            *out << "[MMU] VA 0x" << std::hex << (typename ExecEvent<XLEN>::uxlen_t)e.result << " -> PA 0x" << e.pa << std::dec
+                 << (e.walk_cycles ? " (D-TLB miss)" : " (D-TLB hit)") << "\n";
+        }
+    }
+    else if (e.opcode == OP_V || e.opcode == OP_VL || e.opcode == OP_VS) {
+        execute_vector(e);
+    }
+    else if (e.opcode == OP_FENCE && e.func3 == FUNC3_FENCE_I) {
+        *out << " FENCE.I: flushing decode cache, refetching from 0x" << std::hex << e.NPC << std::dec << "\n";
+    }
+    else if (e.opcode == OP_BRANCH) {
+        if (e.func3 == 0x0)      *out << " BEQ: " << e.op1 << " == " << e.op2 << " ? " << e.cond << "\n";
+        else if (e.func3 == 0x4) *out << " BLT: " << e.op1 << " < " << e.op2 << " ? " << e.cond << "\n";
+    }
+}
+
+template <int XLEN>
+void TraceLog::execute_vector(const ExecEvent<XLEN>& e) {
+    uint32_t funct6 = e.IR >> 26;
+
+    if (e.opcode == OP_V && e.func3 == FUNC3_OPCFG) {
+        *out << " VSETVLI: AVL=" << (typename ExecEvent<XLEN>::uxlen_t)e.op1 << " vl=" << e.vl << (e.vill ? " (vill)" : "") << "\n";
+        return;
+    }
+    if (e.fault == CAUSE_ILLEGAL_INSTRUCTION) {
+        bool masked = ((e.IR >> 25) & 0x1) == 0;
+        if (e.vill || masked) *out << " vector instruction with " << (masked ? "mask" : "vill set") << ", illegal\n";
+        else *out << " unsupported vector instruction\n";
+        return;
+    }
+    if (e.opcode == OP_VL || e.opcode == OP_VS) {
+        // A translation fault traps before the access is described
+        if (e.fault == 0) {
+            *out << (e.opcode == OP_VL ? " VLE32.V" : " VSE32.V") << ": base="
+                 << (typename ExecEvent<XLEN>::uxlen_t)e.result << " vl=" << e.vl << "\n";
+        }
+        return;
+    }
+
+    if (e.func3 == FUNC3_OPIVV && funct6 == FUNCT6_VADD)
+        *out << " VADD.VV: v" << (int)e.rd << " = v" << (int)e.rs2 << " + v" << (int)e.rs1;
+    else if (e.func3 == FUNC3_OPMVV && funct6 == FUNCT6_VMUL)
+        *out << " VMUL.VV: v" << (int)e.rd << " = v" << (int)e.rs2 << " * v" << (int)e.rs1;
+    else if (e.func3 == FUNC3_OPIVV && funct6 == FUNCT6_VSLL)
+        *out << " VSLL.VV: v" << (int)e.rd << " = v" << (int)e.rs2 << " << v" << (int)e.rs1;
+    else if (e.func3 == FUNC3_OPIVI && funct6 == FUNCT6_VSLL)
+        *out << " VSLL.VI: v" << (int)e.rd << " = v" << (int)e.rs2 << " << " << (int)e.rs1;
+    else if (e.func3 == FUNC3_OPMVV && funct6 == FUNCT6_VREDSUM)
+        *out << " VREDSUM.VS: v" << (int)e.rd << "[0] = " << e.vresult;
+    *out << " (vl=" << e.vl << ", " << vk_backend() << ")\n";
+}
+
+template <int XLEN>
+void TraceLog::on_mem_access(const MemEvent<XLEN>& e) {
+    if (!enabled) return;
+    typedef typename XlenTraits<XLEN>::uxlen_t uxlen_t;
+
+    if (e.kind == MEM_NONE) {
+        *out << "[MEM] No memory operation\n";
+    }
+    else if (e.vector) {
+        const char* name = (e.kind == MEM_LOAD) ? "VLE32" : "VSE32";
+        if (!e.ok) {
+            *out << "[MEM] " << name << " ERROR: Address " << e.addr << " out of bounds\n";
+            return;
+        }
+        if (e.hit_code) *out << "[MEM] VSE32 hit code, decode cache invalidated\n";
+        if (e.kind == MEM_LOAD) *out << "[MEM] VLE32: Read " << e.elements << " elements from addr " << e.addr << "\n";
+        else                    *out << "[MEM] VSE32: Wrote " << e.elements << " elements to addr " << e.addr << "\n";
+    }
+    else if (e.kind == MEM_LOAD) {
+        if (e.ok) *out << "[MEM] LW: Read " << e.value << " from addr " << e.addr << "\n";
+        else      *out << "[MEM] LW ERROR: Address " << e.addr << " out of bounds\n";
+    }
+    else {
+        if (!e.ok) {
+            *out << "[MEM] SW ERROR: Address " << e.addr << " out of bounds\n";
+            return;
+        }
+        if (e.hit_code) *out << "[MEM] SW hit code at 0x" << std::hex << e.pa << std::dec << ", decode cache invalidated\n";
+        *out << "[MEM] SW: Wrote " << (uxlen_t)e.value << " to addr " << e.addr << "\n";
+    }
+}
+
+template <int XLEN>
+void TraceLog::on_writeback(const WritebackEvent<XLEN>& e) {
+    if (!enabled) return;
+    if (e.kind == WB_REG)       *out << "[WB] Wrote " << e.value << " to x" << (int)e.rd << "\n";
+    else if (e.kind == WB_VREG) *out << "[WB] Wrote " << e.elements << " elements to v" << (int)e.rd << "\n";
+    else                        *out << "[WB] No write back (NOP or x0)\n";
+}
+
+template <int XLEN>
+void TraceLog::on_flush(const FlushEvent<XLEN>& e) {
+    if (!enabled) return;
+    if (e.kind == FLUSH_BRANCH) {
+        *out << "[CONTROL HAZARD] Branch taken! Flushing IF/ID and ID/EX. New PC: 0x"
+             << std::hex << e.target << std::dec << "\n";
+    }
+    else if (e.kind == FLUSH_TRAP) {
+        *out << "[TRAP] cause=" << e.cause << " epc=0x" << std::hex << e.epc << " tval=0x" << e.tval;
+        if (e.halted) *out << std::dec << " (no handler, halting)\n";
+        else          *out << " -> handler at 0x" << e.target << std::dec << "\n";
+    }
+    // FENCE.I was described by its EX line
+}
+
+#define TRACE_LOG_INSTANTIATE(XLEN) \
+    template void TraceLog::on_fetch<XLEN>(const FetchEvent<XLEN>&); \
+    template void TraceLog::on_decode<XLEN>(const DecodeEvent<XLEN>&); \
+    template void TraceLog::on_execute<XLEN>(const ExecEvent<XLEN>&); \
+    template void TraceLog::on_mem_access<XLEN>(const MemEvent<XLEN>&); \
+    template void TraceLog::on_writeback<XLEN>(const WritebackEvent<XLEN>&); \
+    template void TraceLog::on_flush<XLEN>(const FlushEvent<XLEN>&);
+
+TRACE_LOG_INSTANTIATE(32)
+TRACE_LOG_INSTANTIATE(64)
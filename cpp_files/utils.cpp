@@ -4,21 +4,31 @@ unsigned int binToUint(const string& bin) {
     return stoul(bin, nullptr, 2);
 }
 
-int getRegisterNumber(const string& reg) {
+int getRegisterNumber(string_view reg) {
     if (reg.length() > 1 && reg[0] == 'x') {
         try {
-            int num = stoi(reg.substr(1));
+            int num = stoi(string(reg.substr(1)));
             return (num >= 0 && num <= 31) ? num : -1;
         } catch (...) { return -1; }
     }
     return -1;
 }
 
-int getImmediateValue(const string& immStr) {
+int getVectorRegisterNumber(string_view reg) {
+    if (reg.length() > 1 && reg[0] == 'v') {
+        try {
+            int num = stoi(string(reg.substr(1)));
+            return (num >= 0 && num <= 31) ? num : -1;
+        } catch (...) { return -1; }
+    }
+    return -1;
+}
+
+int getImmediateValue(string_view immStr) {
     try {
         if (immStr.size() > 2 && immStr.substr(0, 2) == "0x")
-            return stoul(immStr, nullptr, 16);
-        else return stoi(immStr);
+            return stoul(string(immStr), nullptr, 16);
+        else return stoi(string(immStr));
     } catch (...) { return 999999999; }
 }
 
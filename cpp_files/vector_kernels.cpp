@@ -0,0 +1,227 @@
+#include "../hpp_files/vector_kernels.hpp"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define VK_AVX2 1
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#if defined(__SSE4_1__)
+#include <smmintrin.h>
+#endif
+#define VK_SSE2 1
+#elif defined(__wasm_simd128__)
+#include <wasm_simd128.h>
+#define VK_WASM 1
+#endif
+
+// Scalar helpers (unsigned math so overflow wraps instead of being UB)
+static inline int32_t wrap_add(int32_t a, int32_t b) { return (int32_t)((uint32_t)a + (uint32_t)b); }
+static inline int32_t wrap_mul(int32_t a, int32_t b) { return (int32_t)((uint32_t)a * (uint32_t)b); }
+static inline int32_t wrap_sll(int32_t a, uint32_t s) { return (int32_t)((uint32_t)a << (s & 0x1F)); }
+
+const char* vk_backend() {
+#if defined(VK_AVX2)
+    return "AVX2";
+#elif defined(VK_SSE2) && defined(__SSE4_1__)
+    return "SSE4.1";
+#elif defined(VK_SSE2)
+    return "SSE2";
+#elif defined(VK_WASM)
+    return "WASM SIMD128";
+#else
+    return "scalar";
+#endif
+}
+
+void vk_add_i32(int32_t* dst, const int32_t* a, const int32_t* b, unsigned int n) {
+    unsigned int i = 0;
+#if defined(VK_AVX2)
+    for (; i + 8 <= n; i += 8) {
+        __m256i va = _mm256_loadu_si256((const __m256i*)(a + i));
+        __m256i vb = _mm256_loadu_si256((const __m256i*)(b + i));
+        _mm256_storeu_si256((__m256i*)(dst + i), _mm256_add_epi32(va, vb));
+    }
+#elif defined(VK_SSE2)
+    for (; i + 4 <= n; i += 4) {
+        __m128i va = _mm_loadu_si128((const __m128i*)(a + i));
+        __m128i vb = _mm_loadu_si128((const __m128i*)(b + i));
+        _mm_storeu_si128((__m128i*)(dst + i), _mm_add_epi32(va, vb));
+    }
+#elif defined(VK_WASM)
+    for (; i + 4 <= n; i += 4) {
+        v128_t va = wasm_v128_load(a + i);
+        v128_t vb = wasm_v128_load(b + i);
+        wasm_v128_store(dst + i, wasm_i32x4_add(va, vb));
+    }
+#endif
+    for (; i < n; i++) dst[i] = wrap_add(a[i], b[i]);
+}
+
+void vk_mul_i32(int32_t* dst, const int32_t* a, const int32_t* b, unsigned int n) {
+    unsigned int i = 0;
+#if defined(VK_AVX2)
+    for (; i + 8 <= n; i += 8) {
+        __m256i va = _mm256_loadu_si256((const __m256i*)(a + i));
+        __m256i vb = _mm256_loadu_si256((const __m256i*)(b + i));
+        _mm256_storeu_si256((__m256i*)(dst + i), _mm256_mullo_epi32(va, vb));
+    }
+#elif defined(VK_SSE2) && defined(__SSE4_1__)
+    for (; i + 4 <= n; i += 4) {
+        __m128i va = _mm_loadu_si128((const __m128i*)(a + i));
+        __m128i vb = _mm_loadu_si128((const __m128i*)(b + i));
+        _mm_storeu_si128((__m128i*)(dst + i), _mm_mullo_epi32(va, vb));
+    }
+#elif defined(VK_WASM)
+    for (; i + 4 <= n; i += 4) {
+        v128_t va = wasm_v128_load(a + i);
+        v128_t vb = wasm_v128_load(b + i);
+        wasm_v128_store(dst + i, wasm_i32x4_mul(va, vb));
+    }
+#endif
+    for (; i < n; i++) dst[i] = wrap_mul(a[i], b[i]);
+}
+
+void vk_sll_i32(int32_t* dst, const int32_t* a, const int32_t* shift, unsigned int n) {
+    unsigned int i = 0;
+#if defined(VK_AVX2)
+    const __m256i mask = _mm256_set1_epi32(0x1F);
+    for (; i + 8 <= n; i += 8) {
+        __m256i va = _mm256_loadu_si256((const __m256i*)(a + i));
+        __m256i vs = _mm256_and_si256(_mm256_loadu_si256((const __m256i*)(shift + i)), mask);
+        _mm256_storeu_si256((__m256i*)(dst + i), _mm256_sllv_epi32(va, vs));
+    }
+#endif
+    // SSE2 and SIMD128 have no per-lane variable shift
+    for (; i < n; i++) dst[i] = wrap_sll(a[i], shift[i]);
+}
+
+void vk_slli_i32(int32_t* dst, const int32_t* a, unsigned int shift, unsigned int n) {
+    unsigned int i = 0;
+    shift &= 0x1F;
+#if defined(VK_AVX2)
+    const __m128i count = _mm_cvtsi32_si128(shift);
+    for (; i + 8 <= n; i += 8) {
+        __m256i va = _mm256_loadu_si256((const __m256i*)(a + i));
+        _mm256_storeu_si256((__m256i*)(dst + i), _mm256_sll_epi32(va, count));
+    }
+#elif defined(VK_SSE2)
+    const __m128i count = _mm_cvtsi32_si128(shift);
+    for (; i + 4 <= n; i += 4) {
+        __m128i va = _mm_loadu_si128((const __m128i*)(a + i));
+        _mm_storeu_si128((__m128i*)(dst + i), _mm_sll_epi32(va, count));
+    }
+#elif defined(VK_WASM)
+    for (; i + 4 <= n; i += 4) {
+        v128_t va = wasm_v128_load(a + i);
+        wasm_v128_store(dst + i, wasm_i32x4_shl(va, shift));
+    }
+#endif
+    for (; i < n; i++) dst[i] = wrap_sll(a[i], shift);
+}
+
+int32_t vk_redsum_i32(const int32_t* a, unsigned int n) {
+    unsigned int i = 0;
+    int32_t sum = 0;
+#if defined(VK_AVX2)
+    __m256i acc = _mm256_setzero_si256();
+    for (; i + 8 <= n; i += 8) {
+        acc = _mm256_add_epi32(acc, _mm256_loadu_si256((const __m256i*)(a + i)));
+    }
+    __m128i s = _mm_add_epi32(_mm256_castsi256_si128(acc), _mm256_extracti128_si256(acc, 1));
+    s = _mm_add_epi32(s, _mm_shuffle_epi32(s, _MM_SHUFFLE(1, 0, 3, 2)));
+    s = _mm_add_epi32(s, _mm_shuffle_epi32(s, _MM_SHUFFLE(2, 3, 0, 1)));
+    sum = _mm_cvtsi128_si32(s);
+#elif defined(VK_SSE2)
+    __m128i acc = _mm_setzero_si128();
+    for (; i + 4 <= n; i += 4) {
+        acc = _mm_add_epi32(acc, _mm_loadu_si128((const __m128i*)(a + i)));
+    }
+    acc = _mm_add_epi32(acc, _mm_shuffle_epi32(acc, _MM_SHUFFLE(1, 0, 3, 2)));
+    acc = _mm_add_epi32(acc, _mm_shuffle_epi32(acc, _MM_SHUFFLE(2, 3, 0, 1)));
+    sum = _mm_cvtsi128_si32(acc);
+#elif defined(VK_WASM)
+    v128_t acc = wasm_i32x4_splat(0);
+    for (; i + 4 <= n; i += 4) {
+        acc = wasm_i32x4_add(acc, wasm_v128_load(a + i));
+    }
+    sum = wrap_add(wrap_add(wasm_i32x4_extract_lane(acc, 0), wasm_i32x4_extract_lane(acc, 1)),
+                   wrap_add(wasm_i32x4_extract_lane(acc, 2), wasm_i32x4_extract_lane(acc, 3)));
+#endif
+    for (; i < n; i++) sum = wrap_add(sum, a[i]);
+    return sum;
+}
+
+void vk_cmpeq_i32(int32_t* mask, const int32_t* a, const int32_t* b, unsigned int n) {
+    unsigned int i = 0;
+#if defined(VK_AVX2)
+    for (; i + 8 <= n; i += 8) {
+        __m256i va = _mm256_loadu_si256((const __m256i*)(a + i));
+        __m256i vb = _mm256_loadu_si256((const __m256i*)(b + i));
+        _mm256_storeu_si256((__m256i*)(mask + i), _mm256_cmpeq_epi32(va, vb));
+    }
+#elif defined(VK_SSE2)
+    for (; i + 4 <= n; i += 4) {
+        __m128i va = _mm_loadu_si128((const __m128i*)(a + i));
+        __m128i vb = _mm_loadu_si128((const __m128i*)(b + i));
+        _mm_storeu_si128((__m128i*)(mask + i), _mm_cmpeq_epi32(va, vb));
+    }
+#elif defined(VK_WASM)
+    for (; i + 4 <= n; i += 4) {
+        wasm_v128_store(mask + i, wasm_i32x4_eq(wasm_v128_load(a + i), wasm_v128_load(b + i)));
+    }
+#endif
+    for (; i < n; i++) mask[i] = (a[i] == b[i]) ? -1 : 0;
+}
+
+void vk_cmplt_i32(int32_t* mask, const int32_t* a, const int32_t* b, unsigned int n) {
+    unsigned int i = 0;
+#if defined(VK_AVX2)
+    for (; i + 8 <= n; i += 8) {
+        __m256i va = _mm256_loadu_si256((const __m256i*)(a + i));
+        __m256i vb = _mm256_loadu_si256((const __m256i*)(b + i));
+        _mm256_storeu_si256((__m256i*)(mask + i), _mm256_cmpgt_epi32(vb, va));
+    }
+#elif defined(VK_SSE2)
+    for (; i + 4 <= n; i += 4) {
+        __m128i va = _mm_loadu_si128((const __m128i*)(a + i));
+        __m128i vb = _mm_loadu_si128((const __m128i*)(b + i));
+        _mm_storeu_si128((__m128i*)(mask + i), _mm_cmplt_epi32(va, vb));
+    }
+#elif defined(VK_WASM)
+    for (; i + 4 <= n; i += 4) {
+        wasm_v128_store(mask + i, wasm_i32x4_lt(wasm_v128_load(a + i), wasm_v128_load(b + i)));
+    }
+#endif
+    for (; i < n; i++) mask[i] = (a[i] < b[i]) ? -1 : 0;
+}
+
+void vk_slt_i32(int32_t* dst, const int32_t* a, const int32_t* b, unsigned int n) {
+    // Compare mask (-1 / 0) negated to 1 / 0
+    vk_cmplt_i32(dst, a, b, n);
+    for (unsigned int i = 0; i < n; i++) dst[i] = -dst[i];
+}
+
+void vk_blend_i32(int32_t* dst, const int32_t* src, const int32_t* mask, unsigned int n) {
+    unsigned int i = 0;
+#if defined(VK_AVX2)
+    for (; i + 8 <= n; i += 8) {
+        __m256i vd = _mm256_loadu_si256((const __m256i*)(dst + i));
+        __m256i vs = _mm256_loadu_si256((const __m256i*)(src + i));
+        __m256i vm = _mm256_loadu_si256((const __m256i*)(mask + i));
+        _mm256_storeu_si256((__m256i*)(dst + i), _mm256_blendv_epi8(vd, vs, vm));
+    }
+#elif defined(VK_SSE2)
+    for (; i + 4 <= n; i += 4) {
+        __m128i vd = _mm_loadu_si128((const __m128i*)(dst + i));
+        __m128i vs = _mm_loadu_si128((const __m128i*)(src + i));
+        __m128i vm = _mm_loadu_si128((const __m128i*)(mask + i));
+        _mm_storeu_si128((__m128i*)(dst + i), _mm_or_si128(_mm_and_si128(vm, vs), _mm_andnot_si128(vm, vd)));
+    }
+#elif defined(VK_WASM)
+    for (; i + 4 <= n; i += 4) {
+        v128_t vd = wasm_v128_load(dst + i);
+        wasm_v128_store(dst + i, wasm_v128_bitselect(wasm_v128_load(src + i), vd, wasm_v128_load(mask + i)));
+    }
+#endif
+    for (; i < n; i++) dst[i] = mask[i] ? src[i] : dst[i];
+}
@@ -0,0 +1,44 @@
+# beq rs1, rs2, label: branch if rs1 == rs2.
+# Self-checking: tohost (mem[0]) ends 1 on pass, (N << 1) | 1 if case N fails.
+#@ beq
+.data
+tohost: .word 0           # 0x00
+pass:   .word 1           # 0x04
+case1:  .word 3           # 0x08: failure codes
+case2:  .word 5
+case3:  .word 7
+case4:  .word 9
+case5:  .word 11
+neg:    .word -1          # 0x1c
+neg2:   .word -1
+min:    .word 0x80000000
+eight:  .word 8           # 0x28
+
+.text
+    lw x1, 4(x0)          # 1
+    lw x2, 28(x0)         # -1
+    lw x3, 8(x0)
+    beq x0, x0, c1        # Taken: equal
+    beq x0, x0, report
+c1: lw x3, 12(x0)
+    beq x1, x0, report    # Not taken: 1 != 0
+    beq x1, x2, report    # Not taken: 1 != -1
+    lw x3, 16(x0)
+    lw x4, 32(x0)
+    beq x2, x4, c3        # Taken: equal negatives
+    beq x0, x0, report
+c3: lw x3, 20(x0)
+    lw x5, 36(x0)
+    beq x5, x1, report    # Not taken: only bit 31 differs from 0
+    beq x5, x0, report
+    lw x3, 24(x0)
+    lw x6, 4(x0)          # Backward: x6 = 1, 2, 4, 8 across three loops
+    lw x7, 40(x0)
+loop:
+    slli x6, x6, 1
+    beq x6, x7, ok
+    beq x0, x0, loop
+ok: lw x3, 4(x0)
+report:
+    sw x3, 0(x0)
+#= mem[0] = 1  halted = 0
@@ -0,0 +1,46 @@
+# blt rs1, rs2, label: branch if rs1 < rs2 (signed).
+# Self-checking: tohost (mem[0]) ends 1 on pass, (N << 1) | 1 if case N fails.
+#@ blt
+.data
+tohost: .word 0           # 0x00
+pass:   .word 1           # 0x04
+case1:  .word 3           # 0x08: failure codes
+case2:  .word 5
+case3:  .word 7
+case4:  .word 9
+case5:  .word 11
+case6:  .word 13
+neg:    .word -1          # 0x20
+min:    .word 0x80000000
+max:    .word 0x7fffffff
+sixteen: .word 16         # 0x2c
+
+.text
+    lw x1, 4(x0)          # 1
+    lw x2, 32(x0)         # -1
+    lw x3, 8(x0)
+    blt x2, x1, c2        # Taken: -1 < 1
+    beq x0, x0, report
+c2: lw x3, 12(x0)
+    blt x1, x2, report    # Not taken: 1 < -1 (the unsigned order)
+    lw x3, 16(x0)
+    blt x1, x1, report    # Not taken: equal
+    lw x3, 20(x0)
+    lw x4, 36(x0)
+    lw x5, 40(x0)
+    blt x4, x5, c5        # Taken: INT_MIN < INT_MAX
+    beq x0, x0, report
+c5: lw x3, 24(x0)
+    blt x5, x4, report    # Not taken: INT_MAX < INT_MIN
+    lw x3, 28(x0)
+    lw x6, 4(x0)          # Backward: loop while x6 < 16
+    lw x7, 44(x0)
+loop:
+    slli x6, x6, 1
+    blt x6, x7, loop
+    beq x6, x7, ok
+    beq x0, x0, report
+ok: lw x3, 4(x0)
+report:
+    sw x3, 0(x0)
+#= mem[0] = 1  halted = 0
@@ -0,0 +1,65 @@
+# fence.i: orders instruction fetch after earlier stores; in split memory
+# it only drains the pipeline. The second test patches its own code.
+# Self-checking: tohost (mem[0]) ends 1 on pass, (N << 1) | 1 if case N fails.
+#@ fence_i
+.data
+tohost: .word 0           # 0x00
+pass:   .word 1           # 0x04
+case1:  .word 3           # 0x08: failure codes
+case2:  .word 5
+case3:  .word 7
+word:   .word 0x600d      # 0x14
+two:    .word 2
+
+.text
+    lw x1, 20(x0)
+    lw x3, 8(x0)
+    sw x1, 28(x0)
+    fence.i
+    lw x5, 28(x0)         # The store before the fence is visible
+    beq x5, x1, c2
+    beq x0, x0, report
+c2: lw x3, 12(x0)
+    lw x6, 4(x0)
+    fence.i
+    fence.i               # Back to back
+    slli x6, x6, 1        # Runs exactly once after the refetch: x6 = 2
+    lw x7, 24(x0)
+    beq x6, x7, c3
+    beq x0, x0, report
+c3: lw x3, 16(x0)
+    fence.i
+    beq x0, x0, ok        # A branch right behind the fence
+    beq x0, x0, report
+ok: lw x3, 4(x0)
+report:
+    sw x3, 0(x0)
+#= mem[0] = 1  halted = 0
+
+#@ fence_i_smc mem=256 unified=1
+.data
+tohost: .word 0           # 0x00
+pass:   .word 1           # 0x04
+case1:  .word 3           # 0x08: failure codes
+case2:  .word 5
+patch:  .word 0x00109293  # 0x10: slli x5, x1, 1
+two:    .word 2
+
+.text
+    lw x1, 4(x0)          # 0x80
+    lw x3, 8(x0)          # 0x84
+    lw x4, 16(x0)         # 0x88
+    sw x4, 152(x0)        # 0x8c: overwrite 0x98
+    fence.i               # 0x90
+    lw x7, 20(x0)         # 0x94
+    sll x5, x0, x0        # 0x98: runs as slli x5, x1, 1 (x5 = 2)
+    beq x5, x7, c2
+    beq x0, x0, report
+c2: lw x3, 12(x0)
+    lw x6, 152(x0)        # Code is readable as data
+    beq x6, x4, ok
+    beq x0, x0, report
+ok: lw x3, 4(x0)
+report:
+    sw x3, 0(x0)
+#= mem[0] = 1  halted = 0
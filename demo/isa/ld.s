@@ -0,0 +1,57 @@
+# ld rd, imm(rs1) (RV64I): rd = the 64-bit doubleword at rs1 + imm.
+# Self-checking: tohost (mem[0]) ends 1 on pass, (N << 1) | 1 if case N fails.
+#@ ld xlen=64
+.data
+tohost: .word 0           # 0x00
+pass:   .word 1           # 0x04
+case1:  .word 3           # 0x08: failure codes
+case2:  .word 5
+case3:  .word 7
+case4:  .word 9
+case5:  .word 11
+ptr:    .word 64          # 0x1c
+d0lo:   .word 5           # 0x20: 5
+d0hi:   .word 0
+d1lo:   .word 0           # 0x28: 1 << 32
+d1hi:   .word 1
+d2lo:   .word 0           # 0x30: -1 << 32
+d2hi:   .word -1
+d3lo:   .word -1          # 0x38: 0xffffffff
+d3hi:   .word 0
+
+.text
+    lw x1, 4(x0)          # 1
+    lw x3, 8(x0)
+    ld x5, 32(x0)
+    lw x6, 32(x0)
+    beq x5, x6, c2        # Small value: same as lw
+    beq x0, x0, report
+c2: lw x3, 12(x0)
+    ld x5, 40(x0)
+    slli x6, x1, 32
+    beq x5, x6, c3        # The high word lands in bits 63:32
+    beq x0, x0, report
+c3: lw x3, 16(x0)
+    ld x5, 48(x0)
+    slt x14, x5, x0       # Bit 63 set: negative
+    beq x14, x1, c4
+    beq x0, x0, report
+c4: lw x3, 20(x0)
+    ld x5, 56(x0)         # No sign extension from bit 31
+    slt x14, x0, x5
+    beq x14, x0, report
+    lw x6, 56(x0)         # lw of the same word is -1
+    slt x14, x6, x5
+    beq x14, x1, c5
+    beq x0, x0, report
+c5: lw x3, 24(x0)
+    lw x4, 28(x0)         # x4 = 64
+    ld x4, -24(x4)        # Negative offset, rd = rs1: 0x28
+    beq x4, x6, report
+    slli x6, x1, 32
+    beq x4, x6, ok
+    beq x0, x0, report
+ok: lw x3, 4(x0)
+report:
+    sw x3, 0(x0)
+#= mem[0] = 1  halted = 0
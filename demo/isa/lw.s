@@ -0,0 +1,53 @@
+# lw rd, imm(rs1): rd = the 32-bit word at rs1 + imm.
+# Self-checking: tohost (mem[0]) ends 1 on pass, (N << 1) | 1 if case N fails.
+#@ lw
+.data
+tohost: .word 0           # 0x00
+pass:   .word 1           # 0x04
+case1:  .word 3           # 0x08: failure codes
+case2:  .word 5
+case3:  .word 7
+case4:  .word 9
+case5:  .word 11
+case6:  .word 13
+word:   .word 0x12345678  # 0x20
+neg:    .word -2
+zero:   .word 0
+ptr:    .word 40          # 0x2c: &zero
+
+.text
+    lw x3, 8(x0)
+    lw x1, 32(x0)         # Absolute address
+    lw x7, 4(x0)          # 1
+    slt x14, x0, x1       # Positive
+    beq x14, x7, c2
+    beq x0, x0, report
+c2: lw x3, 12(x0)
+    lw x2, 36(x0)
+    slt x14, x2, x0       # Sign bit kept: negative
+    beq x14, x7, c3
+    beq x0, x0, report
+c3: lw x3, 16(x0)
+    lw x4, 44(x0)         # x4 = 40
+    lw x5, -8(x4)         # Negative offset: 0x20
+    beq x5, x1, c4
+    beq x0, x0, report
+c4: lw x3, 20(x0)
+    lw x5, 0(x4)          # Base only: the zero word
+    beq x5, x0, c5
+    beq x0, x0, report
+c5: lw x3, 24(x0)
+    lw x4, 0(x4)          # rd = rs1
+    beq x4, x0, c6
+    beq x0, x0, report
+c6: lw x3, 28(x0)
+    lw x0, 32(x0)         # x0 stays 0
+    beq x0, x1, report
+    lw x6, 36(x0)
+    slt x14, x6, x1       # Load-use: -2 < 0x12345678 right after the load
+    beq x14, x7, ok
+    beq x0, x0, report
+ok: lw x3, 4(x0)
+report:
+    sw x3, 0(x0)
+#= mem[0] = 1  halted = 0
@@ -0,0 +1,46 @@
+# RVC under ".option rvc": c.lw, c.sw, c.lwsp, c.swsp, c.slli and c.beqz
+# mixed with 32-bit encodings, so some instructions sit at 2-byte offsets.
+# Self-checking: tohost (mem[0]) ends 1 on pass, (N << 1) | 1 if case N fails.
+#@ rvc
+.data
+tohost: .word 0           # 0x00
+pass:   .word 1           # 0x04
+case1:  .word 3           # 0x08: failure codes
+case2:  .word 5
+case3:  .word 7
+case4:  .word 9
+word:   .word 0x00c0ffee  # 0x18
+shift:  .word 0x0c0ffee0
+sp:     .word 64          # 0x20
+
+.text
+.option rvc
+    lw x3, 8(x0)          # 32-bit: x0 base
+    lw x8, 32(x0)         # x8 = 64
+    lw x9, 24(x0)
+    sw x9, 0(x8)          # c.sw
+    lw x10, 0(x8)         # c.lw
+    beq x10, x9, c2
+    beq x0, x0, report
+c2: lw x3, 12(x0)
+    lw x2, 32(x0)         # sp = 64
+    sw x9, 4(x2)          # c.swsp
+    lw x11, 4(x2)         # c.lwsp
+    beq x11, x9, c3
+    beq x0, x0, report
+c3: lw x3, 16(x0)
+    lw x12, 28(x0)
+    slli x9, x9, 4        # c.slli
+    beq x9, x12, c4
+    beq x0, x0, report
+c4: lw x3, 20(x0)
+    lw x13, 4(x0)
+    beq x13, x0, report   # c.beqz not taken
+    sw x0, 0(x8)
+    lw x14, 0(x8)
+    beq x14, x0, ok       # c.beqz taken
+    beq x0, x0, report
+ok: lw x3, 4(x0)
+report:
+    sw x3, 0(x0)
+#= mem[0] = 1  halted = 0
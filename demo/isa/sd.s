@@ -0,0 +1,61 @@
+# sd rs2, imm(rs1) (RV64I): the doubleword at rs1 + imm = rs2.
+# Self-checking: tohost (mem[0]) ends 1 on pass, (N << 1) | 1 if case N fails.
+#@ sd xlen=64
+.data
+tohost: .word 0           # 0x00
+pass:   .word 1           # 0x04
+case1:  .word 3           # 0x08: failure codes
+case2:  .word 5
+case3:  .word 7
+case4:  .word 9
+ptr:    .word 96          # 0x18
+five:   .word 5
+src:    .word 0x11223344  # 0x20
+        .word -2
+slot0:  .word 0           # 0x28: store targets
+        .word 0
+slot1:  .word -1          # 0x30
+        .word -1
+
+.text
+    lw x3, 8(x0)
+    ld x5, 32(x0)
+    sd x5, 40(x0)
+    lw x6, 40(x0)         # Low half
+    lw x7, 32(x0)
+    beq x6, x7, c1
+    beq x0, x0, report
+c1: lw x6, 44(x0)         # High half
+    lw x7, 36(x0)
+    beq x6, x7, c2
+    beq x0, x0, report
+c2: lw x3, 12(x0)
+    sd x0, 48(x0)         # Both halves cleared
+    lw x6, 48(x0)
+    beq x6, x0, c2b
+    beq x0, x0, report
+c2b:
+    lw x6, 52(x0)
+    beq x6, x0, c3
+    beq x0, x0, report
+c3: lw x3, 16(x0)
+    lw x1, 28(x0)
+    slli x1, x1, 32       # 5 << 32
+    lw x4, 24(x0)         # x4 = 96
+    sd x1, -56(x4)        # Negative offset: 0x28
+    lw x6, 40(x0)
+    beq x6, x0, c3b
+    beq x0, x0, report
+c3b:
+    lw x6, 44(x0)
+    lw x7, 28(x0)
+    beq x6, x7, c4
+    beq x0, x0, report
+c4: lw x3, 20(x0)
+    ld x6, 40(x0)         # Round trip
+    beq x6, x1, ok
+    beq x0, x0, report
+ok: lw x3, 4(x0)
+report:
+    sw x3, 0(x0)
+#= mem[0] = 1  halted = 0
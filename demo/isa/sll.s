@@ -0,0 +1,62 @@
+# sll rd, rs1, rs2: rd = rs1 << (rs2 & 31).
+# Self-checking: tohost (mem[0]) ends 1 on pass, (N << 1) | 1 if case N fails.
+#@ sll
+.data
+tohost: .word 0           # 0x00
+pass:   .word 1           # 0x04
+case1:  .word 3           # 0x08: failure codes
+case2:  .word 5
+case3:  .word 7
+case4:  .word 9
+case5:  .word 11
+case6:  .word 13
+two:    .word 2           # 0x20
+four:   .word 4
+n31:    .word 31
+n33:    .word 33
+min:    .word 0x80000000  # 0x30
+neg:    .word -3
+neg12:  .word -12
+x0f:    .word 0x0f000000  # 0x3c
+xf0:    .word 0xf0000000
+
+.text
+    lw x1, 4(x0)          # 1
+    lw x2, 32(x0)         # 2
+    lw x3, 8(x0)
+    sll x14, x1, x0       # Shift by 0
+    beq x14, x1, c2
+    beq x0, x0, report
+c2: lw x3, 12(x0)
+    lw x5, 36(x0)
+    sll x14, x1, x2       # 1 << 2
+    beq x14, x5, c3
+    beq x0, x0, report
+c3: lw x3, 16(x0)
+    lw x4, 40(x0)
+    lw x5, 48(x0)
+    sll x14, x1, x4       # 1 << 31 = INT_MIN
+    beq x14, x5, c4
+    beq x0, x0, report
+c4: lw x3, 20(x0)
+    lw x4, 44(x0)
+    sll x14, x1, x4       # Only rs2[4:0] counts: 1 << 33 = 1 << 1
+    beq x14, x2, c5
+    beq x0, x0, report
+c5: lw x3, 24(x0)
+    lw x4, 52(x0)
+    lw x5, 56(x0)
+    sll x14, x4, x2       # -3 << 2 = -12
+    beq x14, x5, c6
+    beq x0, x0, report
+c6: lw x3, 28(x0)
+    lw x4, 60(x0)
+    lw x5, 64(x0)
+    lw x6, 36(x0)
+    sll x4, x4, x6        # rd = rs1; high bits shift out: 0x0f000000 << 4
+    beq x4, x5, ok
+    beq x0, x0, report
+ok: lw x3, 4(x0)
+report:
+    sw x3, 0(x0)
+#= mem[0] = 1  halted = 0
@@ -0,0 +1,52 @@
+# slli rd, rs1, shamt: rd = rs1 << shamt.
+# Self-checking: tohost (mem[0]) ends 1 on pass, (N << 1) | 1 if case N fails.
+#@ slli
+.data
+tohost: .word 0           # 0x00
+pass:   .word 1           # 0x04
+case1:  .word 3           # 0x08: failure codes
+case2:  .word 5
+case3:  .word 7
+case4:  .word 9
+case5:  .word 11
+eight:  .word 8           # 0x1c
+min:    .word 0x80000000
+neg:    .word -5
+neg80:  .word -80         # 0x28
+mixed:  .word 0x00ffff01
+mixed8: .word 0xffff0100  # 0x30
+
+.text
+    lw x1, 4(x0)          # 1
+    lw x3, 8(x0)
+    slli x14, x1, 0       # Shift by 0
+    beq x14, x1, c2
+    beq x0, x0, report
+c2: lw x3, 12(x0)
+    lw x5, 28(x0)
+    slli x14, x1, 3       # 1 << 3
+    beq x14, x5, c3
+    beq x0, x0, report
+c3: lw x3, 16(x0)
+    lw x5, 32(x0)
+    slli x14, x1, 31      # 1 << 31 = INT_MIN
+    beq x14, x5, c4
+    beq x0, x0, report
+c4: lw x3, 20(x0)
+    lw x4, 36(x0)
+    lw x5, 40(x0)
+    slli x14, x4, 4       # -5 << 4 = -80
+    beq x14, x5, c5
+    beq x0, x0, report
+c5: lw x3, 24(x0)
+    lw x4, 44(x0)
+    lw x5, 48(x0)
+    slli x4, x4, 8        # rd = rs1; high bits shift out
+    slli x0, x1, 1        # x0 stays 0
+    beq x0, x1, report
+    beq x4, x5, ok
+    beq x0, x0, report
+ok: lw x3, 4(x0)
+report:
+    sw x3, 0(x0)
+#= mem[0] = 1  halted = 0
@@ -0,0 +1,55 @@
+# slt rd, rs1, rs2: rd = 1 if rs1 < rs2 (signed), else 0.
+# Self-checking: tohost (mem[0]) ends 1 on pass, (N << 1) | 1 if case N fails.
+#@ slt
+.data
+tohost: .word 0           # 0x00
+pass:   .word 1           # 0x04
+case1:  .word 3           # 0x08: failure codes
+case2:  .word 5
+case3:  .word 7
+case4:  .word 9
+case5:  .word 11
+case6:  .word 13
+minus1: .word -1          # 0x20
+plus1:  .word 1
+five:   .word 5
+min:    .word 0x80000000
+max:    .word 0x7fffffff
+
+.text
+    lw x1, 32(x0)         # -1
+    lw x2, 36(x0)         # 1
+    lw x4, 40(x0)         # 5
+    lw x5, 44(x0)         # INT_MIN
+    lw x6, 48(x0)         # INT_MAX
+    lw x7, 4(x0)          # 1
+    lw x3, 8(x0)
+    slt x14, x1, x2       # -1 < 1 (the unsigned order is the other way)
+    beq x14, x7, c2
+    beq x0, x0, report
+c2: lw x3, 12(x0)
+    slt x14, x2, x1       # 1 < -1
+    beq x14, x0, c3
+    beq x0, x0, report
+c3: lw x3, 16(x0)
+    slt x14, x4, x4       # 5 < 5
+    beq x14, x0, c4
+    beq x0, x0, report
+c4: lw x3, 20(x0)
+    slt x14, x5, x6       # INT_MIN < INT_MAX
+    beq x14, x7, c5
+    beq x0, x0, report
+c5: lw x3, 24(x0)
+    slt x14, x6, x5       # INT_MAX < INT_MIN
+    beq x14, x0, c6
+    beq x0, x0, report
+c6: lw x3, 28(x0)
+    slt x4, x4, x6        # rd = rs1: 5 < INT_MAX
+    slt x0, x1, x2        # x0 stays 0
+    beq x0, x7, report
+    beq x4, x7, ok
+    beq x0, x0, report
+ok: lw x3, 4(x0)
+report:
+    sw x3, 0(x0)
+#= mem[0] = 1  halted = 0
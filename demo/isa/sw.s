@@ -0,0 +1,51 @@
+# sw rs2, imm(rs1): the word at rs1 + imm = rs2.
+# Self-checking: tohost (mem[0]) ends 1 on pass, (N << 1) | 1 if case N fails.
+#@ sw
+.data
+tohost: .word 0           # 0x00
+pass:   .word 1           # 0x04
+case1:  .word 3           # 0x08: failure codes
+case2:  .word 5
+case3:  .word 7
+case4:  .word 9
+case5:  .word 11
+word:   .word 0x0badcafe  # 0x1c
+neg:    .word -7
+ptr:    .word 64          # 0x24
+slot0:  .word 0           # 0x28: store targets
+slot1:  .word 0
+slot2:  .word 0x55555555  # 0x30
+
+.text
+    lw x1, 28(x0)
+    lw x2, 32(x0)
+    lw x4, 36(x0)         # x4 = 64
+    lw x3, 8(x0)
+    sw x1, 40(x0)         # Absolute address
+    lw x5, 40(x0)
+    beq x5, x1, c2
+    beq x0, x0, report
+c2: lw x3, 12(x0)
+    sw x2, -20(x4)        # Negative offset: 0x2c
+    lw x5, 44(x0)
+    beq x5, x2, c3
+    beq x0, x0, report
+c3: lw x3, 16(x0)
+    sw x0, 48(x0)         # Storing x0 clears the word
+    lw x5, 48(x0)
+    beq x5, x0, c4
+    beq x0, x0, report
+c4: lw x3, 20(x0)
+    sw x2, 40(x0)         # Overwrite the first slot
+    lw x5, 40(x0)
+    beq x5, x2, c5
+    beq x0, x0, report
+c5: lw x3, 24(x0)
+    sw x4, 0(x4)          # Base only, rs2 = rs1: word 64 = 64
+    lw x5, 64(x0)
+    beq x5, x4, ok
+    beq x0, x0, report
+ok: lw x3, 4(x0)
+report:
+    sw x3, 0(x0)
+#= mem[0] = 1  halted = 0
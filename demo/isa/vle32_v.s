@@ -0,0 +1,59 @@
+# vle32.v vd, (rs1): vd[i] = the word at rs1 + 4 * i for i < vl.
+# Self-checking: tohost (mem[0]) ends 1 on pass, (N << 1) | 1 if case N fails.
+#@ vle32_v vlen=128
+.data
+tohost: .word 0           # 0x00
+pass:   .word 1           # 0x04
+case1:  .word 3           # 0x08: failure codes
+case2:  .word 5
+case3:  .word 7
+case4:  .word 9
+case5:  .word 11
+src:    .word -1          # 0x1c: not 16-byte aligned
+        .word 0x7fffffff
+        .word 0x80000000
+        .word 12345
+out:    .word 0           # 0x2c: vse32.v target
+        .word 0
+        .word 0
+        .word 0
+psrc:   .word 28          # 0x3c: pointers
+pout:   .word 44
+
+.text
+    lw x20, 60(x0)        # &src
+    lw x22, 64(x0)        # &out
+    vsetvli x1, x0, e32
+    vle32.v v1, (x20)
+    vse32.v v1, (x22)
+    lw x3, 8(x0)
+    lw x10, 44(x0)
+    lw x11, 28(x0)
+    beq x10, x11, e1
+    beq x0, x0, report
+e1: lw x3, 12(x0)
+    lw x10, 48(x0)
+    lw x11, 32(x0)
+    beq x10, x11, e2
+    beq x0, x0, report
+e2: lw x3, 16(x0)
+    lw x10, 52(x0)
+    lw x11, 36(x0)
+    beq x10, x11, e3
+    beq x0, x0, report
+e3: lw x3, 20(x0)
+    lw x10, 56(x0)
+    lw x11, 40(x0)
+    beq x10, x11, e4
+    beq x0, x0, report
+e4: lw x3, 24(x0)
+    vle32.v v2, (x0)      # x0 base: tohost, pass, case1, case2
+    vse32.v v2, (x22)
+    lw x10, 52(x0)
+    lw x11, 8(x0)
+    beq x10, x11, ok
+    beq x0, x0, report
+ok: lw x3, 4(x0)
+report:
+    sw x3, 0(x0)
+#= mem[0] = 1  halted = 0
@@ -0,0 +1,63 @@
+# vmul.vv vd, vs2, vs1: vd[i] = low 32 bits of vs2[i] * vs1[i].
+# Self-checking: tohost (mem[0]) ends 1 on pass, (N << 1) | 1 if case N fails.
+#@ vmul_vv vlen=128
+.data
+tohost: .word 0           # 0x00
+pass:   .word 1           # 0x04
+case1:  .word 3           # 0x08: failure codes
+case2:  .word 5
+case3:  .word 7
+case4:  .word 9
+a:      .word 3           # 0x18: vs2
+        .word -4
+        .word 0x10000
+        .word 7
+b:      .word 5           # 0x28: vs1
+        .word 6
+        .word 0x10000
+        .word -1
+exp:    .word 15          # 0x38: expected
+        .word -24
+        .word 0
+        .word -7
+out:    .word 0           # 0x48: vse32.v target
+        .word 0
+        .word 0
+        .word 0
+pa:     .word 24          # 0x58: pointers
+pb:     .word 40
+pout:   .word 72
+
+.text
+    lw x20, 88(x0)        # &a
+    lw x21, 92(x0)        # &b
+    lw x22, 96(x0)        # &out
+    vsetvli x1, x0, e32
+    vle32.v v1, (x20)
+    vle32.v v2, (x21)
+    vmul.vv v1, v1, v2      # vd = vs2
+    vse32.v v1, (x22)
+    lw x3, 8(x0)
+    lw x10, 72(x0)
+    lw x11, 56(x0)
+    beq x10, x11, e1
+    beq x0, x0, report
+e1: lw x3, 12(x0)
+    lw x10, 76(x0)
+    lw x11, 60(x0)
+    beq x10, x11, e2
+    beq x0, x0, report
+e2: lw x3, 16(x0)
+    lw x10, 80(x0)
+    lw x11, 64(x0)
+    beq x10, x11, e3
+    beq x0, x0, report
+e3: lw x3, 20(x0)
+    lw x10, 84(x0)
+    lw x11, 68(x0)
+    beq x10, x11, ok
+    beq x0, x0, report
+ok: lw x3, 4(x0)
+report:
+    sw x3, 0(x0)
+#= mem[0] = 1  halted = 0
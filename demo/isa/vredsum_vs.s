@@ -0,0 +1,77 @@
+# vredsum.vs vd, vs2, vs1: vd[0] = vs1[0] + the sum of vs2[0..vl-1].
+# Self-checking: tohost (mem[0]) ends 1 on pass, (N << 1) | 1 if case N fails.
+#@ vredsum_vs vlen=128
+.data
+tohost: .word 0           # 0x00
+pass:   .word 1           # 0x04
+case1:  .word 3           # 0x08: failure codes
+case2:  .word 5
+case3:  .word 7
+case4:  .word 9
+a:      .word 1           # 0x18: vs2
+        .word 2
+        .word 3
+        .word 4
+b:      .word 100         # 0x28: vs1, only element 0 counts
+        .word 1000
+        .word 1000
+        .word 1000
+big:    .word 0x7fffffff  # 0x38
+        .word 1
+        .word 0
+        .word 0
+sums:   .word 110         # 0x48: expected
+        .word 120
+        .word 0x80000000
+        .word 103
+two:    .word 2           # 0x58
+out:    .word 0           # 0x5c: vse32.v target
+pa:     .word 24          # 0x60: pointers
+pb:     .word 40
+pbig:   .word 56
+pout:   .word 92
+
+.text
+    lw x20, 96(x0)        # &a
+    lw x21, 100(x0)       # &b
+    lw x23, 104(x0)       # &big
+    lw x22, 108(x0)       # &out
+    vsetvli x1, x0, e32
+    vle32.v v1, (x20)
+    vle32.v v2, (x21)
+    vle32.v v5, (x23)
+    vredsum.vs v3, v1, v2 # 100 + 1 + 2 + 3 + 4
+    vredsum.vs v4, v1, v3 # Chained through vd[0]: 110 + 10
+    vredsum.vs v6, v5, v0 # v0 = 0: INT_MAX + 1 wraps
+    lw x5, 88(x0)
+    vsetvli x1, x5, e32   # vl = 2
+    vredsum.vs v7, v1, v2 # 100 + 1 + 2
+    vsetvli x1, x0, e32   # Back to vl = 4 so whole registers store
+    lw x3, 8(x0)
+    vse32.v v3, (x22)
+    lw x10, 92(x0)
+    lw x11, 72(x0)
+    beq x10, x11, c2
+    beq x0, x0, report
+c2: lw x3, 12(x0)
+    vse32.v v4, (x22)
+    lw x10, 92(x0)
+    lw x11, 76(x0)
+    beq x10, x11, c3
+    beq x0, x0, report
+c3: lw x3, 16(x0)
+    vse32.v v6, (x22)
+    lw x10, 92(x0)
+    lw x11, 80(x0)
+    beq x10, x11, c4
+    beq x0, x0, report
+c4: lw x3, 20(x0)
+    vse32.v v7, (x22)
+    lw x10, 92(x0)
+    lw x11, 84(x0)
+    beq x10, x11, ok
+    beq x0, x0, report
+ok: lw x3, 4(x0)
+report:
+    sw x3, 0(x0)
+#= mem[0] = 1  halted = 0
@@ -0,0 +1,61 @@
+# vse32.v vs3, (rs1): the word at rs1 + 4 * i = vs3[i] for i < vl.
+# Self-checking: tohost (mem[0]) ends 1 on pass, (N << 1) | 1 if case N fails.
+#@ vse32_v vlen=128
+.data
+tohost: .word 0           # 0x00
+pass:   .word 1           # 0x04
+case1:  .word 3           # 0x08: failure codes
+case2:  .word 5
+case3:  .word 7
+case4:  .word 9
+two:    .word 2           # 0x18
+src:    .word 7           # 0x1c
+        .word -8
+        .word 9
+        .word -10
+out:    .word 0           # 0x2c: vse32.v targets
+        .word 0
+        .word 0
+        .word 0
+out2:   .word -1          # 0x3c
+        .word -1
+        .word -1
+        .word -1
+psrc:   .word 28          # 0x4c: pointers
+pout:   .word 44
+pout2:  .word 60
+
+.text
+    lw x20, 76(x0)        # &src
+    lw x22, 80(x0)        # &out
+    lw x23, 84(x0)        # &out2
+    vsetvli x1, x0, e32
+    vle32.v v1, (x20)
+    vse32.v v1, (x22)
+    lw x3, 8(x0)
+    lw x10, 44(x0)        # First element
+    lw x11, 28(x0)
+    beq x10, x11, c2
+    beq x0, x0, report
+c2: lw x3, 12(x0)
+    lw x10, 56(x0)        # Last element
+    lw x11, 40(x0)
+    beq x10, x11, c3
+    beq x0, x0, report
+c3: lw x3, 16(x0)
+    lw x5, 24(x0)
+    vsetvli x1, x5, e32   # vl = 2
+    vse32.v v1, (x23)
+    lw x10, 64(x0)        # out2[1] written
+    lw x11, 32(x0)
+    beq x10, x11, c4
+    beq x0, x0, report
+c4: lw x3, 20(x0)
+    lw x10, 68(x0)        # out2[2] past vl: still -1
+    lw x11, 72(x0)
+    beq x10, x11, ok
+    beq x0, x0, report
+ok: lw x3, 4(x0)
+report:
+    sw x3, 0(x0)
+#= mem[0] = 1  halted = 0
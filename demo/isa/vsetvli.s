@@ -0,0 +1,75 @@
+# vsetvli rd, rs1, e32[, m1]: vl = min(rs1, VLMAX), rd = vl; rs1 = x0 asks
+# for VLMAX, and rd = rs1 = x0 keeps vl. VLEN = 128 gives VLMAX = 4.
+# Self-checking: tohost (mem[0]) ends 1 on pass, (N << 1) | 1 if case N fails.
+#@ vsetvli vlen=128
+.data
+tohost: .word 0           # 0x00
+pass:   .word 1           # 0x04
+case1:  .word 3           # 0x08: failure codes
+case2:  .word 5
+case3:  .word 7
+case4:  .word 9
+case5:  .word 11
+two:    .word 2           # 0x1c
+nine:   .word 9
+four:   .word 4
+src:    .word 10          # 0x28
+        .word 20
+        .word 30
+        .word 40
+out:    .word -1          # 0x38: vse32.v target
+        .word -1
+        .word -1
+        .word -1
+psrc:   .word 40          # 0x48: pointers
+pout:   .word 56
+zero:   .word 0
+minus1: .word -1
+
+.text
+    lw x20, 72(x0)        # &src
+    lw x22, 76(x0)        # &out
+    lw x7, 36(x0)         # 4
+    lw x3, 8(x0)
+    vsetvli x1, x0, e32   # VLMAX
+    beq x1, x7, c2
+    beq x0, x0, report
+c2: lw x3, 12(x0)
+    lw x5, 28(x0)
+    vsetvli x1, x5, e32, m1
+    lw x6, 28(x0)
+    beq x1, x6, c3        # AVL 2 < VLMAX
+    beq x0, x0, report
+c3: lw x3, 16(x0)
+    vsetvli x0, x0, e32   # Keeps vl = 2
+    vle32.v v1, (x20)
+    vse32.v v1, (x22)     # Writes out[0..1] only
+    lw x10, 60(x0)
+    lw x11, 44(x0)
+    beq x10, x11, c3b
+    beq x0, x0, report
+c3b:
+    lw x10, 64(x0)        # out[2] untouched
+    lw x11, 84(x0)
+    beq x10, x11, c4
+    beq x0, x0, report
+c4: lw x3, 20(x0)
+    lw x5, 32(x0)
+    vsetvli x1, x5, e32   # AVL 9 > VLMAX
+    beq x1, x7, c5
+    beq x0, x0, report
+c5: lw x3, 24(x0)
+    lw x5, 80(x0)
+    vsetvli x1, x5, e32   # AVL 0: vl = 0
+    beq x1, x0, c5b
+    beq x0, x0, report
+c5b:
+    vse32.v v2, (x22)     # Stores nothing
+    lw x10, 56(x0)
+    lw x11, 40(x0)
+    beq x10, x11, ok
+    beq x0, x0, report
+ok: lw x3, 4(x0)
+report:
+    sw x3, 0(x0)
+#= mem[0] = 1  halted = 0
@@ -0,0 +1,56 @@
+# vsll.vi vd, vs2, uimm5: vd[i] = vs2[i] << uimm5.
+# Self-checking: tohost (mem[0]) ends 1 on pass, (N << 1) | 1 if case N fails.
+#@ vsll_vi vlen=128
+.data
+tohost: .word 0           # 0x00
+pass:   .word 1           # 0x04
+case1:  .word 3           # 0x08: failure codes
+case2:  .word 5
+case3:  .word 7
+case4:  .word 9
+a:      .word 1           # 0x18: vs2
+        .word -1
+        .word 0x10000000
+        .word 5
+exp:    .word 8           # 0x28: expected
+        .word -8
+        .word 0x80000000
+        .word 40
+out:    .word 0           # 0x38: vse32.v target
+        .word 0
+        .word 0
+        .word 0
+pa:     .word 24          # 0x48: pointers
+pout:   .word 56
+
+.text
+    lw x20, 72(x0)        # &a
+    lw x22, 76(x0)        # &out
+    vsetvli x1, x0, e32
+    vle32.v v1, (x20)
+    vsll.vi v3, v1, 3
+    vse32.v v3, (x22)
+    lw x3, 8(x0)
+    lw x10, 56(x0)
+    lw x11, 40(x0)
+    beq x10, x11, e1
+    beq x0, x0, report
+e1: lw x3, 12(x0)
+    lw x10, 60(x0)
+    lw x11, 44(x0)
+    beq x10, x11, e2
+    beq x0, x0, report
+e2: lw x3, 16(x0)
+    lw x10, 64(x0)
+    lw x11, 48(x0)
+    beq x10, x11, e3
+    beq x0, x0, report
+e3: lw x3, 20(x0)
+    lw x10, 68(x0)
+    lw x11, 52(x0)
+    beq x10, x11, ok
+    beq x0, x0, report
+ok: lw x3, 4(x0)
+report:
+    sw x3, 0(x0)
+#= mem[0] = 1  halted = 0
@@ -0,0 +1,46 @@
+#ifndef ASM_ARENA_HPP
+#define ASM_ARENA_HPP
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+/**
+ * Bump allocator for assembler text. Parsed instructions point into it, so a
+ * program costs one heap allocation per chunk instead of several per line,
+ * and everything is released at once by reset() or by destroying the arena.
+ * Nothing is freed individually; copy live records into a fresh arena to
+ * drop dead ones.
+ */
+class AsmArena {
+public:
+    static const size_t CHUNK_BYTES = 64 * 1024;
+
+    AsmArena();
+    AsmArena(AsmArena&& other) noexcept;
+    AsmArena& operator=(AsmArena&& other) noexcept;
+    AsmArena(const AsmArena&) = delete;
+    AsmArena& operator=(const AsmArena&) = delete;
+
+    // bytes of storage valid until reset(); larger requests get their own chunk
+    char* alloc(size_t bytes);
+    // Hand back the tail of the latest alloc(), keeping its first bytes
+    void shrink_last(char* p, size_t bytes);
+    const char* copy(const char* src, size_t bytes);
+
+    // Frees every record; the first chunk is kept for the next program
+    void reset();
+
+    size_t bytes_used() const { return used; }
+    size_t chunk_count() const { return chunks.size(); }
+
+private:
+    std::vector<std::unique_ptr<char[]>> chunks;
+    char* cursor;      // Next free byte in chunks.back()
+    size_t remaining;  // Free bytes after cursor
+    size_t first_size; // Size of chunks[0], kept by reset()
+    char* last;        // Start of the latest allocation (for shrink_last)
+    size_t used;
+};
+
+#endif
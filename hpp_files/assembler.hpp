@@ -5,6 +5,8 @@
 #include <fstream>
 #include <sstream>
 #include <string>
+#include <string_view>
+#include <cstdint>
 #include <vector>
 #include <map>
 #include <iomanip>
@@ -23,11 +25,40 @@ struct InstructionInfo {
         : type(t), op(o), f3(f3_val), f7(f7_val) {}
 };
 
+// Slice of an instruction's text record (see ParsedInstruction)
+struct TextSpan {
+    uint16_t offset;
+    uint16_t length;
+};
+
+const size_t MAX_OPERANDS = 6;         // vsetvli rd, rs1, e32, m1, ta, ma
+const size_t MAX_LINE_LENGTH = 16383;  // Keeps a text record within 16-bit offsets
+const uint16_t NO_MNEMONIC = 0xFFFF;
+
+/**
+ * One parsed instruction, trivially copyable. Its text lives in an AsmArena
+ * record: the source line, followed by copies of any operands that had
+ * whitespace inside them. The mnemonic and operands are spans into that
+ * record, so the instruction stays valid as long as the arena does.
+ */
 struct ParsedInstruction {
-    string mnemonic;
-    vector<string> operands;
+    const char* text;        // Text record (source line first)
+    uint16_t text_length;    // Source line
+    uint16_t record_length;  // Whole record, for copying it to another arena
+    uint16_t mnemonic_id;    // mnemonicId(mnemonic()), NO_MNEMONIC if unknown
+    TextSpan mnemonic_span;
+    uint8_t operand_count;
+    TextSpan operand_spans[MAX_OPERANDS];
     unsigned int address;
-    string originalLine;
+    unsigned int size;  // 4, or 2 when emitted as an RVC encoding
+    bool rvc;           // Under ".option rvc"
+    unsigned int line;  // 1-based index into the source lines it was parsed from
+
+    string_view source_line() const { return string_view(text, text_length); }
+    string_view mnemonic() const { return string_view(text + mnemonic_span.offset, mnemonic_span.length); }
+    string_view operand(size_t i) const {
+        return string_view(text + operand_spans[i].offset, operand_spans[i].length);
+    }
 };
 
 extern map<string, InstructionInfo> INSTRUCTION_SET;
@@ -35,4 +66,9 @@ extern map<unsigned int, unsigned int> INSTRUCTION_MEMORY;
 extern map<string, unsigned int> SYMBOL_TABLE;
 extern map<unsigned int, int32_t> DATA_SEGMENT; 
 
+// Mnemonic IDs are positions in INSTRUCTION_SET (instruction_set.cpp)
+uint16_t mnemonicId(string_view mnemonic);
+const InstructionInfo* instructionInfo(uint16_t id); // nullptr for NO_MNEMONIC
+const string& mnemonicName(uint16_t id);
+
 #endif
\ No newline at end of file
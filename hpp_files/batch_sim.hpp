@@ -0,0 +1,87 @@
+#ifndef BATCH_SIM_HPP
+#define BATCH_SIM_HPP
+
+#include "memory.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <vector>
+
+template <int XLEN, class Plugins> class RISCV_SimulatorT;
+template <class... Plugins> struct SimPlugins;
+struct StatsCounter;
+
+// How a batch entry stopped
+enum BatchStatus : uint8_t {
+    BATCH_PENDING = 0,  // Not run yet
+    BATCH_FINISHED,     // Ran off the end of .text with the pipeline drained
+    BATCH_HALTED,       // Trap with no handler
+    BATCH_TIMEOUT       // Hit max_cycles
+};
+
+struct BatchConfig {
+    uint32_t mem_bytes;    // Data memory per state (copied in and out)
+    uint64_t max_cycles;   // Per state
+    unsigned int threads;  // 0: one per hardware thread
+    uint32_t tile_bytes;   // Target state bytes per tile (~L2 share of one worker)
+
+    BatchConfig() : mem_bytes(DATA_MEMORY_SIZE), max_cycles(100000), threads(0), tile_bytes(256 * 1024) {}
+};
+
+/**
+ * Runs one assembled program from many initial states on the pipelined
+ * simulator, for input sweeps and randomized grading.
+ *
+ * States live in one contiguous table: 32 registers then mem_bytes of data
+ * memory per state, followed by separate cycle/instruction/status columns.
+ * Fill in the initial states with regs()/memory() (every state starts from
+ * the data segment), call run(), then read the final states from the same
+ * rows. Workers take tiles of consecutive states sized to tile_bytes, so a
+ * tile's rows stay in cache while its states run.
+ */
+class BatchSimulator {
+public:
+    BatchSimulator(const std::map<unsigned int, unsigned int>& imem, const std::map<unsigned int, int32_t>& data,
+                   uint32_t text_end, size_t states, const BatchConfig& config = BatchConfig());
+
+    size_t size() const { return count; }
+    uint32_t mem_bytes() const { return cfg.mem_bytes; }
+
+    // Rows of the state table; initial state before run(), final state after
+    int32_t* regs(size_t state) { return (int32_t*)&table[state * row_words]; }
+    uint8_t* memory(size_t state) { return (uint8_t*)&table[state * row_words + 32]; }
+    const int32_t* regs(size_t state) const { return (const int32_t*)&table[state * row_words]; }
+    const uint8_t* memory(size_t state) const { return (const uint8_t*)&table[state * row_words + 32]; }
+    int32_t mem_word(size_t state, uint32_t addr) const;
+
+    void run();
+
+    uint64_t cycles(size_t state) const { return cycle_col[state]; }
+    uint64_t instructions(size_t state) const { return inst_col[state]; }
+    BatchStatus status(size_t state) const { return (BatchStatus)status_col[state]; }
+
+    size_t tile_states() const { return tile; }
+    unsigned int thread_count() const { return workers; }
+
+private:
+    // Workers keep the counters and leave the trace out (StatsPlugins)
+    typedef RISCV_SimulatorT<32, SimPlugins<StatsCounter>> Core;
+
+    void run_tile(size_t first, size_t last, Core& sim);
+    void run_state(size_t state, Core& sim);
+
+    std::map<unsigned int, unsigned int> program;
+    uint32_t end_pc;
+    BatchConfig cfg;
+    size_t count;
+    size_t row_words;   // 32 + mem_bytes / 4
+    size_t tile;
+    unsigned int workers;
+
+    std::vector<uint32_t> table;  // [count][row_words]
+    std::vector<uint64_t> cycle_col;
+    std::vector<uint64_t> inst_col;
+    std::vector<uint8_t>  status_col;
+};
+
+#endif
@@ -0,0 +1,26 @@
+#ifndef COMPRESSED_HPP
+#define COMPRESSED_HPP
+
+#include "assembler.hpp"
+#include <cstdint>
+
+// Code size of an assembled program (RVC vs. all 32-bit encodings)
+struct CodeSizeStats {
+    unsigned int instructions;
+    unsigned int compressed;       // Emitted as 16-bit encodings
+    unsigned int bytes;            // Actual .text size
+    unsigned int uncompressed_bytes;
+};
+
+// Assembler side
+bool isCompressible(const ParsedInstruction& inst);
+bool fitsCompressedBranch(int offset);
+unsigned int encodeCompressed(const ParsedInstruction& inst, int offset);
+CodeSizeStats computeCodeSize(const vector<ParsedInstruction>& instructions);
+
+// Fetch side: expand a 16-bit encoding to its 32-bit equivalent (0 if unsupported)
+uint32_t expandCompressed(uint16_t inst);
+
+inline bool isCompressedEncoding(uint32_t inst) { return (inst & 0x3) != 0x3; }
+
+#endif
@@ -0,0 +1,57 @@
+#ifndef DECODE_CACHE_HPP
+#define DECODE_CACHE_HPP
+
+#include <cstdint>
+#include <cstring>
+#include "pipeline_structs.hpp"
+
+const unsigned int DECODE_CACHE_ENTRIES = 256; // Power of two
+
+// Fields the ID stage extracts from an instruction word
+struct DecodedInst {
+    bool     valid;
+    uint32_t tag;      // Physical address of the instruction
+    uint32_t IR;
+    int32_t  IMM;
+    uint8_t  opcode;
+    uint8_t  rd;
+    uint8_t  rs1;
+    uint8_t  rs2;
+    uint8_t  func3;
+    uint8_t  func7;
+    uint8_t  ctrl;       // CTRL_* bits latched into ID/EX (CTRL_VREG_WRITE: writes vector register rd)
+    bool     needs_rs1;
+    bool     needs_rs2;
+    bool     needs_vs1;  // Vector sources live in the rs1/rs2/rd fields
+    bool     needs_vs2;
+    bool     needs_vs3;
+};
+
+// Direct-mapped predecode cache keyed by physical instruction address.
+// Entries must be invalidated when the code they cover is overwritten.
+class DecodeCache {
+public:
+    DecodeCache() { flush(); }
+
+    const DecodedInst* lookup(uint32_t addr) const {
+        const DecodedInst& e = entries[index(addr)];
+        return (e.valid && e.tag == addr) ? &e : nullptr;
+    }
+
+    DecodedInst& slot(uint32_t addr) { return entries[index(addr)]; }
+
+    void invalidate(uint32_t addr) {
+        DecodedInst& e = entries[index(addr)];
+        if (e.tag == addr) e.valid = false;
+    }
+
+    void flush() { std::memset(entries, 0, sizeof(entries)); }
+
+private:
+    // Instructions are 2-byte aligned once RVC encodings are mixed in
+    static unsigned int index(uint32_t addr) { return (addr >> 1) & (DECODE_CACHE_ENTRIES - 1); }
+
+    DecodedInst entries[DECODE_CACHE_ENTRIES];
+};
+
+#endif
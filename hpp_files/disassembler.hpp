@@ -0,0 +1,45 @@
+#ifndef DISASSEMBLER_HPP
+#define DISASSEMBLER_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+// Longest text disassemble() produces, including the terminator
+const size_t DISASM_MAX = 48;
+
+/**
+ * Table-driven disassembler for the instructions in INSTRUCTION_SET (the
+ * table the encoder uses), plus RVC encodings, which print as "c." + their
+ * 32-bit expansion. Branch targets are PC-relative (".+8"), so the text
+ * depends only on the word. Writes at most size bytes (always terminated)
+ * and never allocates; returns the text length.
+ */
+size_t disassemble(uint32_t word, char* buf, size_t size);
+
+/**
+ * Direct-mapped cache of disassembled words: a loop shows the same few
+ * words every cycle, so displays and traces format each one once.
+ */
+class DisasmCache {
+public:
+    static const size_t ENTRIES = 256;
+
+    DisasmCache();
+
+    // Text for word; the pointer stays valid until another word maps to the same entry
+    const char* lookup(uint32_t word);
+
+    uint64_t hits() const { return hit_count; }
+    uint64_t misses() const { return miss_count; }
+
+private:
+    struct Entry {
+        uint32_t word;
+        bool     valid;
+        char     text[DISASM_MAX];
+    };
+    Entry entries[ENTRIES];
+    uint64_t hit_count, miss_count;
+};
+
+#endif
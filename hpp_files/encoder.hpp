@@ -3,12 +3,22 @@
 
 #include "assembler.hpp"
 #include "utils.hpp"
+#include "xlen.hpp"
 
 unsigned int encodeRType(string rd, string rs1, string rs2, string f3, string f7, string op);
+// XLEN selects the shift-amount width (5 bits on RV32, 6 on RV64) and the
+// RV64-only instructions accepted; instantiated for 32 and 64.
+template <int XLEN = RISCV_XLEN>
 unsigned int encodeIType(string rd, string rs1, int imm, string f3, string op, const string& mnemonic);
 unsigned int encodeSType(string rs1, string rs2, int imm, string f3, string op);
 unsigned int encodeBType(string rs1, string rs2, int imm, string f3, string op);
 unsigned int encodeJType(string rd, int imm, string op);
+unsigned int encodeVType(string vd, string vs2, string vs1, string f3, string f6, string op);
+unsigned int encodeVMemType(string vd, string rs1, string width, string op);
+unsigned int encodeVsetvli(string rd, string rs1, const vector<string>& vtype, string op);
+template <int XLEN = RISCV_XLEN>
+unsigned int encodeInstruction(const ParsedInstruction& inst, const map<string, unsigned int>& symbols);
+template <int XLEN = RISCV_XLEN>
 map<unsigned int, unsigned int> translateToOpcode(const vector<ParsedInstruction>& instructions);
 
 #endif
@@ -0,0 +1,97 @@
+#ifndef INCREMENTAL_ASM_HPP
+#define INCREMENTAL_ASM_HPP
+
+#include "assembler.hpp"
+#include "asm_arena.hpp"
+
+// What one editor line holds, independent of the section it lands in
+enum AsmLineKind {
+    ASM_BLANK,        // Empty, comment-only, or label-only
+    ASM_SECTION_DATA, // .data
+    ASM_SECTION_TEXT, // .text
+    ASM_SKIP,         // .global ... (ignored entirely, label included)
+    ASM_OPTION_RVC,   // .option rvc
+    ASM_OPTION_NORVC, // .option norvc
+    ASM_WORD,         // .word value (emitted only in .data)
+    ASM_DIRECTIVE,    // Any other directive
+    ASM_INSTRUCTION   // Emitted only in .text
+};
+
+struct AsmLine {
+    AsmLineKind kind;
+    string label;           // Defined here ("" if none)
+    ParsedInstruction inst; // ASM_INSTRUCTION: address, size and rvc set by layout; text in text_arena
+    string target;          // Branch/jump label operand ("" if none)
+    string parse_error;     // Reported only if the line lands in .text
+    int32_t value;          // ASM_WORD
+    bool emitted;           // In .text (instruction) or .data (word) after layout
+
+    // Inputs of the cached encoding; a mismatch triggers a re-encode
+    bool encoded;
+    unsigned int encoded_size;
+    bool encoded_rvc;
+    int encoded_offset;     // Target address - own address
+    unsigned int word;
+};
+
+struct IncrementalAsmStats {
+    uint64_t edits;
+    uint64_t lines_parsed;   // Lines re-parsed (only the edited ones)
+    uint64_t encodes;        // Instructions re-encoded
+    uint64_t last_parsed;    // For the last edit
+    uint64_t last_encoded;
+};
+
+/**
+ * Assembler that keeps per-line parse results for editor source, so an edit
+ * of lines i..j re-parses only those lines. Layout (sections, addresses,
+ * labels, RVC relaxation) is recomputed from the cached lines on every edit,
+ * which is integer work only; an instruction is re-encoded only if its line
+ * changed or its size, RVC mode or label offset moved.
+ *
+ * Output matches a full assemble of the same source (parser.cpp, encoder.cpp).
+ * Errors are reported with 1-based line numbers instead of exiting.
+ */
+class IncrementalAssembler {
+public:
+    IncrementalAssembler();
+
+    // Replace everything (same as edit(0, line_count(), lines of source))
+    bool assemble(const string& source);
+    // Replace source lines [first, first + removed) with lines; false on an assembly error
+    bool edit(size_t first, size_t removed, const vector<string>& lines);
+
+    size_t line_count() const { return lines.size(); }
+    const string& error() const { return err; }
+    size_t error_line() const { return err_line; } // 1-based, 0 if none
+
+    // Valid after a successful edit. Instruction text points into this
+    // assembler and is valid until the next edit (see copyToArena).
+    vector<ParsedInstruction> instructions() const;
+    map<unsigned int, unsigned int> text_image() const;
+    const map<string, unsigned int>& symbols() const { return symbol_table; }
+    const map<unsigned int, int32_t>& data() const { return data_segment; }
+    // Editor line (1-based) of each instruction, in address order
+    vector<size_t> instruction_lines() const;
+
+    const IncrementalAsmStats& get_stats() const { return stats; }
+
+private:
+    void parse_line(const string& raw, AsmLine& out);
+    bool layout();
+    bool relax();
+    bool encode();
+    bool set_error(size_t index, const string& message);
+    void compact();
+
+    vector<AsmLine> lines;
+    AsmArena text_arena;  // Text records of the lines' instructions
+    size_t dead_bytes;    // Records of replaced lines still in text_arena
+    map<string, unsigned int> symbol_table;
+    map<unsigned int, int32_t> data_segment;
+    string err;
+    size_t err_line;
+    IncrementalAsmStats stats;
+};
+
+#endif
@@ -0,0 +1,99 @@
+#ifndef LANE_SIM_HPP
+#define LANE_SIM_HPP
+
+#include "memory.hpp"
+#include <cstdint>
+#include <map>
+#include <vector>
+
+// Pad lane arrays to the widest SIMD width used by the kernels (AVX2: 8 x i32)
+const unsigned int LANE_PAD = 8;
+
+// Predecoded instruction shared by every lane
+struct LaneInst {
+    bool     valid;
+    uint8_t  opcode;
+    uint8_t  rd;
+    uint8_t  rs1;
+    uint8_t  rs2;
+    uint8_t  func3;
+    uint8_t  func7;
+    uint8_t  size;    // 2 (RVC) or 4
+    int32_t  IMM;
+};
+
+struct LaneRunStats {
+    uint64_t steps;                  // Instructions issued (one per distinct PC group)
+    uint64_t instance_instructions;  // Sum of active lanes over all steps
+    uint64_t lane_slots;             // steps * lanes: utilization = instance_instructions / lane_slots
+    uint64_t divergent_steps;        // Steps issued with only part of the live lanes active
+};
+
+/**
+ * Functional (non-pipelined) model of the RV32 subset (SLL, SLT, SLLI, LW, SW,
+ * BEQ, BLT, FENCE.I, plus RVC) running one program for many independent
+ * states at once. State is structure-of-arrays, e.g. register
+ * x5 of every lane is one contiguous row, so each ALU instruction is a
+ * single SIMD kernel call across lanes (vector_kernels.cpp).
+ *
+ * Divergence: lanes keep their own PC. While they agree (the common case)
+ * a shared PC is used; after a split branch the lowest PC among live lanes
+ * issues next with the other lanes masked off, which reconverges if/else
+ * and loop exits. Lanes stop when they run off .text or fault.
+ */
+class LaneSimulator {
+public:
+    LaneSimulator(const std::map<unsigned int, unsigned int>& imem, unsigned int lanes,
+                  uint32_t mem_bytes = DATA_MEMORY_SIZE);
+
+    unsigned int lanes() const { return n; }
+
+    // Initial state (data segment is copied to every lane)
+    void load_data(const std::map<unsigned int, int32_t>& data);
+    void set_reg(unsigned int lane, int idx, int32_t val);
+    void set_mem_word(unsigned int lane, uint32_t addr, int32_t val);
+
+    int32_t  get_reg(unsigned int lane, int idx) const { return regs[idx * stride + lane]; }
+    int32_t  get_mem_word(unsigned int lane, uint32_t addr) const;
+    uint32_t get_pc(unsigned int lane) const { return (converged && alive[lane]) ? shared_pc : pc[lane]; }
+    bool     lane_faulted(unsigned int lane) const { return fault[lane] != 0; }
+    bool     finished() const { return live == 0; }
+
+    // Run until every lane has finished or max_steps instructions were issued
+    uint64_t run(uint64_t max_steps);
+    const LaneRunStats& get_stats() const { return stats; }
+
+private:
+    int32_t* row(int idx) { return &regs[idx * stride]; }
+    const LaneInst* fetch(uint32_t addr) const;
+    void execute(const LaneInst& inst, uint32_t at, const int32_t* mask);
+    void write_rd(uint8_t rd, const int32_t* value, const int32_t* mask);
+    void memory_access(const LaneInst& inst, const int32_t* mask);
+    void kill_lane(unsigned int lane, bool faulted);
+    uint8_t read8(unsigned int lane, uint32_t addr) const;
+    void write8(unsigned int lane, uint32_t addr, uint8_t val);
+
+    unsigned int n;       // Lanes
+    unsigned int stride;  // n rounded up to LANE_PAD
+    uint32_t mem_bytes;
+
+    std::vector<int32_t> regs;    // [32][stride]
+    std::vector<int32_t> mem;     // [mem_bytes / 4][stride]; word-interleaved across lanes
+    std::vector<uint32_t> pc;     // Per-lane PC, valid while diverged
+    std::vector<int32_t> alive;   // -1 running, 0 finished/faulted
+    std::vector<uint8_t> fault;
+    std::vector<int32_t> active;  // Scratch: lanes issuing this step
+    std::vector<int32_t> result;  // Scratch: ALU output before the masked write
+    std::vector<int32_t> cond;    // Scratch: branch outcome
+
+    bool converged;               // All live lanes sit at shared_pc
+    uint32_t shared_pc;
+    unsigned int live;
+
+    std::vector<LaneInst> program; // Indexed by (addr - text_start) / 2
+    uint32_t text_start;
+
+    LaneRunStats stats;
+};
+
+#endif
@@ -0,0 +1,88 @@
+#ifndef MEMORY_HPP
+#define MEMORY_HPP
+
+#include <cstdint>
+#include <cstddef>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+const uint32_t DATA_MEMORY_SIZE = 128; // Default addressable window (0x00-0x7F)
+
+class PageArena;
+
+// Sparse byte-addressable memory. 4 KiB pages are allocated on first write;
+// reads from untouched pages return 0. Accesses at or beyond limit() are
+// rejected by in_bounds() so callers can report them like the old fixed array.
+// With a PageArena, pages come from it instead of the heap; a write that
+// needs a page when the arena is empty is dropped and sets exhausted().
+class PagedMemory {
+public:
+    static const uint32_t PAGE_SHIFT = 12;
+    static const uint32_t PAGE_SIZE  = 1u << PAGE_SHIFT;
+    static const uint32_t PAGE_MASK  = PAGE_SIZE - 1;
+
+    explicit PagedMemory(uint64_t limit = DATA_MEMORY_SIZE);
+    ~PagedMemory();
+    PagedMemory(const PagedMemory&) = delete;
+    PagedMemory& operator=(const PagedMemory&) = delete;
+
+    uint64_t limit() const { return mem_limit; }
+    void set_limit(uint64_t limit) { mem_limit = limit; }
+    bool in_bounds(uint32_t addr, uint32_t len) const {
+        return (uint64_t)addr + len <= mem_limit;
+    }
+
+    uint8_t  read8(uint32_t addr) const;
+    void     write8(uint32_t addr, uint8_t val);
+    uint32_t read32(uint32_t addr) const;  // Little endian
+    void     write32(uint32_t addr, uint32_t val);
+    void     read_block(uint32_t addr, uint8_t* dst, uint32_t len) const; // Page-wise copy out
+    bool     write_block(uint32_t addr, const uint8_t* src, uint32_t len);  // Page-wise copy in; false if a page was refused
+
+    void   clear();
+    void   restore_from(const PagedMemory& image); // Become a copy of image, reusing allocated pages
+    size_t page_count() const { return pages.size(); }
+
+    // Take pages from arena from now on (nullptr: the heap); current pages move into it
+    void set_arena(PageArena* arena);
+    // A write was dropped for lack of a page; cleared by clear() and restore_from()
+    bool exhausted() const { return out_of_pages; }
+
+private:
+    uint8_t*       page_for_write(uint32_t addr); // nullptr when the arena is empty
+    const uint8_t* page_for_read(uint32_t addr) const;
+    uint8_t*       new_page();
+    void           free_page(uint8_t* page);
+
+    uint64_t mem_limit;
+    std::unordered_map<uint32_t, uint8_t*> pages;
+    PageArena* arena;
+    bool out_of_pages;
+
+    // One-entry lookup cache: consecutive accesses usually hit the same page
+    mutable uint32_t last_page_num;
+    mutable uint8_t* last_page;
+};
+
+// Fixed pool of zeroed pages, allocated as one block up front and shared by
+// the PagedMemory instances of one simulator (live memory and reset image),
+// so a session's resident data memory has a hard cap and its pages never
+// come from the heap after the session is created.
+class PageArena {
+public:
+    explicit PageArena(uint32_t pages);
+
+    uint8_t* acquire(); // Zeroed page, or nullptr when all are in use
+    void     release(uint8_t* page);
+
+    uint32_t capacity() const { return total; }
+    uint32_t in_use() const { return total - (uint32_t)free_pages.size(); }
+
+private:
+    std::unique_ptr<uint8_t[]> block;
+    std::vector<uint8_t*> free_pages;
+    uint32_t total;
+};
+
+#endif
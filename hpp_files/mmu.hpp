@@ -0,0 +1,92 @@
+#ifndef MMU_HPP
+#define MMU_HPP
+
+#include "memory.hpp"
+#include <cstdint>
+#include <vector>
+
+// Sv32 satp: [31 MODE] [30:22 ASID] [21:0 PPN]
+const uint32_t SATP_MODE_SV32 = 0x80000000;
+const uint32_t SATP_PPN_MASK  = 0x003FFFFF;
+
+// Sv32 PTE: [31:20 PPN[1]] [19:10 PPN[0]] [9:8 RSW] [7 D] [6 A] [5 G] [4 U] [3 X] [2 W] [1 R] [0 V]
+const uint32_t PTE_V = 1 << 0;
+const uint32_t PTE_R = 1 << 1;
+const uint32_t PTE_W = 1 << 2;
+const uint32_t PTE_X = 1 << 3;
+const uint32_t PTE_A = 1 << 6;
+const uint32_t PTE_D = 1 << 7;
+
+// Trap causes (mcause encoding)
+const uint32_t CAUSE_FETCH_ACCESS = 1;
+const uint32_t CAUSE_ILLEGAL_INSTRUCTION = 2;
+const uint32_t CAUSE_LOAD_ACCESS  = 5;
+const uint32_t CAUSE_STORE_ACCESS = 7;
+const uint32_t CAUSE_FETCH_PAGE_FAULT = 12;
+const uint32_t CAUSE_LOAD_PAGE_FAULT  = 13;
+const uint32_t CAUSE_STORE_PAGE_FAULT = 15;
+
+// Entries per TLB until configure_tlbs() changes them
+const size_t DEFAULT_TLB_ENTRIES = 16;
+
+// Cycles charged per PTE read during a page-table walk
+const unsigned int PTE_ACCESS_CYCLES = 1;
+
+enum class AccessType { Fetch, Load, Store };
+
+struct TLBEntry {
+    bool     valid;
+    bool     megapage;  // Level-1 leaf (4 MiB)
+    uint32_t vpn;       // VA[31:12]
+    uint32_t ppn;       // PA[33:12]
+    uint32_t perms;     // PTE R/W/X/D bits
+    uint64_t last_use;  // LRU stamp
+};
+
+// Fully associative TLB with LRU replacement
+class TLB {
+public:
+    explicit TLB(size_t entries = DEFAULT_TLB_ENTRIES);
+
+    void resize(size_t entries);
+    void flush();
+    size_t size() const { return entries.size(); }
+
+    const TLBEntry* lookup(uint32_t vaddr);
+    void insert(uint32_t vaddr, uint32_t ppn, uint32_t perms, bool megapage);
+
+    uint64_t hits;
+    uint64_t misses;
+
+private:
+    std::vector<TLBEntry> entries;
+    uint64_t stamp;
+};
+
+// Sv32 translation with separate I-TLB and D-TLB. Page-table walks read
+// (and update A/D bits in) the simulated physical memory.
+class Sv32MMU {
+public:
+    explicit Sv32MMU(PagedMemory& mem);
+
+    void set_satp(uint32_t value);
+    uint32_t get_satp() const { return satp; }
+    bool enabled() const { return (satp & SATP_MODE_SV32) != 0; }
+
+    // Returns 0 on success (paddr filled in), otherwise the trap cause.
+    // walk_cycles is set to the stall cost of any page-table walk performed.
+    uint32_t translate(uint32_t vaddr, AccessType type, uint32_t& paddr, unsigned int& walk_cycles);
+
+    TLB itlb;
+    TLB dtlb;
+    uint64_t walks;
+
+private:
+    uint32_t walk(uint32_t vaddr, AccessType type, uint32_t& ppn, uint32_t& perms,
+                  bool& megapage, unsigned int& walk_cycles);
+
+    PagedMemory& memory;
+    uint32_t satp;
+};
+
+#endif
@@ -3,11 +3,20 @@
 
 #include "assembler.hpp"
 #include "utils.hpp"
+#include "asm_arena.hpp"
+
+// Holds the text of instructions parsed without an explicit arena; reset it
+// before assembling a new program
+extern AsmArena PARSE_ARENA;
 
 vector<string> readAndPreprocess(const string& filename);
 map<string, unsigned int> buildSymbolTable(const vector<string>& lines);
-vector<ParsedInstruction> parseInstructions(const vector<string>& lines);
+map<string, unsigned int> buildSymbolTable(const vector<string>& lines, const vector<unsigned int>& sizes);
+vector<ParsedInstruction> parseInstructions(const vector<string>& lines, AsmArena& arena = PARSE_ARENA);
+bool parseInstructionLine(const string& line, size_t start, AsmArena& arena, ParsedInstruction& pInst, string& error);
+void copyToArena(vector<ParsedInstruction>& instructions, AsmArena& arena);
 bool validateInstructions(const vector<ParsedInstruction>& instructions);
 void parseDataSection(const vector<string>& lines);
+void relaxCompressed(vector<ParsedInstruction>& instructions, const vector<string>& lines);
 
 #endif
@@ -2,62 +2,113 @@
 #define PIPELINE_STRUCTS_HPP
 
 #include <cstdint>
+#include "xlen.hpp"
+
+// Control bits of a latch's ctrl byte. Decode sets them once and each stage
+// passes them on with a single store; a flush clears them with the latch.
+const uint8_t CTRL_REG_WRITE  = 0x01;
+const uint8_t CTRL_MEM_READ   = 0x02;
+const uint8_t CTRL_MEM_WRITE  = 0x04;
+const uint8_t CTRL_BRANCH     = 0x08; // BEQ, BLT
+const uint8_t CTRL_VREG_WRITE = 0x10; // Vector destination (rd names a v register)
+const uint8_t CTRL_COND       = 0x20; // EX/MEM: ALU condition (Zero/Less Than)
+
+// Latch fields run from widest to narrowest so the structs carry little
+// interior padding, though most still end in tail padding. Latches are only
+// value-initialized ("= {}") or copied whole. operator== compares field by
+// field, because the padding bytes are not guaranteed to match.
 
 // IF/ID Latch
-struct IF_ID {
+template <int XLEN>
+struct IF_ID_T {
+    typedef typename XlenTraits<XLEN>::uxlen_t uxlen_t;
+
+    uxlen_t  NPC;     // Next PC (PC + 4)
+    uxlen_t  PC;      // Current PC (for display)
     uint32_t IR;      // Instruction Register
-    uint32_t NPC;     // Next PC (PC + 4)
-    uint32_t PC;      // Current PC (for display)
+    uint32_t PA;      // Physical fetch address (decode cache key)
+    uint8_t  trap;    // Pending fetch fault cause (0 = none)
+
+    bool operator==(const IF_ID_T& o) const {
+        return NPC == o.NPC && PC == o.PC && IR == o.IR && PA == o.PA && trap == o.trap;
+    }
+    bool operator!=(const IF_ID_T& o) const { return !(*this == o); }
 };
 
 // ID/EX Latch
-struct ID_EX {
+template <int XLEN>
+struct ID_EX_T {
+    typedef typename XlenTraits<XLEN>::uxlen_t uxlen_t;
+    typedef typename XlenTraits<XLEN>::sxlen_t sxlen_t;
+
+    uxlen_t  NPC;
+    uxlen_t  PC;
+    uxlen_t  A;       // rs1 value
+    uxlen_t  B;       // rs2 value
+    sxlen_t  IMM;     // Immediate (Sign Extended)
     uint32_t IR;
-    uint32_t NPC;
-    uint32_t A;       // rs1 value
-    uint32_t B;       // rs2 value
-    int32_t  IMM;     // Immediate (Sign Extended)
-    
-    // Control Signals
+
+    uint8_t  opcode;
     uint8_t  func3;
     uint8_t  func7;
-    uint8_t  opcode;
     uint8_t  rd;
-    uint8_t  rs1;     // Needed for Hazard Detection in EX (if forwarding, but we keep for debug)
+    uint8_t  rs1;     // Vector operands and vsetvli read these in EX
     uint8_t  rs2;
-    
-    // Control Flags
-    bool RegWrite;
-    bool MemRead;
-    bool MemWrite;
-    bool Branch;      // BEQ, BLT
-    uint8_t ALUOp;    // Custom codes for ALU control
+    uint8_t  ctrl;    // CTRL_* bits
+    uint8_t  trap;    // Fetch fault carried down to EX (0 = none)
+
+    bool operator==(const ID_EX_T& o) const {
+        return NPC == o.NPC && PC == o.PC && A == o.A && B == o.B && IMM == o.IMM && IR == o.IR &&
+               opcode == o.opcode && func3 == o.func3 && func7 == o.func7 && rd == o.rd &&
+               rs1 == o.rs1 && rs2 == o.rs2 && ctrl == o.ctrl && trap == o.trap;
+    }
+    bool operator!=(const ID_EX_T& o) const { return !(*this == o); }
 };
 
 // EX/MEM Latch
-struct EX_MEM {
+template <int XLEN>
+struct EX_MEM_T {
+    typedef typename XlenTraits<XLEN>::uxlen_t uxlen_t;
+    typedef typename XlenTraits<XLEN>::sxlen_t sxlen_t;
+
+    uxlen_t  PC;      // For display
+    uxlen_t  B;       // Value to store (SW)
+    sxlen_t  ALUOutput;
     uint32_t IR;
-    int32_t  ALUOutput;
-    uint32_t B;       // Value to store (SW)
-    bool     cond;    // ALU condition (Zero/Less Than)
-    
-    // Pass-through Controls
+    uint32_t PA;      // Translated physical address (LW/SW)
     uint8_t  rd;
-    bool     RegWrite;
-    bool     MemRead;
-    bool     MemWrite;
-    bool     Branch;
+    uint8_t  ctrl;    // CTRL_* bits passed through from ID/EX, plus CTRL_COND
+
+    bool operator==(const EX_MEM_T& o) const {
+        return PC == o.PC && B == o.B && ALUOutput == o.ALUOutput && IR == o.IR && PA == o.PA &&
+               rd == o.rd && ctrl == o.ctrl;
+    }
+    bool operator!=(const EX_MEM_T& o) const { return !(*this == o); }
 };
 
 // MEM/WB Latch
-struct MEM_WB {
+template <int XLEN>
+struct MEM_WB_T {
+    typedef typename XlenTraits<XLEN>::uxlen_t uxlen_t;
+    typedef typename XlenTraits<XLEN>::sxlen_t sxlen_t;
+
+    uxlen_t  PC;      // For display
+    sxlen_t  ALUOutput;
+    sxlen_t  LMD;     // Load Memory Data
     uint32_t IR;
-    int32_t  ALUOutput;
-    int32_t  LMD;     // Load Memory Data
-    
-    // Pass-through Controls
     uint8_t  rd;
-    bool     RegWrite;
+    uint8_t  ctrl;    // CTRL_REG_WRITE, or CTRL_VREG_WRITE: the result waits in the vector unit's staging buffer
+
+    bool operator==(const MEM_WB_T& o) const {
+        return PC == o.PC && ALUOutput == o.ALUOutput && LMD == o.LMD && IR == o.IR && rd == o.rd && ctrl == o.ctrl;
+    }
+    bool operator!=(const MEM_WB_T& o) const { return !(*this == o); }
 };
 
-#endif
\ No newline at end of file
+// RV32 latches
+typedef IF_ID_T<32>  IF_ID;
+typedef ID_EX_T<32>  ID_EX;
+typedef EX_MEM_T<32> EX_MEM;
+typedef MEM_WB_T<32> MEM_WB;
+
+#endif
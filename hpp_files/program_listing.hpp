@@ -0,0 +1,41 @@
+#ifndef PROGRAM_LISTING_HPP
+#define PROGRAM_LISTING_HPP
+
+#include "assembler.hpp"
+#include <cstdint>
+
+/**
+ * Listing text and PC lookups for the loaded program, built once per
+ * assemble or reload. The PC index is a flat table with one slot per
+ * halfword of .text, so a lookup is a subtraction, a shift and a load.
+ */
+class ProgramListing {
+public:
+    ProgramListing();
+
+    // instructions in address order; imem supplies the encoded words
+    void build(const vector<ParsedInstruction>& instructions, const map<unsigned int, unsigned int>& imem);
+    void clear();
+
+    // "0x00000080 | 0x00002083 | lw x1, 0(x0)" per instruction
+    const string& text() const { return listing; }
+
+    // Listing row (instruction index) of the instruction starting at pc, or -1
+    int row_for_pc(uint64_t pc) const {
+        if (pc < INSTRUCTION_MEMORY_START || (pc & 1)) return -1;
+        uint64_t slot = (pc - INSTRUCTION_MEMORY_START) >> 1;
+        return (slot < slots.size()) ? slots[slot] : -1;
+    }
+    // 1-based source line of the instruction at pc, or 0
+    unsigned int line_for_pc(uint64_t pc) const {
+        int row = row_for_pc(pc);
+        return (row < 0) ? 0 : lines[row];
+    }
+
+private:
+    string listing;
+    vector<int32_t> slots;       // (pc - INSTRUCTION_MEMORY_START) / 2 -> row
+    vector<unsigned int> lines;  // row -> source line
+};
+
+#endif
@@ -0,0 +1,229 @@
+#ifndef RISCVSIM_H
+#define RISCVSIM_H
+
+/*
+ * libriscvsim: C API for the assembler and the pipelined simulator.
+ *
+ * A program is assembled once from a source buffer and is read-only after
+ * that, so any number of sessions (simulator instances) can be created from
+ * it, on any threads. Every call on a session takes that session's lock:
+ * different sessions run in parallel, and calls on one session from several
+ * threads are serialized. Functions returning int return an RVSIM_* status;
+ * on failure rvsim_last_error() describes it. Functions returning a value
+ * return 0 for a NULL session or an argument out of range.
+ *
+ * Fields are only ever added to the end of the structs below; pass
+ * sizeof(struct) where a size is asked for and older callers keep working.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define RVSIM_API_VERSION 3
+
+// Same values as SimStatus (sim_status.hpp) and the SIM_* constants in JS
+enum rvsim_status {
+    RVSIM_OK = 0,
+    RVSIM_ERR_NOT_INITIALIZED,  // NULL session or program
+    RVSIM_ERR_INVALID_ARGUMENT, // Index, address or size out of range
+    RVSIM_ERR_ASSEMBLY,         // Source failed to assemble
+    RVSIM_ERR_EXCEPTION,        // Simulator threw while running
+    RVSIM_ERR_UNSUPPORTED,      // Not available for this session
+    RVSIM_ERR_LIMIT             // A limit of the session was reached (see rvsim_limits)
+};
+
+// rvsim_create flags
+#define RVSIM_TRACE 1u // Per-cycle text trace (stdout, or rvsim_set_trace); about 10x slower per cycle
+
+// Memory words listed per rvsim_take_delta
+#define RVSIM_DELTA_MAX_WORDS 256
+
+typedef struct rvsim_program rvsim_program;
+typedef struct rvsim_session rvsim_session;
+typedef struct rvsim_pool rvsim_pool;
+
+// Receives trace text in chunks; chunks do not follow line boundaries
+typedef void (*rvsim_trace_fn)(const char* text, size_t length, void* user);
+
+// Counters since the last reset (mirrors SimStats)
+typedef struct rvsim_stats {
+    uint64_t cycles;
+    uint64_t instructions;       // Retired in WB
+    uint64_t stall_cycles;       // Data hazard bubbles
+    uint64_t flushes;            // Taken branches / traps
+    uint64_t itlb_hits, itlb_misses;
+    uint64_t dtlb_hits, dtlb_misses;
+    uint64_t page_walks;
+    uint64_t walk_cycles;
+    uint64_t traps;
+    uint64_t decode_hits, decode_misses;
+    uint64_t code_writes;        // Stores that landed on code
+    uint64_t fetch_bytes;
+    uint64_t compressed_fetches;
+    uint64_t vector_instructions;
+    uint64_t vector_elements;
+    uint64_t vector_lane_slots;
+    uint64_t vop_instructions[6]; // vle32, vse32, vadd, vmul, vsll, vredsum
+    uint64_t vop_elements[6];
+} rvsim_stats;
+
+// Pipeline latches; RV32 values are sign- or zero-extended as in the simulator
+typedef struct rvsim_pipeline {
+    uint64_t cycle;
+    uint64_t pc;
+
+    uint64_t if_id_pc, if_id_npc;
+    uint32_t if_id_ir;
+
+    uint32_t id_ex_ir;
+    uint64_t id_ex_pc, id_ex_npc;
+    int64_t  id_ex_a, id_ex_b, id_ex_imm;
+
+    uint32_t ex_mem_ir;
+    uint32_t ex_mem_cond;
+    uint64_t ex_mem_pc;
+    int64_t  ex_mem_aluoutput, ex_mem_b;
+
+    uint32_t mem_wb_ir;
+    uint32_t mem_wb_rd;
+    uint32_t mem_wb_regwrite;
+    uint64_t mem_wb_pc;
+    int64_t  mem_wb_aluoutput, mem_wb_lmd;
+} rvsim_pipeline;
+
+// What changed since the last rvsim_take_delta (see sim_delta.hpp)
+typedef struct rvsim_delta {
+    uint64_t cycles;
+    uint32_t regs;          // Bit i: xi changed
+    uint32_t vregs;         // Bit i: vi written
+    uint32_t latches;       // DELTA_* bits
+    uint32_t pc;            // PC moved
+    uint32_t mem_overflow;  // Too many words written to list; re-read memory
+    uint32_t mem_words;     // Word addresses stored in the caller's array
+} rvsim_delta;
+
+// What the last rvsim_reload changed
+typedef struct rvsim_reload_stats {
+    uint32_t text_changed;    // Instruction slots added, removed or re-encoded
+    uint32_t data_changed;    // .data words added, removed or changed
+    uint32_t symbols_changed; // Labels added, removed or moved
+} rvsim_reload_stats;
+
+// Hard limits of a session (rvsim_create_limited); 0 leaves a field unlimited.
+// Calls that would pass one fail with RVSIM_ERR_LIMIT; once a run has hit
+// the page or cycle limit, rvsim_step and rvsim_run keep failing until a reset.
+typedef struct rvsim_limits {
+    uint32_t max_pages;       // Resident 4 KiB data pages, live memory and reset image together; reserved at create
+    uint64_t max_cycles;      // Cycle budget between resets, over all rvsim_step / rvsim_run calls
+    uint32_t max_mem_bytes;   // Largest rvsim_set_mem_size
+    uint32_t max_tlb_entries; // Largest rvsim_configure_tlb size
+} rvsim_limits;
+
+// Resources a session is using
+typedef struct rvsim_usage {
+    uint32_t pages;          // Resident data pages (live memory and reset image)
+    uint32_t page_capacity;  // max_pages, or 0 without a page limit
+    uint64_t cycles;         // Since the last reset
+    uint64_t cycle_budget;   // max_cycles, or 0 without a budget
+} rvsim_usage;
+
+unsigned int rvsim_api_version(void);
+
+// Message for the last failed call on the calling thread ("" after a success)
+const char* rvsim_last_error(void);
+
+// --- Programs ---
+
+// Assemble length bytes of source for RV32 (xlen 32) or RV64 (xlen 64)
+int rvsim_assemble(const char* source, size_t length, int xlen, rvsim_program** out);
+void rvsim_program_free(rvsim_program* program);
+
+int      rvsim_program_xlen(const rvsim_program* program);
+uint32_t rvsim_program_instruction_count(const rvsim_program* program);
+uint64_t rvsim_program_text_end(const rvsim_program* program); // First byte past .text
+// "0x00000080 | 0x00002083 | lw x1, 0(x0)" per instruction; valid while the program is
+const char* rvsim_program_listing(const rvsim_program* program);
+int      rvsim_program_row_for_pc(const rvsim_program* program, uint64_t pc);  // Listing row or -1
+uint32_t rvsim_program_line_for_pc(const rvsim_program* program, uint64_t pc); // 1-based source line or 0
+
+// --- Sessions ---
+
+// New simulator loaded with program (copied; the program may be freed after)
+int  rvsim_create(const rvsim_program* program, unsigned int flags, rvsim_session** out);
+// The same, with the data pages taken from a fixed arena allocated here and
+// the other limits enforced; fails with RVSIM_ERR_LIMIT if .data does not fit
+int  rvsim_create_limited(const rvsim_program* program, unsigned int flags, const rvsim_limits* limits, size_t size,
+                          rvsim_session** out);
+void rvsim_destroy(rvsim_session* session);
+
+// Back to the state after create, memory size included; TLB sizes, unified mode and VLEN are kept
+int rvsim_reset(rvsim_session* session);
+// Patch in another assembly of the program, rewriting only the words that
+// changed. With keep_state registers, PC, memory and the latches stay as they
+// are (new .data goes into the reset image); otherwise the session resets.
+// RVSIM_ERR_LIMIT if a .data word does not fit in memory or the page limit;
+// the text and the .data words before it are patched by then.
+int rvsim_reload(rvsim_session* session, const rvsim_program* program, int keep_state, rvsim_reload_stats* out);
+
+int rvsim_step(rvsim_session* session); // One cycle
+// Step until finished or max_cycles have run; cycles_run may be NULL
+int rvsim_run(rvsim_session* session, uint64_t max_cycles, uint64_t* cycles_run);
+int rvsim_is_finished(rvsim_session* session); // Halted, or past .text with the pipeline drained
+int rvsim_is_halted(rvsim_session* session);   // Trap with no handler
+
+// --- State ---
+
+uint64_t rvsim_get_pc(rvsim_session* session);
+int64_t  rvsim_get_reg(rvsim_session* session, int idx); // Sign-extended on RV32
+int      rvsim_set_reg(rvsim_session* session, int idx, int64_t value); // idx 1..31
+
+uint32_t rvsim_get_mem_size(rvsim_session* session);
+int rvsim_read_mem(rvsim_session* session, uint32_t addr, void* dst, uint32_t length);
+int rvsim_write_mem(rvsim_session* session, uint32_t addr, const void* src, uint32_t length);
+
+int32_t  rvsim_get_vreg(rvsim_session* session, int idx, int elem); // SEW = 32
+uint32_t rvsim_get_vl(rvsim_session* session);
+uint32_t rvsim_get_trap_cause(rvsim_session* session); // mcause of the last trap
+
+int rvsim_get_stats(rvsim_session* session, rvsim_stats* out, size_t size);
+int rvsim_get_usage(rvsim_session* session, rvsim_usage* out, size_t size);
+int rvsim_get_pipeline(rvsim_session* session, rvsim_pipeline* out, size_t size);
+// Copies up to capacity word addresses into words, then clears the delta
+int rvsim_take_delta(rvsim_session* session, rvsim_delta* out, uint32_t* words, uint32_t capacity);
+
+// --- Configuration ---
+
+int rvsim_set_mem_size(rvsim_session* session, uint32_t bytes);
+int rvsim_set_satp(rvsim_session* session, uint32_t value); // MODE bit 31 enables Sv32 (RV32 only)
+int rvsim_configure_tlb(rvsim_session* session, uint32_t itlb_entries, uint32_t dtlb_entries);
+int rvsim_set_trap_vector(rvsim_session* session, uint64_t addr); // 0 = halt on trap
+int rvsim_set_unified_memory(rvsim_session* session, int enable);  // Text image in data memory
+int rvsim_set_vlen(rvsim_session* session, uint32_t bits);          // Power of two, 32..1024
+// RVSIM_TRACE sessions only; fn = NULL sends the trace back to stdout
+int rvsim_set_trace(rvsim_session* session, rvsim_trace_fn fn, void* user);
+// RVSIM_TRACE sessions only; 0 pauses the trace (nothing is formatted) until turned back on
+int rvsim_set_trace_enabled(rvsim_session* session, int enabled);
+
+// --- Session pools ---
+
+// Up to capacity recycled sessions of one program, all created with the same
+// flags and limits. Sessions are made on first demand and kept when released,
+// so a warm pool serves repeated jobs without allocating. Thread-safe.
+int  rvsim_pool_create(const rvsim_program* program, unsigned int flags, const rvsim_limits* limits, size_t size,
+                       uint32_t capacity, rvsim_pool** out);
+// Every acquired session must be released first
+void rvsim_pool_destroy(rvsim_pool* pool);
+// A session in its after-create state; RVSIM_ERR_LIMIT if capacity are in use
+int  rvsim_pool_acquire(rvsim_pool* pool, rvsim_session** out);
+// Resets the session, including memory size, TLB sizes, unified mode, VLEN and trace target
+void rvsim_pool_release(rvsim_pool* pool, rvsim_session* session);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
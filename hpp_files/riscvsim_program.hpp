@@ -0,0 +1,36 @@
+#ifndef RISCVSIM_PROGRAM_HPP
+#define RISCVSIM_PROGRAM_HPP
+
+#include "riscvsim.h"
+#include "assembler.hpp"
+#include "asm_arena.hpp"
+#include "program_listing.hpp"
+
+/**
+ * An assembled program behind the C API's rvsim_program handle. C++ callers
+ * (main.cpp, the tools) may read the parsed instructions and images directly,
+ * e.g. to run the lane model on them, but must not change a program once a
+ * session has been created from it.
+ */
+struct rvsim_program {
+    int xlen;
+    vector<ParsedInstruction> instructions; // Address order; text lives in arena
+    AsmArena arena;
+    map<unsigned int, unsigned int> text;   // Address -> encoded word
+    map<string, unsigned int> symbols;
+    map<unsigned int, int32_t> data;        // .data word address -> value
+    ProgramListing listing;
+
+    uint64_t text_end() const {
+        return instructions.empty() ? 0 : (uint64_t)instructions.back().address + instructions.back().size;
+    }
+};
+
+// A program from parts assembled elsewhere (e.g. IncrementalAssembler). The
+// instruction text is copied into the program's arena and the listing built.
+rvsim_program* rvsimProgramFromParts(int xlen, vector<ParsedInstruction> instructions,
+                                     map<unsigned int, unsigned int> text,
+                                     map<string, unsigned int> symbols,
+                                     map<unsigned int, int32_t> data);
+
+#endif
@@ -0,0 +1,118 @@
+#ifndef SIM_CORPUS_HPP
+#define SIM_CORPUS_HPP
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/*
+ * Expected-state test corpus. A corpus file is assembly with three kinds of
+ * comment lines that the assembler ignores:
+ *
+ *   #@ NAME [xlen=64] [mem=BYTES] [cycles=MAX] [unified=1] [vlen=BITS] [satp=VALUE]
+ *       starts a test; its program is every line up to the next #@ or the
+ *       end of the file
+ *   #< KEY = VALUE [KEY = VALUE ...]
+ *       initial state set before the run (and before satp), e.g. page
+ *       tables. KEY is xN or mem[ADDR]
+ *   #= KEY = VALUE [KEY = VALUE ...]
+ *       expected final state. KEY is xN, mem[ADDR] (signed 32-bit word),
+ *       pc, cycles, instructions, stalls, halted (0 or 1), cause (mcause
+ *       of the last trap), itlb_hits, itlb_misses, dtlb_hits, dtlb_misses
+ *       or walks
+ *
+ * A file with no #@ line is one test named after the file. Its expectations
+ * can also live next to it, one KEY = VALUE per line (prog.expect for
+ * prog.s). Only the keys given are checked. Values are decimal or 0x hex.
+ */
+
+enum ExpectKey : uint8_t {
+    EXPECT_REG = 0,
+    EXPECT_MEM,
+    EXPECT_PC,
+    EXPECT_CYCLES,
+    EXPECT_INSTRUCTIONS,
+    EXPECT_STALLS,
+    EXPECT_HALTED,
+    EXPECT_CAUSE,
+    EXPECT_ITLB_HITS,
+    EXPECT_ITLB_MISSES,
+    EXPECT_DTLB_HITS,
+    EXPECT_DTLB_MISSES,
+    EXPECT_WALKS
+};
+
+struct CorpusExpect {
+    ExpectKey key;
+    uint32_t where; // Register number or byte address
+    int64_t value;
+};
+
+struct CorpusTest {
+    std::string name;
+    std::string file;
+    uint32_t line;        // Of the #@ header; 0 for a whole-file test
+    std::string source;   // The test's lines, padded so assembler line numbers match the file
+    std::string expect_file; // Sidecar the expectations came from, or empty
+    int xlen;
+    uint32_t mem_bytes;   // 0: the simulator default
+    uint64_t max_cycles;
+    bool unified;         // rvsim_set_unified_memory
+    uint32_t vlen;        // 0: the simulator default
+    uint32_t satp;        // rvsim_set_satp; 0 leaves translation off
+    std::vector<CorpusExpect> inits;   // #< lines: registers and memory words
+    std::vector<CorpusExpect> expects;
+
+    CorpusTest() : line(0), xlen(32), mem_bytes(0), max_cycles(100000), unified(false), vlen(0), satp(0) {}
+};
+
+// Final state of one run
+struct CorpusState {
+    int status;           // RVSIM_*; anything else but RVSIM_OK means the test did not run to the end
+    std::string error;
+    bool finished;        // Ran off .text with the pipeline drained (or halted)
+    bool halted;
+    uint64_t pc, cycles, instructions, stalls;
+    uint32_t cause;
+    uint64_t itlb_hits, itlb_misses, dtlb_hits, dtlb_misses, walks;
+    int64_t regs[32];
+    std::vector<int32_t> memory; // All of data memory, by word
+
+    CorpusState()
+        : status(0), finished(false), halted(false), pc(0), cycles(0), instructions(0), stalls(0), cause(0),
+          itlb_hits(0), itlb_misses(0), dtlb_hits(0), dtlb_misses(0), walks(0), regs() {}
+};
+
+struct CorpusResult {
+    CorpusState state;
+    std::vector<std::string> diffs; // "key: expected V, got W"; empty when the test passed
+    double seconds;                 // Run time, assembly included
+};
+
+// Tests of one file (a corpus, or a single program with optional sidecar); false with error set
+bool loadCorpusFile(const std::string& path, std::vector<CorpusTest>& tests, std::string& error);
+bool parseCorpus(const std::string& text, const std::string& file, std::vector<CorpusTest>& tests, std::string& error);
+
+// Appends the KEY = VALUE pairs of one line (no #= prefix)
+bool parseExpectations(const std::string& text, std::vector<CorpusExpect>& out, std::string& error);
+
+// Assembles and runs a test in a fresh libriscvsim session
+void runCorpusTest(const CorpusTest& test, CorpusState& state);
+
+// Mismatches between the test's expectations and a final state
+std::vector<std::string> diffCorpusState(const CorpusTest& test, const CorpusState& state);
+
+// Runs every test on threads (0: one per hardware thread); results[i] is tests[i]
+void runCorpus(const std::vector<CorpusTest>& tests, unsigned int threads, std::vector<CorpusResult>& results);
+
+// KEY = VALUE lines describing a state: non-zero registers, non-zero memory
+// words, the counters (with the cause when halted), then the TLB counters
+// if translation was used
+std::vector<std::string> recordExpectations(const CorpusState& state);
+
+// Writes the recorded state of every test of one file back: the #= lines of
+// each test are replaced, or the sidecar file is rewritten
+bool saveRecordedCorpus(const std::string& path, const std::vector<const CorpusTest*>& tests,
+                        const std::vector<const CorpusState*>& states, std::string& error);
+
+#endif
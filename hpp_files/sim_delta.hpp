@@ -0,0 +1,55 @@
+#ifndef SIM_DELTA_HPP
+#define SIM_DELTA_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Bits in StepDelta::latches
+const uint32_t DELTA_IF_ID  = 1;
+const uint32_t DELTA_ID_EX  = 2;
+const uint32_t DELTA_EX_MEM = 4;
+const uint32_t DELTA_MEM_WB = 8;
+
+// Memory words listed per delta; past this only mem_overflow is set
+const size_t DELTA_MAX_MEM_WORDS = 256;
+
+/**
+ * State that changed since the last clear_delta(), so a display can redraw
+ * only those cells. Recording is a few ORs and compares per cycle and is
+ * always on. Clear after every step for a per-cycle delta, or every N
+ * steps for an accumulated one.
+ */
+struct StepDelta {
+    uint64_t cycles;       // Cycles stepped since the last clear
+    uint32_t regs;         // Bit i: xi changed value
+    uint32_t vregs;        // Bit i: vi was written
+    uint32_t latches;      // DELTA_* bits: latch contents changed
+    bool     pc;           // PC moved
+    bool     mem_overflow; // More words written than fit in mem_words: re-read all memory
+    std::vector<uint32_t> mem_words; // Word-aligned addresses written (adjacent repeats folded)
+
+    StepDelta() { clear(); }
+
+    void clear() {
+        cycles = 0;
+        regs = vregs = latches = 0;
+        pc = mem_overflow = false;
+        mem_words.clear(); // Keeps capacity, so steady-state recording does not allocate
+    }
+
+    void note_mem(uint32_t addr, uint32_t len) {
+        if (mem_overflow || len == 0) return;
+        for (uint32_t w = addr & ~3u; w < addr + len; w += 4) {
+            if (!mem_words.empty() && mem_words.back() == w) continue;
+            if (mem_words.size() == DELTA_MAX_MEM_WORDS) {
+                mem_overflow = true;
+                mem_words.clear();
+                return;
+            }
+            mem_words.push_back(w);
+        }
+    }
+};
+
+#endif
@@ -0,0 +1,157 @@
+#ifndef SIM_HOOKS_HPP
+#define SIM_HOOKS_HPP
+
+#include "xlen.hpp"
+#include <cstdint>
+
+/*
+ * Compile-time instrumentation for the pipelined simulator.
+ *
+ * A plugin derives from SimPlugin and redefines the hooks it cares about.
+ * The simulator takes its plugins as a template parameter (SimPlugins<A, B>)
+ * and calls each hook directly, so a hook no plugin redefines is an empty
+ * inline call and compiles away. Events are built from values the stage
+ * has already computed; plugins only observe and never feed back into the
+ * pipeline.
+ */
+
+// --- Events ---
+
+enum FetchKind : uint8_t {
+    FETCH_OK,      // IR fetched
+    FETCH_FAULT,   // Translation fault or illegal RVC encoding; the cause travels down in IF/ID
+    FETCH_WAIT,    // A faulting fetch is still on its way to EX
+    FETCH_END,     // No instruction at PC
+    FETCH_STALLED  // Stall or flush this cycle; nothing fetched
+};
+
+template <int XLEN>
+struct FetchEvent {
+    typename XlenTraits<XLEN>::uxlen_t PC;
+    uint32_t  raw;    // Word read at PC (an RVC encoding in the low half)
+    uint32_t  IR;     // raw after RVC expansion
+    uint32_t  size;   // Bytes consumed (2 or 4); 0 unless FETCH_OK
+    uint32_t  cause;  // FETCH_FAULT only
+    FetchKind kind;
+};
+
+template <int XLEN>
+struct DecodeEvent {
+    typename XlenTraits<XLEN>::uxlen_t PC;
+    typename XlenTraits<XLEN>::uxlen_t A, B; // Register reads (not done when stalled)
+    uint32_t IR;        // 0 for a bubble
+    uint8_t  rs1, rs2;
+    bool     cache_hit; // Fields came from the decode cache
+    bool     stalled;   // RAW hazard; an on_stall(STALL_DATA) follows
+};
+
+template <int XLEN>
+struct ExecEvent {
+    typedef typename XlenTraits<XLEN>::uxlen_t uxlen_t;
+    typedef typename XlenTraits<XLEN>::sxlen_t sxlen_t;
+
+    uxlen_t  PC, NPC;
+    sxlen_t  op1, op2;   // ALU operands (op2 is IMM for ADDI/SLLI, loads and stores)
+    sxlen_t  result;     // ALUOutput: ALU result, effective address or the new vl
+    uint32_t IR;
+    uint8_t  opcode, func3, func7, rd, rs1, rs2;
+    bool     cond;       // Branch compare outcome
+
+    // Loads and stores
+    bool     translated; // Sv32 was on
+    uint32_t pa;
+    unsigned int walk_cycles;
+    uint32_t fault;      // Trap this instruction raises in EX (0 = none)
+    uxlen_t  tval;       // and its mtval
+
+    // Vector instructions
+    unsigned int vl, vlmax;
+    bool     vill;
+    int32_t  vresult;    // vredsum.vs: element 0 of the result
+    int      vop;        // VectorOpClass of a completed vector instruction, or -1
+};
+
+enum MemKind : uint8_t { MEM_NONE, MEM_LOAD, MEM_STORE };
+
+template <int XLEN>
+struct MemEvent {
+    typename XlenTraits<XLEN>::uxlen_t PC;
+    typename XlenTraits<XLEN>::sxlen_t addr;  // Effective (virtual) address
+    typename XlenTraits<XLEN>::sxlen_t value; // Scalar value loaded or stored
+    uint32_t IR;
+    uint32_t pa;
+    unsigned int elements; // vle32.v / vse32.v element count
+    MemKind  kind;
+    bool     vector;
+    bool     ok;           // In bounds; nothing moved otherwise
+    bool     hit_code;     // Store landed on code and dropped its decodes
+};
+
+enum WritebackKind : uint8_t { WB_NONE, WB_REG, WB_VREG };
+
+template <int XLEN>
+struct WritebackEvent {
+    typename XlenTraits<XLEN>::uxlen_t PC;
+    typename XlenTraits<XLEN>::sxlen_t value; // WB_REG
+    uint32_t IR;
+    unsigned int elements;                     // WB_VREG
+    uint8_t  rd;
+    WritebackKind kind;
+};
+
+enum StallKind : uint8_t {
+    STALL_WALK, // Page-table walk freezes the whole pipeline
+    STALL_DATA  // RAW hazard in ID: bubble into EX, IF/ID held
+};
+
+struct StallEvent {
+    uint32_t ex_hit, mem_hit, wb_hit; // Registers ID reads that EX, MEM or WB will write
+    unsigned int walk_left;           // STALL_WALK: cycles left after this one
+    uint8_t  ex_rd, mem_rd, wb_rd;
+    bool     vector;                  // Vector RAW against an older vector write
+    StallKind kind;
+};
+
+enum FlushKind : uint8_t { FLUSH_BRANCH, FLUSH_FENCE_I, FLUSH_TRAP };
+
+template <int XLEN>
+struct FlushEvent {
+    typename XlenTraits<XLEN>::uxlen_t target;    // Where fetch resumes
+    typename XlenTraits<XLEN>::uxlen_t epc, tval; // FLUSH_TRAP
+    uint32_t  cause;                               // FLUSH_TRAP
+    bool      halted;                              // Trap with no handler
+    FlushKind kind;
+};
+
+// --- Plugins ---
+
+// Every hook, as a no-op. Plugins hide the ones they implement.
+struct SimPlugin {
+    void on_reset() {}
+    void on_cycle(uint64_t) {}
+    void on_cycle_end() {}
+    template <int XLEN> void on_fetch(const FetchEvent<XLEN>&) {}
+    template <int XLEN> void on_decode(const DecodeEvent<XLEN>&) {}
+    template <int XLEN> void on_execute(const ExecEvent<XLEN>&) {}
+    template <int XLEN> void on_mem_access(const MemEvent<XLEN>&) {}
+    template <int XLEN> void on_writeback(const WritebackEvent<XLEN>&) {}
+    void on_stall(const StallEvent&) {}
+    template <int XLEN> void on_flush(const FlushEvent<XLEN>&) {}
+};
+
+// A simulator's plugin set; hooks run in the listed order. SimPlugins<> has none.
+template <class... Plugins>
+struct SimPlugins : Plugins... {
+    void on_reset() { (Plugins::on_reset(), ...); }
+    void on_cycle([[maybe_unused]] uint64_t cycle) { (Plugins::on_cycle(cycle), ...); }
+    void on_cycle_end() { (Plugins::on_cycle_end(), ...); }
+    template <int XLEN> void on_fetch([[maybe_unused]] const FetchEvent<XLEN>& e) { (Plugins::on_fetch(e), ...); }
+    template <int XLEN> void on_decode([[maybe_unused]] const DecodeEvent<XLEN>& e) { (Plugins::on_decode(e), ...); }
+    template <int XLEN> void on_execute([[maybe_unused]] const ExecEvent<XLEN>& e) { (Plugins::on_execute(e), ...); }
+    template <int XLEN> void on_mem_access([[maybe_unused]] const MemEvent<XLEN>& e) { (Plugins::on_mem_access(e), ...); }
+    template <int XLEN> void on_writeback([[maybe_unused]] const WritebackEvent<XLEN>& e) { (Plugins::on_writeback(e), ...); }
+    void on_stall([[maybe_unused]] const StallEvent& e) { (Plugins::on_stall(e), ...); }
+    template <int XLEN> void on_flush([[maybe_unused]] const FlushEvent<XLEN>& e) { (Plugins::on_flush(e), ...); }
+};
+
+#endif
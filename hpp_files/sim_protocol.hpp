@@ -0,0 +1,268 @@
+#ifndef SIM_PROTOCOL_HPP
+#define SIM_PROTOCOL_HPP
+
+#include "sim_service.hpp"
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <errno.h>
+#include <unistd.h>
+
+/*
+ * Wire format of tools/sim_server and tools/sim_load (POSIX stream sockets).
+ * Every message is a frame: u32 payload length, u8 type, payload. Integers
+ * are little-endian; strings and byte runs are a u32 length then the bytes.
+ *
+ * FRAME_BATCH (client -> server)
+ *   u32 source_count, per source: u8 xlen, str text
+ *   u32 job_count, per job: u32 id, u32 source, u64 max_cycles, u32 mem_bytes,
+ *       u32 dump_addr, u32 dump_len, u32 init_count,
+ *       per init: u8 kind, u32 where, i64 value
+ * FRAME_RESULT (server -> client), one per job in completion order
+ *   u32 id, u8 outcome, i32 status, u64 cycles, u64 instructions,
+ *   u64 stall_cycles, u32 queue_us, u32 run_us, i64 regs[32], bytes memory, str error
+ * FRAME_ERROR (server -> client): str message; the server then closes the connection
+ */
+
+enum FrameType : uint8_t { FRAME_BATCH = 1, FRAME_RESULT = 2, FRAME_ERROR = 3 };
+
+const uint32_t MAX_FRAME_BYTES = 64u << 20;
+const uint32_t MAX_BATCH_JOBS = 65536;
+const uint32_t MAX_JOB_INITS = 64;
+
+// One program of a batch; jobs refer to it by index
+struct BatchSource {
+    int xlen;
+    std::string text;
+};
+
+struct BatchJob {
+    uint32_t source;
+    SimJob job; // program is left empty on the wire
+};
+
+// --- Encoding ---
+
+class WireWriter {
+public:
+    std::vector<uint8_t> buf;
+
+    void u8(uint8_t v) { buf.push_back(v); }
+    void u32(uint32_t v) { for (int i = 0; i < 4; i++) buf.push_back((uint8_t)(v >> (8 * i))); }
+    void u64(uint64_t v) { for (int i = 0; i < 8; i++) buf.push_back((uint8_t)(v >> (8 * i))); }
+    void bytes(const void* p, uint32_t n) {
+        u32(n);
+        buf.insert(buf.end(), (const uint8_t*)p, (const uint8_t*)p + n);
+    }
+    void str(const std::string& s) { bytes(s.data(), (uint32_t)s.size()); }
+
+    // begin_frame(), the payload, then end_frame() patches the length in
+    void begin_frame(FrameType type) {
+        frame_start = buf.size();
+        u32(0);
+        u8(type);
+    }
+    void end_frame() {
+        uint32_t n = (uint32_t)(buf.size() - frame_start - 5);
+        for (int i = 0; i < 4; i++) buf[frame_start + i] = (uint8_t)(n >> (8 * i));
+    }
+
+private:
+    size_t frame_start = 0;
+};
+
+// Bounds-checked reads; after a short read ok is false and values are 0
+class WireReader {
+public:
+    WireReader(const uint8_t* p, size_t n) : p(p), end(p + n), ok(true) {}
+
+    bool good() const { return ok; }
+    bool at_end() const { return p == end; }
+
+    uint8_t u8() { return need(1) ? *p++ : 0; }
+    uint32_t u32() {
+        if (!need(4)) return 0;
+        uint32_t v = 0;
+        for (int i = 0; i < 4; i++) v |= (uint32_t)p[i] << (8 * i);
+        p += 4;
+        return v;
+    }
+    uint64_t u64() {
+        uint64_t lo = u32();
+        return lo | ((uint64_t)u32() << 32);
+    }
+    std::string str(uint32_t max_len) {
+        uint32_t n = u32();
+        if (n > max_len || !need(n)) {
+            ok = false;
+            return std::string();
+        }
+        std::string s((const char*)p, n);
+        p += n;
+        return s;
+    }
+
+private:
+    bool need(size_t n) {
+        if (ok && (size_t)(end - p) >= n) return true;
+        ok = false;
+        return false;
+    }
+
+    const uint8_t* p;
+    const uint8_t* end;
+    bool ok;
+};
+
+inline void encodeBatch(WireWriter& w, const std::vector<BatchSource>& sources, const std::vector<BatchJob>& jobs) {
+    w.begin_frame(FRAME_BATCH);
+    w.u32((uint32_t)sources.size());
+    for (const BatchSource& s : sources) {
+        w.u8((uint8_t)s.xlen);
+        w.str(s.text);
+    }
+    w.u32((uint32_t)jobs.size());
+    for (const BatchJob& bj : jobs) {
+        const SimJob& j = bj.job;
+        w.u32(j.id);
+        w.u32(bj.source);
+        w.u64(j.max_cycles);
+        w.u32(j.mem_bytes);
+        w.u32(j.dump_addr);
+        w.u32(j.dump_len);
+        w.u32((uint32_t)j.inits.size());
+        for (const JobInit& init : j.inits) {
+            w.u8(init.kind);
+            w.u32(init.where);
+            w.u64((uint64_t)init.value);
+        }
+    }
+    w.end_frame();
+}
+
+// False with error set if the payload is malformed or breaks limits
+inline bool decodeBatch(WireReader& r, const ServiceLimits& limits, std::vector<BatchSource>& sources,
+                        std::vector<BatchJob>& jobs, std::string& error) {
+    uint32_t source_count = r.u32();
+    if (source_count > MAX_BATCH_JOBS) {
+        error = "Too many sources in batch";
+        return false;
+    }
+    sources.resize(source_count);
+    for (BatchSource& s : sources) {
+        s.xlen = r.u8();
+        s.text = r.str(limits.max_source_bytes);
+        if (!r.good()) {
+            error = "Truncated source or source over " + std::to_string(limits.max_source_bytes) + " bytes";
+            return false;
+        }
+    }
+
+    uint32_t job_count = r.u32();
+    if (job_count > MAX_BATCH_JOBS) {
+        error = "Too many jobs in batch";
+        return false;
+    }
+    jobs.resize(job_count);
+    for (BatchJob& bj : jobs) {
+        SimJob& j = bj.job;
+        j.id = r.u32();
+        bj.source = r.u32();
+        j.max_cycles = r.u64();
+        j.mem_bytes = r.u32();
+        j.dump_addr = r.u32();
+        j.dump_len = r.u32();
+        uint32_t init_count = r.u32();
+        if (init_count > MAX_JOB_INITS) {
+            error = "Too many initial values in job " + std::to_string(j.id);
+            return false;
+        }
+        j.inits.resize(init_count);
+        for (JobInit& init : j.inits) {
+            init.kind = r.u8();
+            init.where = r.u32();
+            init.value = (int64_t)r.u64();
+        }
+        if (r.good() && bj.source >= source_count) {
+            error = "Job " + std::to_string(j.id) + " names source " + std::to_string(bj.source);
+            return false;
+        }
+    }
+    if (!r.good() || !r.at_end()) {
+        error = "Malformed batch";
+        return false;
+    }
+    return true;
+}
+
+inline void encodeResult(WireWriter& w, const SimJobResult& res) {
+    w.begin_frame(FRAME_RESULT);
+    w.u32(res.id);
+    w.u8(res.outcome);
+    w.u32((uint32_t)res.status);
+    w.u64(res.cycles);
+    w.u64(res.instructions);
+    w.u64(res.stall_cycles);
+    w.u32(res.queue_us);
+    w.u32(res.run_us);
+    for (int i = 0; i < 32; i++) w.u64((uint64_t)res.regs[i]);
+    w.bytes(res.memory.data(), (uint32_t)res.memory.size());
+    w.str(res.error);
+    w.end_frame();
+}
+
+inline bool decodeResult(WireReader& r, SimJobResult& res) {
+    res.id = r.u32();
+    res.outcome = (JobOutcome)r.u8();
+    res.status = (int32_t)r.u32();
+    res.cycles = r.u64();
+    res.instructions = r.u64();
+    res.stall_cycles = r.u64();
+    res.queue_us = r.u32();
+    res.run_us = r.u32();
+    for (int i = 0; i < 32; i++) res.regs[i] = (int64_t)r.u64();
+    std::string mem = r.str(MAX_FRAME_BYTES);
+    res.memory.assign(mem.begin(), mem.end());
+    res.error = r.str(MAX_FRAME_BYTES);
+    return r.good() && r.at_end();
+}
+
+// --- Socket I/O ---
+
+inline bool writeFull(int fd, const void* data, size_t n) {
+    const uint8_t* p = (const uint8_t*)data;
+    while (n > 0) {
+        ssize_t k = ::write(fd, p, n);
+        if (k < 0 && errno == EINTR) continue;
+        if (k <= 0) return false;
+        p += k;
+        n -= (size_t)k;
+    }
+    return true;
+}
+
+inline bool readFull(int fd, void* data, size_t n) {
+    uint8_t* p = (uint8_t*)data;
+    while (n > 0) {
+        ssize_t k = ::read(fd, p, n);
+        if (k < 0 && errno == EINTR) continue;
+        if (k <= 0) return false;
+        p += k;
+        n -= (size_t)k;
+    }
+    return true;
+}
+
+// Next frame; false on end of stream, a read error or an oversized frame
+inline bool readFrame(int fd, uint8_t& type, std::vector<uint8_t>& payload) {
+    uint8_t header[5];
+    if (!readFull(fd, header, sizeof(header))) return false;
+    uint32_t n = header[0] | (header[1] << 8) | (header[2] << 16) | ((uint32_t)header[3] << 24);
+    if (n > MAX_FRAME_BYTES) return false;
+    type = header[4];
+    payload.resize(n);
+    return readFull(fd, payload.data(), n);
+}
+
+#endif
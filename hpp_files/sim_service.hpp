@@ -0,0 +1,140 @@
+#ifndef SIM_SERVICE_HPP
+#define SIM_SERVICE_HPP
+
+#include "riscvsim.h"
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// How a service job stopped
+enum JobOutcome : uint8_t {
+    JOB_FINISHED = 0, // Ran off the end of .text with the pipeline drained
+    JOB_HALTED,       // Trap with no handler
+    JOB_TIMEOUT,      // Hit its cycle limit
+    JOB_ERROR         // Did not run, or hit a session limit; status and error say why
+};
+
+// Service-wide caps. A job's own limits are clamped to these.
+struct ServiceLimits {
+    uint64_t max_cycles;       // Per job
+    uint32_t max_mem_bytes;    // Data memory per job; twice this is reserved per session (memory and reset image)
+    uint32_t max_source_bytes; // Per program
+    uint32_t max_dump_bytes;   // Memory returned per result
+    size_t   max_queued;       // submit() blocks while this many jobs wait
+
+    ServiceLimits() : max_cycles(1000000), max_mem_bytes(1 << 20), max_source_bytes(256 * 1024),
+                      max_dump_bytes(64 * 1024), max_queued(4096) {}
+};
+
+// A source assembled at most once, by whichever worker first runs a job from
+// it, together with the pool of sessions its jobs run in
+class SharedProgram {
+public:
+    SharedProgram(std::string source, int xlen)
+        : source(std::move(source)), xlen(xlen), program(nullptr), sessions(nullptr), status(RVSIM_OK) {}
+    ~SharedProgram() {
+        rvsim_pool_destroy(sessions);
+        rvsim_program_free(program);
+    }
+
+    // The session pool (capacity sessions under limits), or nullptr with status and error set
+    rvsim_pool* pool(const rvsim_limits& limits, uint32_t capacity);
+    int get_status() const { return status; }
+    const std::string& get_error() const { return error; }
+
+private:
+    std::string source;
+    int xlen;
+    std::once_flag once;
+    rvsim_program* program;
+    rvsim_pool* sessions;
+    int status;
+    std::string error;
+};
+
+// Initial state a job applies after reset, in order
+enum JobInitKind : uint8_t { INIT_REG = 0, INIT_MEM_WORD };
+
+struct JobInit {
+    uint8_t  kind;  // JobInitKind
+    uint32_t where; // Register number or byte address
+    int64_t  value;
+};
+
+struct SimJob {
+    uint32_t id;                  // The caller's; echoed in the result
+    std::shared_ptr<SharedProgram> program;
+    uint64_t max_cycles;          // 0: the service cap
+    uint32_t mem_bytes;           // 0: the simulator default
+    std::vector<JobInit> inits;
+    uint32_t dump_addr, dump_len; // Memory returned with the result
+
+    SimJob() : id(0), max_cycles(0), mem_bytes(0), dump_addr(0), dump_len(0) {}
+};
+
+struct SimJobResult {
+    uint32_t id;
+    JobOutcome outcome;
+    int32_t  status;    // RVSIM_* (non-zero with JOB_ERROR; RVSIM_ERR_LIMIT if it hit a session limit)
+    uint64_t cycles, instructions, stall_cycles;
+    uint32_t queue_us;  // Submit to start on a worker
+    uint32_t run_us;    // On the worker, including any assembly
+    int64_t  regs[32];
+    std::vector<uint8_t> memory;
+    std::string error;
+};
+
+/**
+ * Fixed pool of workers running assemble+run jobs on libriscvsim sessions,
+ * for a long-running grading server. Each program has a pool of at most one
+ * session per worker, recycled between jobs, so a batch of inputs for one
+ * program assembles once and allocates nothing once the pool is warm.
+ * Sessions are created with hard limits from ServiceLimits (a fixed page
+ * arena, a cycle budget, a memory size cap); a job that reaches one ends with
+ * JOB_ERROR and RVSIM_ERR_LIMIT. Results go to the job's callback on the
+ * worker thread, in completion order.
+ */
+class SimService {
+public:
+    typedef std::function<void(const SimJobResult&)> ResultFn;
+
+    SimService(unsigned int threads = 0, const ServiceLimits& limits = ServiceLimits());
+    ~SimService(); // Runs the queued jobs, then joins the workers
+
+    // Queue a job; blocks while max_queued jobs are waiting
+    void submit(SimJob job, ResultFn done);
+
+    unsigned int thread_count() const { return (unsigned int)workers.size(); }
+    const ServiceLimits& limits() const { return caps; }
+    uint64_t completed() const;
+
+private:
+    typedef std::chrono::steady_clock Clock;
+
+    struct Pending {
+        SimJob job;
+        ResultFn done;
+        Clock::time_point queued;
+    };
+
+    void worker_main();
+    void run_job(const Pending& p, SimJobResult& r);
+
+    ServiceLimits caps;
+    rvsim_limits session_limits;
+    std::vector<std::thread> workers;
+    mutable std::mutex lock;
+    std::condition_variable work_ready, space_ready;
+    std::deque<Pending> queue;
+    bool stopping;
+    uint64_t done_count;
+};
+
+#endif
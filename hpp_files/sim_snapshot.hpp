@@ -0,0 +1,114 @@
+#ifndef SIM_SNAPSHOT_HPP
+#define SIM_SNAPSHOT_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include "riscvsim.h"
+
+const uint32_t SNAPSHOT_MEM_BYTES = 4096; // Data memory window mirrored to JS
+const uint32_t SNAPSHOT_HISTORY   = 256;  // Pipeline records kept (ring)
+
+// One cycle of pipeline state, the same fields the pipeline map draws.
+// Every field is a 32-bit word so JS can read records straight from HEAPU32.
+struct PipelineRecord {
+    uint32_t cycle;
+    uint32_t pc;
+    uint32_t if_id_pc;
+    uint32_t if_id_ir;
+    uint32_t id_ex_ir;
+    int32_t  id_ex_a;
+    int32_t  id_ex_b;
+    uint32_t ex_mem_ir;
+    int32_t  ex_mem_aluoutput;
+    uint32_t mem_wb_ir;
+    int32_t  mem_wb_aluoutput;
+    int32_t  mem_wb_lmd;
+    uint32_t mem_wb_rd;
+    uint32_t mem_wb_regwrite;
+};
+
+/**
+ * Simulator state published for lock-free reads (sequence lock).
+ * The writer makes seq odd, updates the fields, then makes it even again.
+ * A reader copies the fields between two reads of seq and retries if the
+ * values differ or are odd. In the -pthread build this struct lives in the
+ * SharedArrayBuffer, so index.html reads it through HEAPU32 with Atomics.load
+ * on seq and no embind calls.
+ */
+struct SimSnapshot {
+    std::atomic<uint32_t> seq;
+    uint32_t running;          // Background run in progress
+    uint32_t halted;
+    uint32_t finished;         // Ran off the end of .text with the pipeline drained
+    uint32_t cycle_lo, cycle_hi;
+    uint32_t pc_lo, pc_hi;
+    uint32_t regs[32][2];      // {low word, high word}; high word is the sign extension on RV32
+    uint32_t mem_size;         // Valid bytes in mem[]
+    uint8_t  mem[SNAPSHOT_MEM_BYTES];
+    uint32_t history_count;    // Records ever written; ring slot = n % SNAPSHOT_HISTORY
+    PipelineRecord history[SNAPSHOT_HISTORY];
+};
+
+// Capture the session's current latches as a history record
+inline PipelineRecord capturePipeline(rvsim_session* session) {
+    rvsim_pipeline p;
+    rvsim_get_pipeline(session, &p, sizeof(p));
+
+    PipelineRecord r;
+    r.cycle = (uint32_t)p.cycle;
+    r.pc = (uint32_t)p.pc;
+    r.if_id_pc = (uint32_t)p.if_id_pc;
+    r.if_id_ir = p.if_id_ir;
+    r.id_ex_ir = p.id_ex_ir;
+    r.id_ex_a = (int32_t)p.id_ex_a;
+    r.id_ex_b = (int32_t)p.id_ex_b;
+    r.ex_mem_ir = p.ex_mem_ir;
+    r.ex_mem_aluoutput = (int32_t)p.ex_mem_aluoutput;
+    r.mem_wb_ir = p.mem_wb_ir;
+    r.mem_wb_aluoutput = (int32_t)p.mem_wb_aluoutput;
+    r.mem_wb_lmd = (int32_t)p.mem_wb_lmd;
+    r.mem_wb_rd = p.mem_wb_rd;
+    r.mem_wb_regwrite = p.mem_wb_regwrite;
+    return r;
+}
+
+/**
+ * Writer side of the sequence lock. Publishes registers, memory and the
+ * records collected since the last publish in one consistent update.
+ */
+inline void publishSnapshot(SimSnapshot& snap, rvsim_session* session, const PipelineRecord* pending,
+                            uint32_t pending_count, bool running, bool finished) {
+    uint32_t seq = snap.seq.load(std::memory_order_relaxed);
+    snap.seq.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    rvsim_stats stats;
+    rvsim_get_stats(session, &stats, sizeof(stats));
+    uint64_t pc = rvsim_get_pc(session);
+    snap.running = running;
+    snap.halted = rvsim_is_halted(session);
+    snap.finished = finished;
+    snap.cycle_lo = (uint32_t)stats.cycles;
+    snap.cycle_hi = (uint32_t)(stats.cycles >> 32);
+    snap.pc_lo = (uint32_t)pc;
+    snap.pc_hi = (uint32_t)(pc >> 32);
+    for (int i = 0; i < 32; i++) {
+        int64_t value = rvsim_get_reg(session, i);
+        snap.regs[i][0] = (uint32_t)value;
+        snap.regs[i][1] = (uint32_t)((uint64_t)value >> 32);
+    }
+
+    uint32_t mem_size = rvsim_get_mem_size(session);
+    snap.mem_size = (mem_size < SNAPSHOT_MEM_BYTES) ? mem_size : SNAPSHOT_MEM_BYTES;
+    rvsim_read_mem(session, 0, snap.mem, snap.mem_size);
+
+    for (uint32_t i = 0; i < pending_count; i++) {
+        snap.history[snap.history_count % SNAPSHOT_HISTORY] = pending[i];
+        snap.history_count++;
+    }
+
+    snap.seq.store(seq + 2, std::memory_order_release);
+}
+
+#endif
@@ -0,0 +1,50 @@
+#ifndef SIM_STATS_HPP
+#define SIM_STATS_HPP
+
+#include <cstdint>
+
+// Vector instruction classes tracked separately in the stats
+enum VectorOpClass {
+    VOP_LOAD = 0, // vle32.v
+    VOP_STORE,    // vse32.v
+    VOP_ADD,      // vadd.vv
+    VOP_MUL,      // vmul.vv
+    VOP_SLL,      // vsll.vv / vsll.vi
+    VOP_REDSUM,   // vredsum.vs
+    VOP_COUNT
+};
+
+// Counters collected by the simulator while it runs
+struct SimStats {
+    uint64_t cycles;
+    uint64_t instructions;   // Retired in WB
+    uint64_t stall_cycles;   // Data hazard bubbles
+    uint64_t flushes;        // Taken branches / traps
+
+    // Address translation (Sv32)
+    uint64_t itlb_hits;
+    uint64_t itlb_misses;
+    uint64_t dtlb_hits;
+    uint64_t dtlb_misses;
+    uint64_t page_walks;
+    uint64_t walk_cycles;    // Pipeline frozen while walking page tables
+    uint64_t traps;          // Page/access faults taken
+
+    // Predecode cache / self-modifying code
+    uint64_t decode_hits;
+    uint64_t decode_misses;
+    uint64_t code_writes;    // Stores that landed on code and invalidated decodes
+
+    // Instruction fetch (RVC)
+    uint64_t fetch_bytes;
+    uint64_t compressed_fetches; // Each saves 2 bytes of fetch bandwidth
+
+    // Vector unit: lane utilization = vector_elements / vector_lane_slots
+    uint64_t vector_instructions;
+    uint64_t vector_elements;    // Sum of vl over executed vector instructions
+    uint64_t vector_lane_slots;  // Sum of VLMAX over the same instructions
+    uint64_t vop_instructions[VOP_COUNT];
+    uint64_t vop_elements[VOP_COUNT];
+};
+
+#endif
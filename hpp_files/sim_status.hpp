@@ -0,0 +1,16 @@
+#ifndef SIM_STATUS_HPP
+#define SIM_STATUS_HPP
+
+// Status codes returned by the simulator bindings. 0 is success; for any
+// other code getLastError() holds a message describing the failure.
+enum SimStatus {
+    SIM_OK = 0,
+    SIM_ERR_NOT_INITIALIZED,  // No program loaded
+    SIM_ERR_INVALID_ARGUMENT, // Index, address or size out of range
+    SIM_ERR_ASSEMBLY,         // Source failed to assemble
+    SIM_ERR_EXCEPTION,        // Simulator threw while running
+    SIM_ERR_UNSUPPORTED,      // Not available in this build
+    SIM_ERR_LIMIT             // A session limit (memory pages, cycle budget) was reached
+};
+
+#endif
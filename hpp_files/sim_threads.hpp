@@ -0,0 +1,12 @@
+#ifndef SIM_THREADS_HPP
+#define SIM_THREADS_HPP
+
+// SIM_HAS_THREADS is defined wherever std::thread can start threads: every
+// native build and the browser build with -pthread. Without it the batch
+// runner, the service and the corpus runner do their work inline.
+#if !defined(__EMSCRIPTEN__) || defined(__EMSCRIPTEN_PTHREADS__)
+#define SIM_HAS_THREADS 1
+#include <thread>
+#endif
+
+#endif
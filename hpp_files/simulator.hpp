@@ -3,56 +3,228 @@
 
 #include "assembler.hpp"
 #include "pipeline_structs.hpp"
+#include "memory.hpp"
+#include "mmu.hpp"
+#include "sim_stats.hpp"
+#include "sim_delta.hpp"
+#include "sim_hooks.hpp"
+#include "trace_log.hpp"
+#include "stats_counter.hpp"
+#include "decode_cache.hpp"
+#include "vector_unit.hpp"
+#include "xlen.hpp"
 #include <map>
+#include <vector>
 #include <cstring>
+#include <ostream>
+#include <type_traits>
+
+// Granularity of the "contains code" bits used for self-modifying code
+const unsigned int CODE_PAGE_SHIFT = 6; // 64-byte pages
+
+// Plugin sets (see sim_hooks.hpp); each is instantiated for both widths in simulator.cpp
+typedef SimPlugins<TraceLog, StatsCounter> DefaultPlugins; // Text trace and SimStats
+typedef SimPlugins<StatsCounter> StatsPlugins;             // SimStats only (batch runs)
+typedef SimPlugins<> NoPlugins;                            // Bare pipeline
+
+// Pipelined simulator, templated on register width (RV32I / RV64I) and on
+// the plugins that observe it.
+template <int XLEN, class Plugins = DefaultPlugins>
+class RISCV_SimulatorT {
+public:
+    typedef typename XlenTraits<XLEN>::uxlen_t uxlen_t;
+    typedef typename XlenTraits<XLEN>::sxlen_t sxlen_t;
 
-class RISCV_Simulator {
 private:
     // --- Architectural State ---
-    int32_t registers[32];
-    uint8_t data_memory[128]; // 0x00-0x7F
+    sxlen_t registers[32];
+    PagedMemory data_memory; // Sparse; 0x00-0x7F addressable by default
     
     // Reference to Instruction Memory (From your assembler)
     std::map<unsigned int, unsigned int>& inst_memory;
     
-    uint32_t pc;
+    uxlen_t pc;
     uint64_t cycle;
     bool stall_pipeline; // Global stall flag
+    bool halted;         // Trap taken with no handler installed
+    bool halt_pending;   // ... and the older instructions in MEM/WB still retiring
+    bool fetch_fault_pending; // Faulting fetch in flight; IF waits for it
+
+    // --- Address Translation / Traps ---
+    Sv32MMU mmu;
+    unsigned int walk_stall; // Cycles left on an in-progress page-table walk
+    uxlen_t mtvec;           // Trap vector (0 = halt on trap)
+    uxlen_t mepc, mtval;
+    uint32_t mcause;
+
+    // --- Self-Modifying Code ---
+    bool unified_memory;          // Text image lives in data memory
+    std::vector<bool> code_pages; // Bit per code page; only set in unified mode
+    uint32_t text_start, text_end; // Byte range of the mapped text; unified fetch reads any halfword in it
+    uint64_t split_mem_limit;     // Data memory size before unified mode grew it for the text
+    uint64_t unified_mem_limit;   // ... and the size it grew to
+    DecodeCache decode_cache;
+
+    // --- Vector Unit (RVV subset) ---
+    VectorUnit vector;
+
+    // Changes since the last clear_delta()
+    StepDelta delta;
+
+    // --- Reset Point (restored by reset()) ---
+    sxlen_t reset_registers[32];
+    uxlen_t reset_pc;
+    PagedMemory reset_memory;
+    uint32_t reset_satp;
+    uxlen_t reset_mtvec;
+    unsigned int reset_vlen;
+
+    Plugins plugins;
+    uint64_t code_writes; // Stores over code since the reset point
 
     // --- Pipeline Registers (Double Buffered) ---
-    IF_ID  if_id,  if_id_next;
-    ID_EX  id_ex,  id_ex_next;
-    EX_MEM ex_mem, ex_mem_next;
-    MEM_WB mem_wb, mem_wb_next;
+    IF_ID_T<XLEN>  if_id,  if_id_next;
+    ID_EX_T<XLEN>  id_ex,  id_ex_next;
+    EX_MEM_T<XLEN> ex_mem, ex_mem_next;
+    MEM_WB_T<XLEN> mem_wb, mem_wb_next;
 
     // Internal Helpers
-    int32_t sign_extend(uint32_t inst, int type); // 0=I, 1=S, 2=B, 3=J
+    sxlen_t sign_extend(uint32_t inst, int type); // 0=I, 1=S, 2=B, 3=J
+    uint32_t translate(uxlen_t vaddr, AccessType type, uint32_t& paddr, unsigned int& walk_cycles);
+    void take_trap(uint32_t cause, uxlen_t epc, uxlen_t tval);
+    void decode(uint32_t inst, DecodedInst& d);
+    const DecodedInst& decode_cached(uint32_t addr, uint32_t inst, bool& hit);
+    void invalidate_code(uint32_t addr, uint32_t len);
+    void drop_decodes(uint32_t addr, uint32_t len);
+    void map_text();
+    void execute_vector(ExecEvent<XLEN>& ev);
+    void memory_vector(MemEvent<XLEN>& ev);
+    bool is_code(uint32_t addr) const {
+        uint32_t page = addr >> CODE_PAGE_SHIFT;
+        return page < code_pages.size() && code_pages[page];
+    }
 
 public:
-    RISCV_Simulator(std::map<unsigned int, unsigned int>& imem);
+    RISCV_SimulatorT(std::map<unsigned int, unsigned int>& imem);
 
     // Core Execution
     void step();     // Execute 1 Cycle
     void run();      // Run until end
+
+    // Capture registers, PC, memory, satp, mtvec and VLEN as the state reset() returns to
+    void save_reset_point();
+    // Back to the reset point in place: no reallocation, decode cache kept unless code was patched
+    void reset();
     
     // Getters for GUI/Console Output
-    uint32_t get_pc() const { return pc; }
-    int32_t get_reg(int idx) const { return registers[idx]; }
-    uint8_t get_mem(int addr) const { return data_memory[addr]; }
+    uxlen_t get_pc() const { return pc; }
+    sxlen_t get_reg(int idx) const { return registers[idx]; }
+    uint8_t get_mem(int addr) const { return data_memory.read8(addr); }
+    uint32_t get_mem_size() const { return (uint32_t)data_memory.limit(); }
+    void read_mem_block(uint32_t addr, uint8_t* dst, uint32_t len) const { data_memory.read_block(addr, dst, len); }
+    bool is_halted() const { return halted; }
+    // Pipeline counters come from StatsCounter and are zero without it
+    SimStats get_stats() const;
+
+    // One plugin of the set, e.g. plugin<TraceLog>()
+    template <class P> P& plugin() { return plugins; }
+    template <class P> const P& plugin() const { return plugins; }
+
+    // What changed since the last clear_delta() (see sim_delta.hpp)
+    const StepDelta& get_delta() const { return delta; }
+    void clear_delta() { delta.clear(); }
+
+    // Halted, or fetch has passed text_end and every latch has drained
+    bool is_drained(uxlen_t text_end) const {
+        if (halted) return true;
+        if (pc < text_end) return false;
+        return !if_id.IR && !if_id.trap && !id_ex.IR && !id_ex.trap && !ex_mem.IR && !mem_wb.IR;
+    }
 
-    void set_reg(int idx, int32_t val) {
-        if (idx > 0 && idx < 32) registers[idx] = val;
+    // Redirect the TraceLog plugin (std::cout by default); a no-op without one
+    void set_trace(std::ostream& out) {
+        if constexpr (std::is_base_of<TraceLog, Plugins>::value) plugins.TraceLog::set_output(out);
+    }
+    // Pause or resume the TraceLog plugin; a no-op without one
+    void set_trace_enabled(bool on) {
+        if constexpr (std::is_base_of<TraceLog, Plugins>::value) plugins.TraceLog::set_enabled(on);
+    }
+
+    void set_reg(int idx, sxlen_t val) {
+        if (idx > 0 && idx < 32) {
+            if (registers[idx] != val) delta.regs |= 1u << idx;
+            registers[idx] = val;
+        }
     }
 
     void set_memory(int addr, uint8_t val) {
-        if (addr >= 0 && addr < 128) data_memory[addr] = val;
+        if (addr >= 0 && data_memory.in_bounds(addr, 1)) {
+            data_memory.write8(addr, val);
+            delta.note_mem(addr, 1);
+            if (is_code(addr)) invalidate_code(addr, 1);
+        }
+    }
+
+    // Bulk write with one bounds check for the span; false if it does not fit
+    // or the page arena ran out part way
+    bool write_mem_block(uint32_t addr, const uint8_t* src, uint32_t len);
+
+    // Copy an assembled data segment (word address -> value) into memory
+    void load_data(const std::map<unsigned int, int32_t>& data);
+
+    // Hot reload: inst_memory was patched over [addr, addr + len). Drops stale
+    // decodes and, in unified mode, rewrites those text bytes in memory and the reset image.
+    void reload_code(uint32_t addr, uint32_t len);
+    // Patch the reset image only; live memory keeps its current contents
+    bool patch_reset_memory(uint32_t addr, const uint8_t* src, uint32_t len);
+
+    // Unified instruction/data address space (enables self-modifying code)
+    void set_unified_memory(bool enable);
+    bool is_unified_memory() const { return unified_memory; }
+
+    // Physical memory size (page tables must fit inside it)
+    void set_mem_size(uint32_t bytes) { data_memory.set_limit(bytes); }
+
+    // Draw memory and reset-image pages from a fixed arena (nullptr: the heap).
+    // Stores that need a page once it is empty are dropped and set memory_exhausted().
+    void set_page_arena(PageArena* arena) {
+        data_memory.set_arena(arena);
+        reset_memory.set_arena(arena);
+    }
+    bool memory_exhausted() const { return data_memory.exhausted() || reset_memory.exhausted(); }
+    size_t resident_pages() const { return data_memory.page_count() + reset_memory.page_count(); }
+
+    // Virtual memory: writing satp with MODE=1 enables Sv32 translation (RV32 only)
+    void set_satp(uint32_t value) { mmu.set_satp(value); }
+    uint32_t get_satp() const { return mmu.get_satp(); }
+    void configure_tlbs(size_t itlb_entries, size_t dtlb_entries) {
+        mmu.itlb.resize(itlb_entries);
+        mmu.dtlb.resize(dtlb_entries);
+    }
+
+    // Traps: mtvec = 0 halts the simulator on a fault
+    void set_trap_vector(uxlen_t addr) { mtvec = addr; }
+    uint32_t get_trap_cause() const { return mcause; }
+    uxlen_t get_trap_value() const { return mtval; }
+    uxlen_t get_trap_pc() const { return mepc; }
+
+    // Vector unit: VLEN in bits (power of two, 32..MAX_VLEN)
+    bool set_vlen(unsigned int bits) { return vector.set_vlen(bits); }
+    unsigned int get_vlen() const { return vector.vlen; }
+    unsigned int get_vl() const { return vector.vl; }
+    int32_t get_vreg(int idx, int elem) const {
+        if (idx < 0 || idx >= 32 || elem < 0 || elem >= (int)MAX_VLEN_ELEMS) return 0;
+        return vector.vreg[idx][elem];
     }
     
     // Access to internal pipeline state for display
-    IF_ID  get_if_id()  { return if_id; }
-    ID_EX  get_id_ex()  { return id_ex; }
-    EX_MEM get_ex_mem() { return ex_mem; }
-    MEM_WB get_mem_wb() { return mem_wb; }
+    IF_ID_T<XLEN>  get_if_id()  { return if_id; }
+    ID_EX_T<XLEN>  get_id_ex()  { return id_ex; }
+    EX_MEM_T<XLEN> get_ex_mem() { return ex_mem; }
+    MEM_WB_T<XLEN> get_mem_wb() { return mem_wb; }
 };
 
+typedef RISCV_SimulatorT<32> RISCV_Simulator;   // RV32I
+typedef RISCV_SimulatorT<64> RISCV_Simulator64; // RV64I
+
 #endif
\ No newline at end of file
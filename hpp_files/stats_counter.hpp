@@ -0,0 +1,60 @@
+#ifndef STATS_COUNTER_HPP
+#define STATS_COUNTER_HPP
+
+#include "sim_hooks.hpp"
+#include "sim_stats.hpp"
+#include <cstring>
+
+/**
+ * Fills the pipeline counters of SimStats from the hooks. TLB and page-walk
+ * counts live in the MMU and code_writes in the simulator; get_stats() adds
+ * them. Without this plugin get_stats() reports zero for the rest.
+ */
+struct StatsCounter : SimPlugin {
+    SimStats stats;
+
+    StatsCounter() { on_reset(); }
+
+    void on_reset() { std::memset(&stats, 0, sizeof(stats)); }
+    void on_cycle(uint64_t) { stats.cycles++; }
+
+    template <int XLEN>
+    void on_fetch(const FetchEvent<XLEN>& e) {
+        if (e.kind != FETCH_OK) return;
+        stats.fetch_bytes += e.size;
+        if (e.size == 2) stats.compressed_fetches++;
+    }
+
+    template <int XLEN>
+    void on_decode(const DecodeEvent<XLEN>& e) {
+        if (e.IR == 0) return;
+        if (e.cache_hit) stats.decode_hits++;
+        else stats.decode_misses++;
+    }
+
+    template <int XLEN>
+    void on_execute(const ExecEvent<XLEN>& e) {
+        if (e.vop < 0) return;
+        stats.vector_instructions++;
+        stats.vector_elements += e.vl;
+        stats.vector_lane_slots += e.vlmax;
+        stats.vop_instructions[e.vop]++;
+        stats.vop_elements[e.vop] += e.vl;
+    }
+
+    template <int XLEN>
+    void on_writeback(const WritebackEvent<XLEN>&) { stats.instructions++; }
+
+    void on_stall(const StallEvent& e) {
+        if (e.kind == STALL_WALK) stats.walk_cycles++;
+        else stats.stall_cycles++;
+    }
+
+    template <int XLEN>
+    void on_flush(const FlushEvent<XLEN>& e) {
+        stats.flushes++;
+        if (e.kind == FLUSH_TRAP) stats.traps++;
+    }
+};
+
+#endif
@@ -0,0 +1,41 @@
+#ifndef TRACE_LOG_HPP
+#define TRACE_LOG_HPP
+
+#include "sim_hooks.hpp"
+#include "disassembler.hpp"
+#include <ostream>
+
+/**
+ * The per-cycle text trace ("[IF] Fetched ...", "[EX] ADD: ...") as a
+ * simulator plugin. Writes to std::cout unless redirected; an ostream with
+ * no buffer (std::ostream(nullptr)) discards the text but still pays for
+ * formatting it, so leave the plugin out where nobody reads the trace.
+ * set_enabled(false) pauses it instead: every hook returns before
+ * formatting anything. Hooks are defined in trace_log.cpp for XLEN 32 and 64.
+ */
+class TraceLog : public SimPlugin {
+public:
+    TraceLog();
+
+    void set_output(std::ostream& out) { this->out = &out; }
+    void set_enabled(bool on) { enabled = on; }
+
+    void on_cycle(uint64_t cycle);
+    void on_cycle_end();
+    template <int XLEN> void on_fetch(const FetchEvent<XLEN>& e);
+    template <int XLEN> void on_decode(const DecodeEvent<XLEN>& e);
+    template <int XLEN> void on_execute(const ExecEvent<XLEN>& e);
+    template <int XLEN> void on_mem_access(const MemEvent<XLEN>& e);
+    template <int XLEN> void on_writeback(const WritebackEvent<XLEN>& e);
+    void on_stall(const StallEvent& e);
+    template <int XLEN> void on_flush(const FlushEvent<XLEN>& e);
+
+private:
+    template <int XLEN> void execute_vector(const ExecEvent<XLEN>& e);
+
+    std::ostream* out;
+    bool enabled;
+    DisasmCache disasm; // Mnemonics for the decode line
+};
+
+#endif
@@ -4,8 +4,9 @@
 #include "assembler.hpp"
 
 unsigned int binToUint(const string& bin);
-int getRegisterNumber(const string& reg);
-int getImmediateValue(const string& immStr);
+int getRegisterNumber(string_view reg);
+int getVectorRegisterNumber(string_view reg);
+int getImmediateValue(string_view immStr);
 vector<string> split(const string& s, char delimiter);
 
 #endif
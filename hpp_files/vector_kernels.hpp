@@ -0,0 +1,24 @@
+#ifndef VECTOR_KERNELS_HPP
+#define VECTOR_KERNELS_HPP
+
+#include <cstdint>
+
+// Element loops for the vector unit (SEW = 32). Each kernel uses the widest
+// host SIMD available at compile time (AVX2, SSE2/SSE4.1, WASM SIMD128) and
+// finishes the tail in scalar code. Arithmetic wraps modulo 2^32.
+void vk_add_i32(int32_t* dst, const int32_t* a, const int32_t* b, unsigned int n);
+void vk_mul_i32(int32_t* dst, const int32_t* a, const int32_t* b, unsigned int n);
+void vk_sll_i32(int32_t* dst, const int32_t* a, const int32_t* shift, unsigned int n); // Per-element shift (low 5 bits)
+void vk_slli_i32(int32_t* dst, const int32_t* a, unsigned int shift, unsigned int n); // Uniform shift
+int32_t vk_redsum_i32(const int32_t* a, unsigned int n);
+
+// Lane-parallel helpers (lane_sim). Masks are 0 / -1 per element.
+void vk_slt_i32(int32_t* dst, const int32_t* a, const int32_t* b, unsigned int n);   // 1 / 0
+void vk_cmpeq_i32(int32_t* mask, const int32_t* a, const int32_t* b, unsigned int n); // -1 / 0
+void vk_cmplt_i32(int32_t* mask, const int32_t* a, const int32_t* b, unsigned int n); // -1 / 0
+void vk_blend_i32(int32_t* dst, const int32_t* src, const int32_t* mask, unsigned int n); // dst = mask ? src : dst
+
+// Name of the SIMD backend compiled in (for stats/diagnostics)
+const char* vk_backend();
+
+#endif
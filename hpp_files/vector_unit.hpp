@@ -0,0 +1,110 @@
+#ifndef VECTOR_UNIT_HPP
+#define VECTOR_UNIT_HPP
+
+#include <cstdint>
+#include <cstring>
+#include <utility>
+
+// RVV subset: SEW = 32, LMUL = 1, unmasked. VLEN is set at runtime up to MAX_VLEN.
+const unsigned int MAX_VLEN = 1024;              // Bits per vector register
+const unsigned int MAX_VLEN_ELEMS = MAX_VLEN / 32;
+const unsigned int DEFAULT_VLEN = 128;
+
+// vtype fields (zimm of vsetvli)
+const uint32_t VTYPE_VSEW_SHIFT = 3;
+const uint32_t VTYPE_VSEW_MASK  = 0x7;
+const uint32_t VTYPE_VLMUL_MASK = 0x7;
+const uint32_t VTYPE_VTA = 1u << 6;
+const uint32_t VTYPE_VMA = 1u << 7;
+const uint32_t VSEW_E32 = 0x2;
+
+// Vector result travelling down the pipeline next to EX/MEM or MEM/WB
+struct VecStage {
+    unsigned int vl;           // Elements carried in data[]
+    uint32_t pa;               // Physical address of element 0 (vle32/vse32)
+    uint32_t pa_next;          // Physical base of the following page when the access splits
+    unsigned int split;        // First element that lives on the following page (== vl if none)
+    alignas(32) int32_t data[MAX_VLEN_ELEMS];
+};
+
+// Vector register file, vl/vtype CSRs and the staging buffers for in-flight
+// vector results. Staging buffers are double buffered like the latches, by
+// swapping indices instead of copying MAX_VLEN bits every cycle.
+class VectorUnit {
+public:
+    VectorUnit() { reset(); }
+
+    void reset() {
+        std::memset(vreg, 0, sizeof(vreg));
+        std::memset(stages, 0, sizeof(stages));
+        vlen = DEFAULT_VLEN;
+        vl = 0;
+        vtype = 0;
+        vill = true; // No vsetvli executed yet
+        slot[0] = 0; slot[1] = 1; slot[2] = 2; slot[3] = 3;
+    }
+
+    // VLEN must be a power of two in [32, MAX_VLEN]
+    bool set_vlen(unsigned int bits) {
+        if (bits < 32 || bits > MAX_VLEN || (bits & (bits - 1)) != 0) return false;
+        vlen = bits;
+        if (vl > vlmax()) vl = vlmax();
+        return true;
+    }
+
+    unsigned int vlmax() const { return vlen / 32; }
+
+    // vsetvli: returns the new vl. Anything other than e32/m1 sets vill.
+    unsigned int configure(uint32_t zimm, uint64_t avl, bool keep_vl, bool use_vlmax) {
+        uint32_t vsew = (zimm >> VTYPE_VSEW_SHIFT) & VTYPE_VSEW_MASK;
+        uint32_t vlmul = zimm & VTYPE_VLMUL_MASK;
+        if (vsew != VSEW_E32 || vlmul != 0 || (zimm >> 8) != 0) {
+            vill = true;
+            vtype = 0;
+            vl = 0;
+            return vl;
+        }
+        vill = false;
+        vtype = zimm;
+        if (use_vlmax) vl = vlmax();
+        else if (!keep_vl) vl = (avl < vlmax()) ? (unsigned int)avl : vlmax();
+        else if (vl > vlmax()) vl = vlmax();
+        return vl;
+    }
+
+    // Copy the first n elements of vs into a staging buffer
+    void write_stage(VecStage& stage, uint8_t vs, unsigned int n) const {
+        std::memcpy(stage.data, vreg[vs], n * sizeof(int32_t));
+    }
+
+    // Tail-undisturbed write of the first n elements
+    void write(uint8_t vd, const int32_t* src, unsigned int n) {
+        std::memcpy(vreg[vd], src, n * sizeof(int32_t));
+    }
+
+    VecStage& ex_mem()      { return stages[slot[0]]; }
+    VecStage& ex_mem_next() { return stages[slot[1]]; }
+    VecStage& mem_wb()      { return stages[slot[2]]; }
+    VecStage& mem_wb_next() { return stages[slot[3]]; }
+
+    // MEM stage hand-off for results that need no memory access
+    void pass_through() { std::swap(slot[0], slot[3]); }
+
+    // Latch update at the end of a cycle
+    void advance() {
+        std::swap(slot[0], slot[1]);
+        std::swap(slot[2], slot[3]);
+    }
+
+    alignas(32) int32_t vreg[32][MAX_VLEN_ELEMS];
+    unsigned int vlen;
+    unsigned int vl;
+    uint32_t vtype;
+    bool vill;
+
+private:
+    VecStage stages[4];
+    unsigned char slot[4]; // ex_mem, ex_mem_next, mem_wb, mem_wb_next
+};
+
+#endif
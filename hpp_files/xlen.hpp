@@ -0,0 +1,26 @@
+#ifndef XLEN_HPP
+#define XLEN_HPP
+
+#include <cstdint>
+
+// Build-time register width for the GUI/library build: -DRISCV_XLEN=64 for RV64I
+#ifndef RISCV_XLEN
+#define RISCV_XLEN 32
+#endif
+
+// Register-width types; instructions stay 32 bits wide in both modes
+template <int XLEN> struct XlenTraits;
+
+template <> struct XlenTraits<32> {
+    typedef uint32_t uxlen_t;
+    typedef int32_t  sxlen_t;
+    static const unsigned int SHAMT_MASK = 0x1F;
+};
+
+template <> struct XlenTraits<64> {
+    typedef uint64_t uxlen_t;
+    typedef int64_t  sxlen_t;
+    static const unsigned int SHAMT_MASK = 0x3F;
+};
+
+#endif
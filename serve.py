@@ -0,0 +1,19 @@
+#!/usr/bin/env python3
+"""Static file server that sends the cross-origin isolation headers
+(COOP/COEP) the -pthread build needs for SharedArrayBuffer.
+Usage: python3 serve.py [port]"""
+import sys
+from http.server import SimpleHTTPRequestHandler, ThreadingHTTPServer
+
+
+class IsolatedHandler(SimpleHTTPRequestHandler):
+    def end_headers(self):
+        self.send_header("Cross-Origin-Opener-Policy", "same-origin")
+        self.send_header("Cross-Origin-Embedder-Policy", "require-corp")
+        super().end_headers()
+
+
+if __name__ == "__main__":
+    port = int(sys.argv[1]) if len(sys.argv) > 1 else 8000
+    print(f"Serving on http://localhost:{port} (cross-origin isolated)")
+    ThreadingHTTPServer(("", port), IsolatedHandler).serve_forever()
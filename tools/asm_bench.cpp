@@ -0,0 +1,111 @@
+// Assembler throughput and heap traffic on a generated program. Native only
+// (has its own main, so it is kept out of cpp_files).
+//
+//   g++ -std=c++17 -O2 tools/asm_bench.cpp $(ls cpp_files/*.cpp | grep -v main.cpp) -o asm_bench
+//   ./asm_bench -n 1000000
+//
+// -n source lines (default 1000000), -r repeat the whole assembly R times
+// (default 3; the best time is reported). Allocation counts come from a
+// replaced global operator new and cover each pass on its own.
+#include "../hpp_files/assembler.hpp"
+#include "../hpp_files/parser.hpp"
+#include "../hpp_files/encoder.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+using Clock = std::chrono::steady_clock;
+
+static size_t allocations = 0;
+
+void* operator new(size_t size) {
+    allocations++;
+    if (void* p = malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+void operator delete(void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { free(p); }
+
+// Preprocessed lines (as readAndPreprocess returns them): a .data block, then
+// loops of loads, stores, shifts and compares closed by a branch
+static vector<string> generate(size_t count) {
+    vector<string> lines;
+    lines.reserve(count);
+    lines.push_back(".data");
+    for (int i = 0; i < 64; i++) lines.push_back("w" + to_string(i) + ": .word " + to_string(i * 3));
+    lines.push_back(".text");
+    static const char* body[] = {
+        "lw x5, 8(x0)", "slli x6, x5, 2", "slt x7, x0, x5", "sll x8, x6, x7",
+        "sw x8, 16(x0)", "lw x9, 0x20(x0)", "blt x9, x5, L%zu", "sw x9, 24(x0)",
+    };
+    size_t block = 0;
+    char buf[64];
+    while (lines.size() < count) {
+        snprintf(buf, sizeof buf, "L%zu: lw x5, 4(x0)", block);
+        lines.push_back(buf);
+        for (const char* fmt : body) {
+            snprintf(buf, sizeof buf, fmt, block);
+            lines.push_back(buf);
+        }
+        snprintf(buf, sizeof buf, "beq x5, x0, L%zu", block);
+        lines.push_back(buf);
+        block++;
+    }
+    return lines;
+}
+
+struct PassResult {
+    double seconds;
+    size_t allocations;
+};
+
+template <typename F>
+static PassResult measure(F&& pass) {
+    size_t before = allocations;
+    auto t0 = Clock::now();
+    pass();
+    return {std::chrono::duration<double>(Clock::now() - t0).count(), allocations - before};
+}
+
+int main(int argc, char** argv) {
+    size_t count = 1000000;
+    int repeats = 3;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        if (!strcmp(argv[i], "-n")) count = strtoull(argv[i + 1], nullptr, 0);
+        else if (!strcmp(argv[i], "-r")) repeats = atoi(argv[i + 1]);
+    }
+
+    vector<string> lines = generate(count);
+    const char* names[] = {"symbols", "data", "parse", "relax", "encode"};
+    PassResult best[5];
+    size_t instructionCount = 0;
+
+    for (int r = 0; r < repeats; r++) {
+        vector<ParsedInstruction> instructions;
+        PassResult pass[5];
+        pass[0] = measure([&] { SYMBOL_TABLE = buildSymbolTable(lines); });
+        pass[1] = measure([&] { DATA_SEGMENT.clear(); parseDataSection(lines); });
+        pass[2] = measure([&] { PARSE_ARENA.reset(); instructions = parseInstructions(lines); });
+        pass[3] = measure([&] { relaxCompressed(instructions, lines); });
+        pass[4] = measure([&] { INSTRUCTION_MEMORY = translateToOpcode(instructions); });
+        instructionCount = instructions.size();
+        for (int p = 0; p < 5; p++) {
+            if (r == 0 || pass[p].seconds < best[p].seconds) best[p] = pass[p];
+        }
+    }
+
+    double total = 0;
+    size_t totalAllocs = 0;
+    printf("%zu lines, %zu instructions, sizeof(ParsedInstruction) = %zu\n",
+           lines.size(), instructionCount, sizeof(ParsedInstruction));
+    printf("%-8s %10s %14s\n", "pass", "ms", "allocations");
+    for (int p = 0; p < 5; p++) {
+        printf("%-8s %10.1f %14zu\n", names[p], best[p].seconds * 1e3, best[p].allocations);
+        total += best[p].seconds;
+        totalAllocs += best[p].allocations;
+    }
+    printf("%-8s %10.1f %14zu\n", "total", total * 1e3, totalAllocs);
+    return 0;
+}
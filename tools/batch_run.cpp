@@ -0,0 +1,205 @@
+// Runs one program from many initial states on the pipelined simulator and
+// prints a table of final states and cycle counts (randomized-input grading).
+// Native only (has its own main, so it is kept out of cpp_files).
+//
+//   g++ -std=c++17 -O2 -pthread tools/batch_run.cpp $(ls cpp_files/*.cpp | grep -v main.cpp) -o batch_run
+//   ./batch_run demo/sample.s -n 10000 -m 0 --random 1
+//   ./batch_run prog.s --seeds states.txt --show x5,mem[12]
+//
+// -n STATES       number of states (default 1000)
+// -r REG/-m ADDR  swept input: register xREG or the data word at ADDR (default -m 0)
+// -b BASE         state i gets BASE + i (default 0)
+// --random SEED   state i gets a random value in [-1024, 1023] instead
+// --seeds FILE    one state per line, e.g. "x5=3 mem[8]=-2"; overrides -n/-r/-m
+// --show LIST     columns to print, e.g. x5,x6,mem[12] (default: swept input + data words)
+// -t THREADS      worker threads (default: hardware threads)
+// --csv           comma-separated output
+#include "../hpp_files/assembler.hpp"
+#include "../hpp_files/parser.hpp"
+#include "../hpp_files/encoder.hpp"
+#include "../hpp_files/batch_sim.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <random>
+#include <sstream>
+
+// A register (reg > 0) or a data word (reg == 0, at addr)
+struct Column {
+    int reg;
+    uint32_t addr;
+    string name;
+};
+
+static bool parseColumn(const string& text, Column& col) {
+    if (text.size() > 1 && text[0] == 'x') {
+        col.reg = atoi(text.c_str() + 1);
+        col.addr = 0;
+        col.name = text;
+        return col.reg > 0 && col.reg < 32;
+    }
+    if (text.compare(0, 4, "mem[") == 0 && text.back() == ']') {
+        col.reg = 0;
+        col.addr = strtoul(text.c_str() + 4, nullptr, 0);
+        col.name = text;
+        return true;
+    }
+    return false;
+}
+
+static void assign(BatchSimulator& batch, size_t state, const Column& col, int32_t value) {
+    if (col.reg > 0) batch.regs(state)[col.reg] = value;
+    else if ((uint64_t)col.addr + 4 <= batch.mem_bytes()) memcpy(batch.memory(state) + col.addr, &value, 4);
+}
+
+static const char* statusName(BatchStatus status) {
+    switch (status) {
+    case BATCH_FINISHED: return "ok";
+    case BATCH_HALTED:   return "trap";
+    case BATCH_TIMEOUT:  return "timeout";
+    default:             return "-";
+    }
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        fprintf(stderr, "usage: %s program.s [-n states] [-r reg | -m addr] [-b base] [--random seed]\n"
+                        "       [--seeds file] [--show x5,mem[12]] [-t threads] [--csv]\n", argv[0]);
+        return 1;
+    }
+
+    size_t states = 1000;
+    Column sweep = {0, 0, "mem[0]"};
+    int32_t base = 0;
+    bool random = false;
+    unsigned int seed = 0;
+    string seedFile, show;
+    bool csv = false;
+    BatchConfig config;
+
+    for (int i = 2; i < argc; i++) {
+        string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--csv") csv = true;
+        else if (arg == "-n" && hasValue) states = strtoull(argv[++i], nullptr, 0);
+        else if (arg == "-r" && hasValue) { sweep.reg = atoi(argv[++i]); sweep.name = "x" + to_string(sweep.reg); }
+        else if (arg == "-m" && hasValue) { sweep.reg = 0; sweep.addr = strtoul(argv[++i], nullptr, 0); sweep.name = "mem[" + to_string(sweep.addr) + "]"; }
+        else if (arg == "-b" && hasValue) base = atoi(argv[++i]);
+        else if (arg == "--random" && hasValue) { random = true; seed = strtoul(argv[++i], nullptr, 0); }
+        else if (arg == "--seeds" && hasValue) seedFile = argv[++i];
+        else if (arg == "--show" && hasValue) show = argv[++i];
+        else if (arg == "-t" && hasValue) config.threads = atoi(argv[++i]);
+        else { fprintf(stderr, "unknown option %s\n", arg.c_str()); return 1; }
+    }
+    if (sweep.reg < 0 || sweep.reg >= 32) { fprintf(stderr, "register out of range\n"); return 1; }
+
+    // Assemble
+    vector<ParsedInstruction> instructions;
+    try {
+        vector<string> lines = readAndPreprocess(argv[1]);
+        SYMBOL_TABLE = buildSymbolTable(lines);
+        parseDataSection(lines);
+        instructions = parseInstructions(lines);
+        relaxCompressed(instructions, lines);
+        INSTRUCTION_MEMORY = translateToOpcode(instructions);
+    } catch (const exception& e) {
+        fprintf(stderr, "assembly failed: %s\n", e.what());
+        return 1;
+    }
+    if (instructions.empty()) { fprintf(stderr, "no instructions\n"); return 1; }
+    uint32_t textEnd = instructions.back().address + instructions.back().size;
+
+    // Initial states from a file: one line per state of name=value pairs
+    vector<vector<pair<Column, int32_t>>> fileStates;
+    if (!seedFile.empty()) {
+        ifstream in(seedFile);
+        if (!in.is_open()) { fprintf(stderr, "cannot open %s\n", seedFile.c_str()); return 1; }
+        string line;
+        while (getline(in, line)) {
+            if (line.empty() || line[0] == '#') continue;
+            istringstream fields(line);
+            string field;
+            vector<pair<Column, int32_t>> assignments;
+            while (fields >> field) {
+                size_t eq = field.find('=');
+                Column col;
+                if (eq == string::npos || !parseColumn(field.substr(0, eq), col)) {
+                    fprintf(stderr, "bad seed '%s'\n", field.c_str());
+                    return 1;
+                }
+                assignments.push_back({col, (int32_t)strtol(field.c_str() + eq + 1, nullptr, 0)});
+            }
+            fileStates.push_back(assignments);
+        }
+        states = fileStates.size();
+    }
+
+    BatchSimulator batch(INSTRUCTION_MEMORY, DATA_SEGMENT, textEnd, states, config);
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<int32_t> dist(-1024, 1023);
+    for (size_t s = 0; s < states; s++) {
+        if (!fileStates.empty()) {
+            for (auto const& [col, value] : fileStates[s]) assign(batch, s, col, value);
+        } else {
+            assign(batch, s, sweep, random ? dist(rng) : base + (int32_t)s);
+        }
+    }
+
+    // Output columns
+    vector<Column> columns;
+    if (!show.empty()) {
+        stringstream list(show);
+        string item;
+        while (getline(list, item, ',')) {
+            Column col;
+            if (!parseColumn(item, col)) { fprintf(stderr, "bad column '%s'\n", item.c_str()); return 1; }
+            columns.push_back(col);
+        }
+    } else {
+        if (seedFile.empty() && sweep.reg > 0) columns.push_back(sweep);
+        for (auto const& [addr, val] : DATA_SEGMENT) columns.push_back({0, addr, "mem[" + to_string(addr) + "]"});
+    }
+
+    // Input values, captured before run() overwrites the rows
+    vector<int32_t> inputs;
+    if (seedFile.empty()) {
+        for (size_t s = 0; s < states; s++) {
+            inputs.push_back(sweep.reg > 0 ? batch.regs(s)[sweep.reg] : batch.mem_word(s, sweep.addr));
+        }
+    }
+
+    auto start = chrono::steady_clock::now();
+    batch.run();
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    const char* sep = csv ? "," : " ";
+    printf(csv ? "state" : "%7s", "state");
+    if (!inputs.empty()) printf(csv ? ",in:%s" : " %11s", csv ? sweep.name.c_str() : ("in:" + sweep.name).c_str());
+    printf(csv ? ",cycles,instrs,status" : " %8s %8s %8s", "cycles", "instrs", "status");
+    for (const Column& col : columns) printf(csv ? ",%s" : " %11s", col.name.c_str());
+    printf("\n");
+
+    uint64_t totalCycles = 0, failed = 0;
+    for (size_t s = 0; s < states; s++) {
+        BatchStatus status = batch.status(s);
+        totalCycles += batch.cycles(s);
+        failed += (status != BATCH_FINISHED) ? 1 : 0;
+
+        printf(csv ? "%zu" : "%7zu", s);
+        if (!inputs.empty()) printf(csv ? ",%d" : " %11d", inputs[s]);
+        printf(csv ? ",%llu,%llu,%s" : " %8llu %8llu %8s", (unsigned long long)batch.cycles(s),
+               (unsigned long long)batch.instructions(s), statusName(status));
+        for (const Column& col : columns) {
+            int32_t value = col.reg > 0 ? batch.regs(s)[col.reg] : batch.mem_word(s, col.addr);
+            printf(csv ? "%s%d" : "%s%11d", sep, value);
+        }
+        printf("\n");
+    }
+
+    fprintf(stderr, "%zu states, %u threads, %zu states/tile, %.3f s (%.0f states/s, %.0f cycles/s), %llu not finished\n",
+            states, batch.thread_count(), batch.tile_states(), seconds, states / seconds, totalCycles / seconds,
+            (unsigned long long)failed);
+    return failed ? 2 : 0;
+}
@@ -0,0 +1,85 @@
+// Assembles a program and prints each instruction word with its disassembly
+// next to the source line. Native only (has its own main, so it is kept out
+// of cpp_files).
+//
+//   g++ -std=c++17 -O2 tools/disasm.cpp $(ls cpp_files/*.cpp | grep -v main.cpp) -o disasm
+//   ./disasm demo/sample.s
+//   ./disasm prog.s --check
+//
+// --check   re-assemble each disassembled line and report words that differ
+//           (".+N" branch targets are resolved relative to the instruction)
+#include "../hpp_files/assembler.hpp"
+#include "../hpp_files/parser.hpp"
+#include "../hpp_files/encoder.hpp"
+#include "../hpp_files/compressed.hpp"
+#include "../hpp_files/disassembler.hpp"
+#include <cstdio>
+#include <cstring>
+
+// Encode disassembled text at inst's address, resolving ".+N" to a label there
+static bool reencode(const ParsedInstruction& inst, const char* text, unsigned int& word) {
+    string body = text;
+    bool compressed = body.compare(0, 2, "c.") == 0;
+    if (compressed) body = body.substr(2);
+
+    map<string, unsigned int> symbols;
+    size_t dot = body.find(".+");
+    if (dot == string::npos) dot = body.find(".-");
+    if (dot != string::npos) {
+        symbols["__target"] = inst.address + atoi(body.c_str() + dot + 1);
+        body = body.substr(0, dot) + "__target";
+    }
+
+    static AsmArena arena;
+    arena.reset();
+    ParsedInstruction p;
+    string error;
+    if (!parseInstructionLine(body, 0, arena, p, error) || p.mnemonic().empty()) return false;
+    p.address = inst.address;
+    p.rvc = inst.rvc;
+    p.size = compressed ? 2 : 4;
+    try {
+        word = encodeInstruction(p, symbols);
+    } catch (const std::exception&) {
+        return false;
+    }
+    return true;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        fprintf(stderr, "usage: %s program.s [--check]\n", argv[0]);
+        return 1;
+    }
+    bool check = argc > 2 && strcmp(argv[2], "--check") == 0;
+
+    vector<string> lines = readAndPreprocess(argv[1]);
+    vector<ParsedInstruction> instructions;
+    try {
+        SYMBOL_TABLE = buildSymbolTable(lines);
+        parseDataSection(lines);
+        instructions = parseInstructions(lines);
+        relaxCompressed(instructions, lines);
+        INSTRUCTION_MEMORY = translateToOpcode(instructions);
+    } catch (const std::exception& e) {
+        fprintf(stderr, "ERROR: %s\n", e.what());
+        return 1;
+    }
+
+    DisasmCache cache;
+    size_t mismatches = 0;
+    for (const ParsedInstruction& inst : instructions) {
+        unsigned int word = INSTRUCTION_MEMORY.at(inst.address);
+        const char* text = cache.lookup(word);
+        if (inst.size == 2) printf("0x%08x  %04x      %-36s # %.*s\n", inst.address, word, text, (int)inst.text_length, inst.text);
+        else printf("0x%08x  %08x  %-36s # %.*s\n", inst.address, word, text, (int)inst.text_length, inst.text);
+
+        unsigned int again = 0;
+        if (check && (!reencode(inst, text, again) || again != word)) {
+            printf("  MISMATCH: re-encodes to 0x%08x\n", again);
+            mismatches++;
+        }
+    }
+    if (check) printf("%zu instructions, %zu mismatches\n", instructions.size(), mismatches);
+    return mismatches ? 2 : 0;
+}
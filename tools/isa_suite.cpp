@@ -0,0 +1,237 @@
+// ISA conformance runner for self-checking test programs (demo/isa): every
+// test runs on the pipelined simulator and, when the functional lane model
+// covers it, on that model too, both modes on worker threads at once.
+//
+//   g++ -std=c++17 -O2 -pthread tools/isa_suite.cpp $(ls cpp_files/*.cpp | grep -v main.cpp) -o isa_suite
+//   ./isa_suite demo/isa
+//   ./isa_suite demo/isa --mode functional -v
+//
+// The tests use the corpus format of hpp_files/sim_corpus.hpp. Each program
+// reports through its tohost word (mem[0]): 1 means every case passed,
+// (N << 1) | 1 that case N failed, 0 that it never got to report. A test
+// passes when every mode that ran it reports 1, meets its "#=" lines, and
+// both modes end with the same registers and data memory.
+//
+// The lane model (hpp_files/lane_sim.hpp) is scalar RV32 with split memory
+// and no translation, so tests with xlen=64, vlen=, unified=1, satp= or #<
+// lines run pipelined only.
+//
+// -j THREADS      workers (default: hardware threads)
+// --filter TEXT   only tests whose name contains TEXT
+// --mode MODE     both (default), pipelined or functional
+// -v              also list the tests that pass
+#include "../hpp_files/riscvsim.h"
+#include "../hpp_files/riscvsim_program.hpp"
+#include "../hpp_files/sim_corpus.hpp"
+#include "../hpp_files/lane_sim.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <thread>
+
+enum RunMode { MODE_PIPELINED = 0, MODE_FUNCTIONAL, MODE_COUNT };
+
+static const char* modeName(int mode) { return mode == MODE_PIPELINED ? "pipelined" : "functional"; }
+
+struct ModeRun {
+    bool ran = false;
+    CorpusState state;
+    std::vector<std::string> problems; // Empty when the mode passed
+};
+
+static bool addPath(const std::string& path, std::vector<std::string>& files) {
+    std::error_code ec;
+    if (!std::filesystem::is_directory(path, ec)) {
+        files.push_back(path);
+        return true;
+    }
+    std::vector<std::string> found;
+    for (const auto& entry : std::filesystem::directory_iterator(path, ec)) {
+        if (entry.is_regular_file() && entry.path().extension() == ".s") found.push_back(entry.path().string());
+    }
+    if (ec) return false;
+    std::sort(found.begin(), found.end());
+    files.insert(files.end(), found.begin(), found.end());
+    return true;
+}
+
+static bool functionalCovers(const CorpusTest& test) {
+    return test.xlen == 32 && test.vlen == 0 && !test.unified && test.satp == 0 && test.inits.empty();
+}
+
+/**
+ * The same run on the lane model with one lane, into a CorpusState so the
+ * expectations and the cross-check treat both modes alike. Steps stand in
+ * for cycles; a lane fault (an instruction the model lacks) counts as halted.
+ */
+static void runFunctional(const CorpusTest& test, CorpusState& state) {
+    state = CorpusState();
+    rvsim_program* program = nullptr;
+    state.status = rvsim_assemble(test.source.data(), test.source.size(), test.xlen, &program);
+    if (state.status != RVSIM_OK) {
+        state.error = rvsim_last_error();
+        return;
+    }
+
+    uint32_t memBytes = test.mem_bytes ? test.mem_bytes : DATA_MEMORY_SIZE;
+    LaneSimulator lane(program->text, 1, memBytes);
+    lane.load_data(program->data);
+    lane.run(test.max_cycles);
+
+    state.finished = lane.finished();
+    state.halted = lane.lane_faulted(0);
+    state.pc = lane.get_pc(0);
+    state.cycles = state.instructions = lane.get_stats().steps;
+    for (int i = 0; i < 32; i++) state.regs[i] = lane.get_reg(0, i);
+    state.memory.resize(memBytes / 4);
+    for (uint32_t w = 0; w < state.memory.size(); w++) state.memory[w] = lane.get_mem_word(0, w * 4);
+    rvsim_program_free(program);
+}
+
+static std::string tohostReport(int32_t tohost) {
+    if (tohost == 0) return "tohost = 0: the program never reported";
+    if (tohost & 1) return "tohost = " + std::to_string(tohost) + ": case " + std::to_string((uint32_t)tohost >> 1) + " failed";
+    return "tohost = " + std::to_string(tohost) + ": not a pass/fail code";
+}
+
+static std::vector<std::string> checkRun(const CorpusTest& test, const CorpusState& state) {
+    std::vector<std::string> problems = diffCorpusState(test, state);
+    if (state.status == RVSIM_OK && state.finished && !state.memory.empty() && state.memory[0] != 1) {
+        // The program's own report says more than the mem[0] mismatch
+        problems.erase(std::remove_if(problems.begin(), problems.end(),
+                                      [](const std::string& p) { return p.compare(0, 7, "mem[0]:") == 0; }),
+                       problems.end());
+        problems.insert(problems.begin(), tohostReport(state.memory[0]));
+    }
+    return problems;
+}
+
+// Registers and data memory of two finished runs, compared at the test's width
+static std::vector<std::string> compareModes(const CorpusTest& test, const CorpusState& a, const CorpusState& b) {
+    std::vector<std::string> out;
+    char line[128];
+    for (int i = 1; i < 32; i++) {
+        int64_t va = test.xlen == 32 ? (int32_t)a.regs[i] : a.regs[i];
+        int64_t vb = test.xlen == 32 ? (int32_t)b.regs[i] : b.regs[i];
+        if (va == vb) continue;
+        snprintf(line, sizeof(line), "x%d: pipelined %lld, functional %lld", i, (long long)va, (long long)vb);
+        out.push_back(line);
+    }
+    size_t words = std::min(a.memory.size(), b.memory.size());
+    for (size_t w = 0; w < words; w++) {
+        if (a.memory[w] == b.memory[w]) continue;
+        snprintf(line, sizeof(line), "mem[%zu]: pipelined %d, functional %d", w * 4, a.memory[w], b.memory[w]);
+        out.push_back(line);
+    }
+    return out;
+}
+
+int main(int argc, char** argv) {
+    std::vector<std::string> files;
+    unsigned int threads = 0;
+    std::string filter, modeArg = "both";
+    bool verbose = false;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "-v") verbose = true;
+        else if (arg == "-j" && hasValue) threads = atoi(argv[++i]);
+        else if (arg == "--filter" && hasValue) filter = argv[++i];
+        else if (arg == "--mode" && hasValue) modeArg = argv[++i];
+        else if (arg[0] != '-') {
+            if (!addPath(arg, files)) { fprintf(stderr, "cannot list %s\n", arg.c_str()); return 1; }
+        } else {
+            files.clear();
+            break;
+        }
+    }
+    bool modes[MODE_COUNT] = {modeArg != "functional", modeArg != "pipelined"};
+    if (files.empty() || (modeArg != "both" && modeArg != "pipelined" && modeArg != "functional")) {
+        fprintf(stderr, "usage: %s DIR|FILE... [-j threads] [--filter TEXT] [--mode both|pipelined|functional] [-v]\n", argv[0]);
+        return 1;
+    }
+
+    std::vector<CorpusTest> tests;
+    for (const std::string& file : files) {
+        std::string error;
+        if (!loadCorpusFile(file, tests, error)) {
+            fprintf(stderr, "%s\n", error.c_str());
+            return 1;
+        }
+    }
+    tests.erase(std::remove_if(tests.begin(), tests.end(),
+                               [&](const CorpusTest& t) {
+                                   return t.name.find(filter) == std::string::npos ||
+                                          (!modes[MODE_PIPELINED] && !functionalCovers(t));
+                               }),
+                tests.end());
+    if (tests.empty()) {
+        fprintf(stderr, "no tests\n");
+        return 1;
+    }
+
+    // One job per test and mode, so the two modes of a test run side by side
+    std::vector<std::pair<size_t, int>> jobs;
+    for (size_t t = 0; t < tests.size(); t++) {
+        if (modes[MODE_PIPELINED]) jobs.push_back({t, MODE_PIPELINED});
+        if (modes[MODE_FUNCTIONAL] && functionalCovers(tests[t])) jobs.push_back({t, MODE_FUNCTIONAL});
+    }
+    std::vector<std::vector<ModeRun>> runs(tests.size(), std::vector<ModeRun>(MODE_COUNT));
+    if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+    threads = std::min<unsigned int>(threads, (unsigned int)jobs.size());
+
+    auto start = std::chrono::steady_clock::now();
+    std::atomic<size_t> next(0);
+    auto worker = [&]() {
+        for (size_t j; (j = next.fetch_add(1)) < jobs.size();) {
+            const CorpusTest& test = tests[jobs[j].first];
+            ModeRun& run = runs[jobs[j].first][jobs[j].second];
+            if (jobs[j].second == MODE_PIPELINED) runCorpusTest(test, run.state);
+            else runFunctional(test, run.state);
+            run.problems = checkRun(test, run.state);
+            run.ran = true;
+        }
+    };
+    std::vector<std::thread> pool;
+    for (unsigned int i = 1; i < threads; i++) pool.emplace_back(worker);
+    worker();
+    for (std::thread& t : pool) t.join();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    size_t failed = 0, modeRuns[MODE_COUNT] = {0, 0};
+    for (size_t t = 0; t < tests.size(); t++) {
+        const CorpusTest& test = tests[t];
+        std::string where = test.line ? test.file + ":" + std::to_string(test.line) + " " + test.name : test.file;
+        std::vector<std::string> problems;
+        for (int m = 0; m < MODE_COUNT; m++) {
+            if (!runs[t][m].ran) continue;
+            modeRuns[m]++;
+            for (const std::string& p : runs[t][m].problems) problems.push_back(std::string(modeName(m)) + ": " + p);
+        }
+        const ModeRun& p = runs[t][MODE_PIPELINED];
+        const ModeRun& f = runs[t][MODE_FUNCTIONAL];
+        if (p.ran && f.ran && p.state.status == RVSIM_OK && f.state.status == RVSIM_OK) {
+            for (const std::string& d : compareModes(test, p.state, f.state)) problems.push_back("disagree " + d);
+        }
+
+        if (!problems.empty()) {
+            failed++;
+            printf("FAIL %s\n", where.c_str());
+            for (const std::string& d : problems) printf("    %s\n", d.c_str());
+        } else if (verbose) {
+            std::string detail;
+            if (p.ran) detail = std::to_string(p.state.cycles) + " cycles";
+            if (f.ran) detail += (detail.empty() ? "" : ", ") + std::to_string(f.state.instructions) + " steps";
+            if (!f.ran && modes[MODE_FUNCTIONAL]) detail += ", pipelined only";
+            printf("ok   %s (%s)\n", where.c_str(), detail.c_str());
+        }
+    }
+    fflush(stdout);
+    fprintf(stderr, "%zu/%zu passed (%zu pipelined, %zu functional runs) in %.3f s\n", tests.size() - failed,
+            tests.size(), modeRuns[MODE_PIPELINED], modeRuns[MODE_FUNCTIONAL], seconds);
+    return failed ? 2 : 0;
+}
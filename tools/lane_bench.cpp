@@ -0,0 +1,119 @@
+// Input-sweep throughput: N program instances on the SIMD lane model versus
+// N scalar runs. Native only (has its own main, so it is kept out of cpp_files).
+//
+//   g++ -std=c++17 -O2 -mavx2 tools/lane_bench.cpp $(ls cpp_files/*.cpp | grep -v main.cpp) -o lane_bench
+//   ./lane_bench demo/sample.s -n 1024 -m 0
+//
+// -n lanes, -r REG sweeps register xREG, -m ADDR sweeps the data word at ADDR
+// (default: -m 0), -b BASE is the value given to lane 0 (lane i gets BASE + i).
+#include "../hpp_files/assembler.hpp"
+#include "../hpp_files/parser.hpp"
+#include "../hpp_files/encoder.hpp"
+#include "../hpp_files/simulator.hpp"
+#include "../hpp_files/lane_sim.hpp"
+#include "../hpp_files/vector_kernels.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+using Clock = std::chrono::steady_clock;
+
+static double seconds_since(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        fprintf(stderr, "usage: %s program.s [-n lanes] [-r reg | -m addr] [-b base]\n", argv[0]);
+        return 1;
+    }
+
+    unsigned int lanes = 256;
+    int sweep_reg = -1;
+    uint32_t sweep_addr = 0;
+    int32_t base = 0;
+    for (int i = 2; i + 1 < argc; i += 2) {
+        if (!strcmp(argv[i], "-n")) lanes = atoi(argv[i + 1]);
+        else if (!strcmp(argv[i], "-r")) sweep_reg = atoi(argv[i + 1]);
+        else if (!strcmp(argv[i], "-m")) sweep_addr = strtoul(argv[i + 1], nullptr, 0);
+        else if (!strcmp(argv[i], "-b")) base = atoi(argv[i + 1]);
+    }
+
+    vector<string> lines = readAndPreprocess(argv[1]);
+    SYMBOL_TABLE = buildSymbolTable(lines);
+    parseDataSection(lines);
+    vector<ParsedInstruction> instructions = parseInstructions(lines);
+    relaxCompressed(instructions, lines);
+    INSTRUCTION_MEMORY = translateToOpcode(instructions);
+    uint32_t last_addr = instructions.back().address + instructions.back().size;
+
+    auto seed_lane = [&](LaneSimulator& ls, unsigned int lane, int32_t value) {
+        if (sweep_reg > 0) ls.set_reg(lane, sweep_reg, value);
+        else ls.set_mem_word(lane, sweep_addr, value);
+    };
+    const uint64_t max_steps = 1000000;
+
+    // 1. All instances at once on the lane model
+    auto t0 = Clock::now();
+    LaneSimulator simd(INSTRUCTION_MEMORY, lanes);
+    simd.load_data(DATA_SEGMENT);
+    for (unsigned int l = 0; l < lanes; l++) seed_lane(simd, l, base + (int32_t)l);
+    simd.run(max_steps);
+    double simd_time = seconds_since(t0);
+    const LaneRunStats& st = simd.get_stats();
+
+    // 2. Same functional model, one instance at a time
+    uint64_t scalar_instrs = 0;
+    t0 = Clock::now();
+    for (unsigned int l = 0; l < lanes; l++) {
+        LaneSimulator one(INSTRUCTION_MEMORY, 1);
+        one.load_data(DATA_SEGMENT);
+        seed_lane(one, 0, base + (int32_t)l);
+        one.run(max_steps);
+        scalar_instrs += one.get_stats().instance_instructions;
+    }
+    double scalar_time = seconds_since(t0);
+
+    // 3. N pipelined simulators (counters only, no trace); also the reference results
+    unsigned int mismatches = 0;
+    uint64_t pipe_cycles = 0;
+    t0 = Clock::now();
+    for (unsigned int l = 0; l < lanes; l++) {
+        RISCV_SimulatorT<32, StatsPlugins> sim(INSTRUCTION_MEMORY);
+        sim.load_data(DATA_SEGMENT);
+        int32_t value = base + (int32_t)l;
+        if (sweep_reg > 0) sim.set_reg(sweep_reg, value);
+        else sim.load_data({{sweep_addr, value}});
+
+        for (uint64_t c = 0; c < max_steps && !sim.is_drained(last_addr); c++) sim.step();
+        pipe_cycles += sim.get_stats().cycles;
+
+        bool same = true;
+        for (int r = 0; r < 32; r++) same &= (sim.get_reg(r) == simd.get_reg(l, r));
+        uint8_t mem[DATA_MEMORY_SIZE];
+        sim.read_mem_block(0, mem, DATA_MEMORY_SIZE);
+        for (uint32_t a = 0; a + 4 <= DATA_MEMORY_SIZE; a += 4) {
+            int32_t word = mem[a] | (mem[a + 1] << 8) | (mem[a + 2] << 16) | ((uint32_t)mem[a + 3] << 24);
+            same &= (word == simd.get_mem_word(l, a));
+        }
+        if (!same) mismatches++;
+    }
+    double pipe_time = seconds_since(t0);
+
+    uint64_t total = st.instance_instructions;
+    printf("program: %s, %u lanes, sweep %s%u from %d, kernels: %s\n", argv[1], lanes,
+           sweep_reg > 0 ? "x" : "mem[", sweep_reg > 0 ? (unsigned)sweep_reg : sweep_addr, base, vk_backend());
+    printf("%-28s %10s %14s %16s %9s\n", "mode", "time (ms)", "inst-instrs", "inst-instrs/s", "speedup");
+    printf("%-28s %10.3f %14llu %16.0f %9s\n", "SIMD lanes (SoA)", simd_time * 1e3,
+           (unsigned long long)total, total / simd_time, "1.00x");
+    printf("%-28s %10.3f %14llu %16.0f %8.2fx\n", "functional x N (scalar)", scalar_time * 1e3,
+           (unsigned long long)scalar_instrs, scalar_instrs / scalar_time, (scalar_instrs / scalar_time) / (total / simd_time));
+    printf("%-28s %10.3f %14llu %16.0f %8.2fx\n", "pipelined x N (scalar)", pipe_time * 1e3,
+           (unsigned long long)scalar_instrs, scalar_instrs / pipe_time, (scalar_instrs / pipe_time) / (total / simd_time));
+    printf("issue steps %llu, divergent %llu, lane utilization %.1f%%, pipelined cycles %llu\n",
+           (unsigned long long)st.steps, (unsigned long long)st.divergent_steps,
+           st.lane_slots ? 100.0 * total / st.lane_slots : 0.0, (unsigned long long)pipe_cycles);
+    printf("final-state mismatches vs pipelined model: %u\n", mismatches);
+    return mismatches ? 2 : 0;
+}
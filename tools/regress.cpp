@@ -0,0 +1,158 @@
+// Regression runner for expected-state corpora (format in hpp_files/sim_corpus.hpp):
+// runs every test of the given corpus files and directories on all cores,
+// each in a fresh libriscvsim session, and prints the differences from the
+// expected registers, memory, cycle and stall counts.
+//
+//   g++ -std=c++17 -O2 -pthread tools/regress.cpp $(ls cpp_files/*.cpp | grep -v main.cpp) -o regress
+//   ./regress demo/test_codes
+//   ./regress demo/test_codes progs/ -j 8 -v
+//   ./regress demo/test_codes --record       # after an intended timing change
+//
+// Directories contribute every .s file in them (a corpus, or one program with
+// a .expect file next to it).
+//
+// -j THREADS      workers (default: hardware threads)
+// --filter TEXT   only tests whose name contains TEXT
+// --record        rewrite the expectations from this run instead of checking
+// -v              also list the tests that pass
+#include "../hpp_files/riscvsim.h"
+#include "../hpp_files/sim_corpus.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <map>
+
+static bool addPath(const std::string& path, std::vector<std::string>& files) {
+    std::error_code ec;
+    if (!std::filesystem::is_directory(path, ec)) {
+        files.push_back(path);
+        return true;
+    }
+    std::vector<std::string> found;
+    for (const auto& entry : std::filesystem::directory_iterator(path, ec)) {
+        if (entry.is_regular_file() && entry.path().extension() == ".s") found.push_back(entry.path().string());
+    }
+    if (ec) return false;
+    std::sort(found.begin(), found.end());
+    files.insert(files.end(), found.begin(), found.end());
+    return true;
+}
+
+// Writes each file's recorded state; files with a test that did not run are left alone
+static int record(const std::vector<CorpusTest>& tests, const std::vector<CorpusResult>& results) {
+    std::map<std::string, std::vector<size_t>> byFile;
+    std::vector<std::string> order;
+    for (size_t i = 0; i < tests.size(); i++) {
+        if (byFile.find(tests[i].file) == byFile.end()) order.push_back(tests[i].file);
+        byFile[tests[i].file].push_back(i);
+    }
+
+    int failed = 0;
+    for (const std::string& file : order) {
+        std::vector<const CorpusTest*> fileTests;
+        std::vector<const CorpusState*> states;
+        bool ran = true;
+        for (size_t i : byFile[file]) {
+            const CorpusState& s = results[i].state;
+            if (s.status != RVSIM_OK) {
+                printf("FAIL %s %s: %s\n", file.c_str(), tests[i].name.c_str(), s.error.c_str());
+                ran = false;
+            } else if (!s.finished) {
+                printf("warn %s: %s did not finish within %llu cycles\n", file.c_str(), tests[i].name.c_str(),
+                       (unsigned long long)tests[i].max_cycles);
+            }
+            fileTests.push_back(&tests[i]);
+            states.push_back(&s);
+        }
+        std::string error;
+        if (!ran) {
+            printf("not recorded: %s\n", file.c_str());
+            failed++;
+        } else if (!saveRecordedCorpus(file, fileTests, states, error)) {
+            printf("%s\n", error.c_str());
+            failed++;
+        } else {
+            printf("recorded %zu test%s in %s\n", fileTests.size(), fileTests.size() == 1 ? "" : "s",
+                   fileTests.size() == 1 && !fileTests[0]->expect_file.empty() ? fileTests[0]->expect_file.c_str() : file.c_str());
+        }
+    }
+    return failed ? 2 : 0;
+}
+
+int main(int argc, char** argv) {
+    std::vector<std::string> files;
+    unsigned int threads = 0;
+    std::string filter;
+    bool recordMode = false, verbose = false;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--record") recordMode = true;
+        else if (arg == "-v") verbose = true;
+        else if (arg == "-j" && hasValue) threads = atoi(argv[++i]);
+        else if (arg == "--filter" && hasValue) filter = argv[++i];
+        else if (arg[0] != '-') {
+            if (!addPath(arg, files)) { fprintf(stderr, "cannot list %s\n", arg.c_str()); return 1; }
+        } else {
+            files.clear();
+            break;
+        }
+    }
+    if (files.empty()) {
+        fprintf(stderr, "usage: %s CORPUS|DIR... [-j threads] [--filter TEXT] [--record] [-v]\n", argv[0]);
+        return 1;
+    }
+
+    std::vector<CorpusTest> tests;
+    for (const std::string& file : files) {
+        std::string error;
+        if (!loadCorpusFile(file, tests, error)) {
+            fprintf(stderr, "%s\n", error.c_str());
+            return 1;
+        }
+    }
+    // A partial record would drop the other tests' expectations, so --filter only narrows checks
+    if (!filter.empty() && !recordMode) {
+        tests.erase(std::remove_if(tests.begin(), tests.end(),
+                                   [&](const CorpusTest& t) { return t.name.find(filter) == std::string::npos; }),
+                    tests.end());
+    }
+    if (tests.empty()) {
+        fprintf(stderr, "no tests\n");
+        return 1;
+    }
+
+    std::vector<CorpusResult> results;
+    auto start = std::chrono::steady_clock::now();
+    runCorpus(tests, threads, results);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if (recordMode) return record(tests, results);
+
+    // "file:line name" for a corpus test, just the file for a whole-file one
+    auto where = [](const CorpusTest& t) {
+        return t.line ? t.file + ":" + std::to_string(t.line) + " " + t.name : t.file;
+    };
+    size_t failed = 0;
+    uint64_t cycles = 0;
+    for (size_t i = 0; i < tests.size(); i++) {
+        const CorpusTest& t = tests[i];
+        const CorpusResult& r = results[i];
+        cycles += r.state.cycles;
+        if (!r.diffs.empty() || t.expects.empty()) {
+            failed++;
+            printf("FAIL %s\n", where(t).c_str());
+            if (t.expects.empty()) printf("    no expectations\n");
+            for (const std::string& d : r.diffs) printf("    %s\n", d.c_str());
+        } else if (verbose) {
+            printf("ok   %s (%llu cycles, %llu stalls)\n", where(t).c_str(),
+                   (unsigned long long)r.state.cycles, (unsigned long long)r.state.stalls);
+        }
+    }
+    fflush(stdout);
+    fprintf(stderr, "%zu/%zu passed in %.3f s, %.0f cycles/s\n", tests.size() - failed, tests.size(), seconds,
+            cycles / seconds);
+    return failed ? 2 : 0;
+}
@@ -0,0 +1,105 @@
+// Checks that libriscvsim hands sessions back in their after-create state:
+// a pooled session released after a job changed its settings, and a session
+// switching unified memory on and off again. Plain C against riscvsim.h.
+// Prints each failed check and exits with status 1 if there was one.
+//
+//   mkdir -p build && cd build
+//   g++ -std=c++17 -O2 -fPIC -c $(ls ../cpp_files/*.cpp | grep -v main.cpp) && ar rcs libriscvsim.a *.o
+//   gcc -O2 -I../hpp_files ../tools/rvsim_pool_check.c libriscvsim.a -lstdc++ -lm -pthread -o rvsim_pool_check
+//   ./rvsim_pool_check
+#include "riscvsim.h"
+#include <stdio.h>
+#include <string.h>
+
+static const char* SOURCE =
+    ".data\n"
+    "v: .word 3\n"
+    ".text\n"
+    "lw x1, 0(x0)\n"
+    "slli x1, x1, 1\n"
+    "sw x1, 4(x0)\n";
+
+static int failures = 0;
+
+#define CHECK(cond, ...)                        \
+    do {                                        \
+        if (!(cond)) {                          \
+            printf("FAIL line %d: ", __LINE__); \
+            printf(__VA_ARGS__);                \
+            printf("\n");                       \
+            failures++;                         \
+        }                                       \
+    } while (0)
+
+// Memory size and the first words of data memory, as after rvsim_create
+static void check_fresh(rvsim_session* s, uint32_t size, const char* what) {
+    uint32_t words[2];
+    uint8_t text[8];
+    CHECK(rvsim_get_mem_size(s) == size, "%s: memory size %u, expected %u", what, rvsim_get_mem_size(s), size);
+    CHECK(rvsim_read_mem(s, 0, words, sizeof(words)) == RVSIM_OK && words[0] == 3 && words[1] == 0,
+          "%s: data words %u %u, expected 3 0", what, words[0], words[1]);
+    if (size >= 0x88) {
+        static const uint8_t zero[8] = {0};
+        CHECK(rvsim_read_mem(s, 0x80, text, sizeof(text)) == RVSIM_OK && memcmp(text, zero, sizeof(text)) == 0,
+              "%s: text bytes left at 0x80", what);
+    }
+}
+
+static void check_pool(const rvsim_program* program) {
+    rvsim_pool* pool;
+    rvsim_session *first, *again;
+    if (rvsim_pool_create(program, 0, NULL, 0, 1, &pool) != RVSIM_OK) {
+        CHECK(0, "rvsim_pool_create: %s", rvsim_last_error());
+        return;
+    }
+
+    // A job that turns unified memory on and runs to the end
+    CHECK(rvsim_pool_acquire(pool, &first) == RVSIM_OK, "acquire: %s", rvsim_last_error());
+    CHECK(rvsim_set_unified_memory(first, 1) == RVSIM_OK, "unified: %s", rvsim_last_error());
+    CHECK(rvsim_get_mem_size(first) > 128, "unified memory did not grow to hold the text");
+    CHECK(rvsim_run(first, 1000, NULL) == RVSIM_OK && rvsim_is_finished(first), "job did not finish");
+    rvsim_pool_release(pool, first);
+
+    // The next job gets the same session back as if just created
+    CHECK(rvsim_pool_acquire(pool, &again) == RVSIM_OK, "second acquire: %s", rvsim_last_error());
+    CHECK(again == first, "a pool of one handed out a different session");
+    check_fresh(again, 128, "recycled session");
+    CHECK(rvsim_run(again, 1000, NULL) == RVSIM_OK && rvsim_get_reg(again, 1) == 6,
+          "recycled session: x1 = %lld, expected 6", (long long)rvsim_get_reg(again, 1));
+    rvsim_pool_release(pool, again);
+    rvsim_pool_destroy(pool);
+}
+
+static void check_unified_off(const rvsim_program* program) {
+    rvsim_session* s;
+    if (rvsim_create(program, 0, &s) != RVSIM_OK) {
+        CHECK(0, "rvsim_create: %s", rvsim_last_error());
+        return;
+    }
+    CHECK(rvsim_set_mem_size(s, 256) == RVSIM_OK, "mem size: %s", rvsim_last_error());
+    CHECK(rvsim_set_unified_memory(s, 1) == RVSIM_OK, "unified on: %s", rvsim_last_error());
+    CHECK(rvsim_set_unified_memory(s, 0) == RVSIM_OK, "unified off: %s", rvsim_last_error());
+    check_fresh(s, 256, "unified switched off");
+
+    // Without a size set first, switching off shrinks memory to the default again
+    CHECK(rvsim_set_mem_size(s, 128) == RVSIM_OK, "mem size: %s", rvsim_last_error());
+    CHECK(rvsim_set_unified_memory(s, 1) == RVSIM_OK, "unified on: %s", rvsim_last_error());
+    CHECK(rvsim_set_unified_memory(s, 0) == RVSIM_OK, "unified off: %s", rvsim_last_error());
+    check_fresh(s, 128, "unified switched off at the default size");
+    rvsim_destroy(s);
+}
+
+int main(void) {
+    rvsim_program* program;
+    if (rvsim_assemble(SOURCE, strlen(SOURCE), 32, &program) != RVSIM_OK) {
+        printf("assemble: %s\n", rvsim_last_error());
+        return 1;
+    }
+    check_pool(program);
+    check_unified_off(program);
+    rvsim_program_free(program);
+
+    if (failures) return 1;
+    printf("ok\n");
+    return 0;
+}
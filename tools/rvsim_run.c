@@ -0,0 +1,138 @@
+// Runs one program in several libriscvsim sessions at once, one thread per
+// session, session i starting with the data word at address 0 set to i.
+// Plain C against riscvsim.h, so it also checks that the library links
+// without any C++ or Emscripten headers.
+//
+//   mkdir -p build && cd build
+//   g++ -std=c++17 -O2 -fPIC -c $(ls ../cpp_files/*.cpp | grep -v main.cpp) && ar rcs libriscvsim.a *.o
+//   gcc -O2 -I../hpp_files ../tools/rvsim_run.c libriscvsim.a -lstdc++ -lm -pthread -o rvsim_run
+//   ./rvsim_run ../demo/sample.s -t 8
+//
+// -t THREADS     sessions (default 4)
+// -c CYCLES      cycle limit per session (default 100000)
+// --xlen 64      assemble and run as RV64I
+// --trace        print the first session's per-cycle trace
+#include "riscvsim.h"
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define MAX_THREADS 256
+
+typedef struct {
+    const rvsim_program* program;
+    int index;
+    int trace;
+    uint64_t max_cycles;
+    int status;
+    char error[256];
+    int64_t regs[32];
+    rvsim_stats stats;
+    int finished;
+} Job;
+
+static void print_trace(const char* text, size_t length, void* user) {
+    (void)user;
+    fwrite(text, 1, length, stdout);
+}
+
+static void* run_job(void* arg) {
+    Job* job = (Job*)arg;
+    rvsim_session* session = NULL;
+    int32_t input = job->index;
+    int i;
+
+    job->status = rvsim_create(job->program, job->trace ? RVSIM_TRACE : 0, &session);
+    if (job->status == RVSIM_OK && job->trace) job->status = rvsim_set_trace(session, print_trace, NULL);
+    if (job->status == RVSIM_OK) job->status = rvsim_write_mem(session, 0, &input, sizeof(input));
+    if (job->status == RVSIM_OK) job->status = rvsim_run(session, job->max_cycles, NULL);
+    if (job->status == RVSIM_OK) job->status = rvsim_get_stats(session, &job->stats, sizeof(job->stats));
+    if (job->status != RVSIM_OK) {
+        snprintf(job->error, sizeof(job->error), "%s", rvsim_last_error());
+    } else {
+        for (i = 0; i < 32; i++) job->regs[i] = rvsim_get_reg(session, i);
+        job->finished = rvsim_is_finished(session);
+    }
+    rvsim_destroy(session);
+    return NULL;
+}
+
+static char* read_file(const char* path, size_t* length) {
+    FILE* f = fopen(path, "rb");
+    char* buf;
+    long size;
+    if (!f) return NULL;
+    fseek(f, 0, SEEK_END);
+    size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    buf = (char*)malloc(size > 0 ? (size_t)size : 1);
+    *length = fread(buf, 1, (size_t)size, f);
+    fclose(f);
+    return buf;
+}
+
+int main(int argc, char** argv) {
+    const char* path = NULL;
+    int threads = 4, xlen = 32, trace = 0, failed = 0, i, r;
+    uint64_t max_cycles = 100000;
+    rvsim_program* program = NULL;
+    pthread_t tids[MAX_THREADS];
+    Job* jobs;
+    size_t length;
+    char* source;
+
+    for (i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "-t") && i + 1 < argc) threads = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "-c") && i + 1 < argc) max_cycles = strtoull(argv[++i], NULL, 10);
+        else if (!strcmp(argv[i], "--xlen") && i + 1 < argc) xlen = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--trace")) trace = 1;
+        else path = argv[i];
+    }
+    if (!path || threads < 1 || threads > MAX_THREADS) {
+        fprintf(stderr, "usage: %s prog.s [-t THREADS] [-c CYCLES] [--xlen 64] [--trace]\n", argv[0]);
+        return 1;
+    }
+
+    source = read_file(path, &length);
+    if (!source) {
+        fprintf(stderr, "cannot read %s\n", path);
+        return 1;
+    }
+    if (rvsim_assemble(source, length, xlen, &program) != RVSIM_OK) {
+        fprintf(stderr, "%s: %s\n", path, rvsim_last_error());
+        return 1;
+    }
+    free(source);
+
+    jobs = (Job*)calloc((size_t)threads, sizeof(Job));
+    for (i = 0; i < threads; i++) {
+        jobs[i].program = program;
+        jobs[i].index = i;
+        jobs[i].trace = trace && i == 0;
+        jobs[i].max_cycles = max_cycles;
+        pthread_create(&tids[i], NULL, run_job, &jobs[i]);
+    }
+    for (i = 0; i < threads; i++) pthread_join(tids[i], NULL);
+
+    printf("libriscvsim API %u, RV%d, %u instructions, %d sessions\n",
+           rvsim_api_version(), xlen, rvsim_program_instruction_count(program), threads);
+    for (i = 0; i < threads; i++) {
+        if (jobs[i].status != RVSIM_OK) {
+            printf("session %d: error %d: %s\n", i, jobs[i].status, jobs[i].error);
+            failed = 1;
+            continue;
+        }
+        printf("session %d: cycles=%llu instructions=%llu%s", i, (unsigned long long)jobs[i].stats.cycles,
+               (unsigned long long)jobs[i].stats.instructions, jobs[i].finished ? "" : " (cycle limit)");
+        for (r = 1; r < 32; r++) {
+            if (jobs[i].regs[r]) printf(" x%d=%lld", r, (long long)jobs[i].regs[r]);
+        }
+        printf("\n");
+        if (!jobs[i].finished) failed = 1;
+    }
+
+    free(jobs);
+    rvsim_program_free(program);
+    return failed ? 2 : 0;
+}
@@ -0,0 +1,221 @@
+// Load-test client for tools/sim_server: several connections, each sending
+// batches of jobs for one program (job i starting with its swept input) and
+// reading every result before sending the next batch. Reports throughput and
+// per-job latency from batch send to result arrival.
+//
+//   g++ -std=c++17 -O2 -pthread tools/sim_load.cpp $(ls cpp_files/*.cpp | grep -v main.cpp) -o sim_load
+//   ./sim_load demo/sample.s -c 8 -b 50 -j 64
+//   ./sim_load prog.s --port 7878 -m 0 --random 1 --show
+//
+// --socket PATH   server's Unix socket (default /tmp/rvsim.sock)
+// --port N        connect to 127.0.0.1:N instead
+// -c CONNECTIONS  concurrent connections (default 4)
+// -b BATCHES      batches per connection (default 20)
+// -j JOBS         jobs per batch (default 32)
+// -r REG/-m ADDR  swept input: register xREG or the data word at ADDR (default -m 0)
+// --random SEED   random inputs in [-1024, 1023] instead of the job number
+// --cycles N      per-job cycle limit (default: the server's)
+// --mem BYTES     per-job data memory size (default: the simulator's 128 bytes)
+// --xlen 64       assemble as RV64I
+// --show          print every result
+#include "../hpp_files/sim_protocol.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <random>
+#include <sstream>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+struct LoadConfig {
+    std::string socketPath = "/tmp/rvsim.sock";
+    int port = 0;
+    int batches = 20, jobsPerBatch = 32;
+    int reg = 0;
+    uint32_t addr = 0;
+    bool random = false;
+    unsigned int seed = 0;
+    uint64_t cycles = 0;
+    uint32_t memBytes = 0;
+    bool show = false;
+};
+
+struct ConnectionStats {
+    std::vector<double> latencies; // Seconds
+    uint64_t outcomes[4] = {0, 0, 0, 0};
+    uint64_t cycles = 0;
+    std::string error;
+};
+
+static int connectTo(const LoadConfig& cfg) {
+    int fd;
+    if (cfg.port > 0) {
+        fd = ::socket(AF_INET, SOCK_STREAM, 0);
+        sockaddr_in addr = {};
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons((uint16_t)cfg.port);
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        int one = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+        if (::connect(fd, (sockaddr*)&addr, sizeof(addr)) == 0) return fd;
+    } else {
+        fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+        sockaddr_un addr = {};
+        addr.sun_family = AF_UNIX;
+        strncpy(addr.sun_path, cfg.socketPath.c_str(), sizeof(addr.sun_path) - 1);
+        if (::connect(fd, (sockaddr*)&addr, sizeof(addr)) == 0) return fd;
+    }
+    ::close(fd);
+    return -1;
+}
+
+static const char* outcomeName(uint8_t outcome) {
+    switch (outcome) {
+    case JOB_FINISHED: return "ok";
+    case JOB_HALTED:   return "trap";
+    case JOB_TIMEOUT:  return "timeout";
+    default:           return "error";
+    }
+}
+
+static void runConnection(const LoadConfig& cfg, const BatchSource& source, int index, ConnectionStats& stats) {
+    typedef std::chrono::steady_clock Clock;
+    int fd = connectTo(cfg);
+    if (fd < 0) {
+        stats.error = "cannot connect";
+        return;
+    }
+
+    std::mt19937 rng(cfg.seed + index);
+    std::uniform_int_distribution<int32_t> dist(-1024, 1023);
+    std::vector<BatchSource> sources = {source};
+    std::vector<BatchJob> jobs(cfg.jobsPerBatch);
+    std::vector<uint8_t> payload;
+    uint8_t type;
+
+    for (int b = 0; b < cfg.batches && stats.error.empty(); b++) {
+        for (int j = 0; j < cfg.jobsPerBatch; j++) {
+            SimJob& job = jobs[j].job;
+            jobs[j].source = 0;
+            job.id = (uint32_t)((uint64_t)b * cfg.jobsPerBatch + j);
+            job.max_cycles = cfg.cycles;
+            job.mem_bytes = cfg.memBytes;
+            int32_t input = cfg.random ? dist(rng) : (int32_t)job.id;
+            job.inits = {{(uint8_t)(cfg.reg > 0 ? INIT_REG : INIT_MEM_WORD), cfg.reg > 0 ? (uint32_t)cfg.reg : cfg.addr, input}};
+        }
+        WireWriter w;
+        encodeBatch(w, sources, jobs);
+
+        Clock::time_point sent = Clock::now();
+        if (!writeFull(fd, w.buf.data(), w.buf.size())) {
+            stats.error = "connection closed while sending";
+            break;
+        }
+        for (int j = 0; j < cfg.jobsPerBatch; j++) {
+            if (!readFrame(fd, type, payload)) {
+                stats.error = "connection closed while reading results";
+                break;
+            }
+            WireReader r(payload.data(), payload.size());
+            if (type == FRAME_ERROR) {
+                stats.error = "server: " + r.str(MAX_FRAME_BYTES);
+                break;
+            }
+            SimJobResult res;
+            if (type != FRAME_RESULT || !decodeResult(r, res)) {
+                stats.error = "malformed result";
+                break;
+            }
+            stats.latencies.push_back(std::chrono::duration<double>(Clock::now() - sent).count());
+            stats.outcomes[std::min<int>(res.outcome, JOB_ERROR)]++;
+            stats.cycles += res.cycles;
+            if (cfg.show) {
+                std::ostringstream line;
+                line << "conn " << index << " job " << res.id << ": " << outcomeName(res.outcome)
+                     << " cycles=" << res.cycles << " instrs=" << res.instructions;
+                for (int i = 1; i < 32; i++) {
+                    if (res.regs[i]) line << " x" << i << "=" << res.regs[i];
+                }
+                if (!res.error.empty()) line << " (" << res.error << ")";
+                printf("%s\n", line.str().c_str());
+            }
+        }
+    }
+    ::close(fd);
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        fprintf(stderr, "usage: %s program.s [--socket PATH | --port N] [-c connections] [-b batches] [-j jobs]\n"
+                        "       [-r reg | -m addr] [--random seed] [--cycles N] [--mem BYTES] [--xlen 64] [--show]\n", argv[0]);
+        return 1;
+    }
+
+    LoadConfig cfg;
+    int connections = 4;
+    BatchSource source = {32, ""};
+    for (int i = 2; i < argc; i++) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--show") cfg.show = true;
+        else if (arg == "--socket" && hasValue) cfg.socketPath = argv[++i];
+        else if (arg == "--port" && hasValue) cfg.port = atoi(argv[++i]);
+        else if (arg == "-c" && hasValue) connections = atoi(argv[++i]);
+        else if (arg == "-b" && hasValue) cfg.batches = atoi(argv[++i]);
+        else if (arg == "-j" && hasValue) cfg.jobsPerBatch = atoi(argv[++i]);
+        else if (arg == "-r" && hasValue) cfg.reg = atoi(argv[++i]);
+        else if (arg == "-m" && hasValue) { cfg.reg = 0; cfg.addr = strtoul(argv[++i], nullptr, 0); }
+        else if (arg == "--random" && hasValue) { cfg.random = true; cfg.seed = strtoul(argv[++i], nullptr, 0); }
+        else if (arg == "--cycles" && hasValue) cfg.cycles = strtoull(argv[++i], nullptr, 0);
+        else if (arg == "--mem" && hasValue) cfg.memBytes = strtoul(argv[++i], nullptr, 0);
+        else if (arg == "--xlen" && hasValue) source.xlen = atoi(argv[++i]);
+        else { fprintf(stderr, "unknown option %s\n", arg.c_str()); return 1; }
+    }
+    if (connections < 1 || cfg.batches < 1 || cfg.jobsPerBatch < 1 || cfg.reg < 0 || cfg.reg >= 32) {
+        fprintf(stderr, "bad option value\n");
+        return 1;
+    }
+
+    std::ifstream in(argv[1], std::ios::binary);
+    if (!in.is_open()) { fprintf(stderr, "cannot open %s\n", argv[1]); return 1; }
+    std::stringstream text;
+    text << in.rdbuf();
+    source.text = text.str();
+
+    std::vector<ConnectionStats> stats(connections);
+    std::vector<std::thread> threads;
+    auto start = std::chrono::steady_clock::now();
+    for (int c = 0; c < connections; c++) {
+        threads.emplace_back(runConnection, std::cref(cfg), std::cref(source), c, std::ref(stats[c]));
+    }
+    for (std::thread& t : threads) t.join();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::vector<double> latencies;
+    uint64_t outcomes[4] = {0, 0, 0, 0}, cycles = 0;
+    bool failed = false;
+    for (int c = 0; c < connections; c++) {
+        if (!stats[c].error.empty()) {
+            fprintf(stderr, "connection %d: %s\n", c, stats[c].error.c_str());
+            failed = true;
+        }
+        latencies.insert(latencies.end(), stats[c].latencies.begin(), stats[c].latencies.end());
+        for (int k = 0; k < 4; k++) outcomes[k] += stats[c].outcomes[k];
+        cycles += stats[c].cycles;
+    }
+    if (latencies.empty()) return 1;
+
+    std::sort(latencies.begin(), latencies.end());
+    auto percentile = [&](double p) { return latencies[std::min(latencies.size() - 1, (size_t)(p * latencies.size()))] * 1e3; };
+    fprintf(stderr, "%zu jobs over %d connections in %.3f s: %.0f jobs/s, %.0f cycles/s\n",
+            latencies.size(), connections, seconds, latencies.size() / seconds, cycles / seconds);
+    fprintf(stderr, "latency ms: p50 %.2f  p90 %.2f  p99 %.2f  max %.2f\n",
+            percentile(0.50), percentile(0.90), percentile(0.99), latencies.back() * 1e3);
+    fprintf(stderr, "outcomes: %llu ok, %llu trap, %llu timeout, %llu error\n",
+            (unsigned long long)outcomes[JOB_FINISHED], (unsigned long long)outcomes[JOB_HALTED],
+            (unsigned long long)outcomes[JOB_TIMEOUT], (unsigned long long)outcomes[JOB_ERROR]);
+    return failed || outcomes[JOB_ERROR] ? 2 : 0;
+}
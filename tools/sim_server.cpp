@@ -0,0 +1,148 @@
+// Long-running simulation server: accepts batches of assemble+run jobs over a
+// Unix socket or localhost TCP and streams one result frame back per job as
+// it completes. Wire format in hpp_files/sim_protocol.hpp; load client in
+// tools/sim_load.cpp. Native only.
+//
+//   g++ -std=c++17 -O2 -pthread tools/sim_server.cpp $(ls cpp_files/*.cpp | grep -v main.cpp) -o sim_server
+//   ./sim_server --socket /tmp/rvsim.sock -t 8
+//   ./sim_server --port 7878 --max-cycles 200000 --max-mem 65536
+//
+// --socket PATH     Unix socket to listen on (default /tmp/rvsim.sock)
+// --port N          listen on 127.0.0.1:N instead
+// -t THREADS        simulation workers (default: hardware threads)
+// --max-cycles N    per-job cycle cap (default 1000000)
+// --max-mem BYTES   per-job data memory cap (default 1 MiB)
+// --max-source N    per-program source size cap (default 256 KiB)
+#include "../hpp_files/sim_protocol.hpp"
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+// One client; result callbacks hold a reference, so the fd stays open until
+// the last job of the connection has reported
+struct Connection {
+    int fd;
+    std::mutex write_lock;
+    bool broken = false;
+
+    explicit Connection(int fd) : fd(fd) {}
+    ~Connection() { ::close(fd); }
+
+    void send(const std::vector<uint8_t>& frame) {
+        std::lock_guard<std::mutex> guard(write_lock);
+        if (!broken && !writeFull(fd, frame.data(), frame.size())) broken = true;
+    }
+};
+
+static void sendError(Connection& conn, const std::string& message) {
+    WireWriter w;
+    w.begin_frame(FRAME_ERROR);
+    w.str(message);
+    w.end_frame();
+    conn.send(w.buf);
+}
+
+static void serveConnection(SimService& service, std::shared_ptr<Connection> conn) {
+    uint8_t type;
+    std::vector<uint8_t> payload;
+    std::vector<BatchSource> sources;
+    std::vector<BatchJob> jobs;
+    std::string error;
+
+    while (readFrame(conn->fd, type, payload)) {
+        if (type != FRAME_BATCH) {
+            sendError(*conn, "Unexpected frame type " + std::to_string(type));
+            break;
+        }
+        WireReader r(payload.data(), payload.size());
+        if (!decodeBatch(r, service.limits(), sources, jobs, error)) {
+            sendError(*conn, error);
+            break;
+        }
+
+        std::vector<std::shared_ptr<SharedProgram>> programs;
+        for (BatchSource& s : sources) programs.push_back(std::make_shared<SharedProgram>(std::move(s.text), s.xlen));
+        for (BatchJob& bj : jobs) {
+            bj.job.program = programs[bj.source];
+            service.submit(std::move(bj.job), [conn](const SimJobResult& res) {
+                WireWriter w;
+                encodeResult(w, res);
+                conn->send(w.buf);
+            });
+        }
+    }
+    ::shutdown(conn->fd, SHUT_RD);
+}
+
+int main(int argc, char** argv) {
+    std::string socketPath = "/tmp/rvsim.sock";
+    int port = 0;
+    unsigned int threads = 0;
+    ServiceLimits limits;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--socket" && hasValue) socketPath = argv[++i];
+        else if (arg == "--port" && hasValue) port = atoi(argv[++i]);
+        else if (arg == "-t" && hasValue) threads = atoi(argv[++i]);
+        else if (arg == "--max-cycles" && hasValue) limits.max_cycles = strtoull(argv[++i], nullptr, 0);
+        else if (arg == "--max-mem" && hasValue) limits.max_mem_bytes = strtoul(argv[++i], nullptr, 0);
+        else if (arg == "--max-source" && hasValue) limits.max_source_bytes = strtoul(argv[++i], nullptr, 0);
+        else {
+            fprintf(stderr, "usage: %s [--socket PATH | --port N] [-t THREADS] [--max-cycles N]\n"
+                            "       [--max-mem BYTES] [--max-source BYTES]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    // A client that disconnects mid-stream must not kill the server
+    signal(SIGPIPE, SIG_IGN);
+
+    int listener;
+    if (port > 0) {
+        listener = ::socket(AF_INET, SOCK_STREAM, 0);
+        int one = 1;
+        setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+        sockaddr_in addr = {};
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons((uint16_t)port);
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        if (::bind(listener, (sockaddr*)&addr, sizeof(addr)) != 0) { perror("bind"); return 1; }
+    } else {
+        listener = ::socket(AF_UNIX, SOCK_STREAM, 0);
+        sockaddr_un addr = {};
+        addr.sun_family = AF_UNIX;
+        if (socketPath.size() >= sizeof(addr.sun_path)) { fprintf(stderr, "socket path too long\n"); return 1; }
+        strcpy(addr.sun_path, socketPath.c_str());
+        ::unlink(socketPath.c_str());
+        if (::bind(listener, (sockaddr*)&addr, sizeof(addr)) != 0) { perror("bind"); return 1; }
+    }
+    if (::listen(listener, 64) != 0) { perror("listen"); return 1; }
+
+    SimService service(threads, limits);
+    fprintf(stderr, "listening on %s, %u workers, max %llu cycles and %u bytes per job\n",
+            port > 0 ? ("127.0.0.1:" + std::to_string(port)).c_str() : socketPath.c_str(), service.thread_count(),
+            (unsigned long long)limits.max_cycles, limits.max_mem_bytes);
+
+    for (;;) {
+        int fd = ::accept(listener, nullptr, nullptr);
+        if (fd < 0) {
+            if (errno == EINTR) continue;
+            perror("accept");
+            break;
+        }
+        if (port > 0) {
+            int one = 1; // Results are small frames; do not let them wait for ACKs
+            setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+        }
+        std::thread(serveConnection, std::ref(service), std::make_shared<Connection>(fd)).detach();
+    }
+    ::close(listener);
+    return 1;
+}
@@ -0,0 +1,78 @@
+// Per-cycle cost of the pipelined simulator's step(). Native only (has its
+// own main, so it is kept out of cpp_files).
+//
+//   g++ -std=c++17 -O2 tools/step_bench.cpp $(ls cpp_files/*.cpp | grep -v main.cpp) -o step_bench
+//   ./step_bench demo/sample.s -c 5000000
+//
+// -c cycles to run (default 5000000). The program restarts from its reset
+// point whenever it drains. The same run is timed with each plugin set the
+// simulator is instantiated with; the trace goes to a buffer-less stream.
+#include "../hpp_files/assembler.hpp"
+#include "../hpp_files/parser.hpp"
+#include "../hpp_files/encoder.hpp"
+#include "../hpp_files/simulator.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ostream>
+
+using Clock = std::chrono::steady_clock;
+
+template <class Plugins>
+static void bench(const char* name, uint64_t cycles, uint32_t text_end) {
+    RISCV_SimulatorT<RISCV_XLEN, Plugins> sim(INSTRUCTION_MEMORY);
+    std::ostream no_trace(nullptr);
+    sim.set_trace(no_trace);
+    sim.load_data(DATA_SEGMENT);
+    sim.save_reset_point();
+
+    uint64_t runs = 1;
+    auto t0 = Clock::now();
+    for (uint64_t c = 0; c < cycles; c++) {
+        if (sim.is_drained(text_end)) {
+            sim.reset();
+            runs++;
+        }
+        sim.step();
+    }
+    double seconds = std::chrono::duration<double>(Clock::now() - t0).count();
+
+    printf("%-22s %llu cycles over %llu runs: %7.1f ns/cycle (%.2f M cycles/s)\n", name,
+           (unsigned long long)cycles, (unsigned long long)runs, seconds * 1e9 / cycles, cycles / seconds / 1e6);
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        fprintf(stderr, "usage: %s program.s [-c cycles]\n", argv[0]);
+        return 1;
+    }
+    uint64_t cycles = 5000000;
+    for (int i = 2; i + 1 < argc; i += 2) {
+        if (!strcmp(argv[i], "-c")) cycles = strtoull(argv[i + 1], nullptr, 0);
+    }
+
+    vector<string> lines = readAndPreprocess(argv[1]);
+    vector<ParsedInstruction> instructions;
+    try {
+        SYMBOL_TABLE = buildSymbolTable(lines);
+        parseDataSection(lines);
+        instructions = parseInstructions(lines);
+        relaxCompressed(instructions, lines);
+        INSTRUCTION_MEMORY = translateToOpcode(instructions);
+    } catch (const std::exception& e) {
+        fprintf(stderr, "ERROR: %s\n", e.what());
+        return 1;
+    }
+    if (instructions.empty()) return 1;
+    uint32_t text_end = instructions.back().address + instructions.back().size;
+
+    bench<DefaultPlugins>("TraceLog+StatsCounter", cycles, text_end);
+    bench<StatsPlugins>("StatsCounter", cycles, text_end);
+    bench<NoPlugins>("no plugins", cycles, text_end);
+
+    printf("latch bytes: IF/ID %zu, ID/EX %zu, EX/MEM %zu, MEM/WB %zu\n",
+           sizeof(IF_ID_T<RISCV_XLEN>), sizeof(ID_EX_T<RISCV_XLEN>),
+           sizeof(EX_MEM_T<RISCV_XLEN>), sizeof(MEM_WB_T<RISCV_XLEN>));
+    return 0;
+}
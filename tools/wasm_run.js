@@ -0,0 +1,517 @@
+// Headless runner for the Emscripten build: loads simulator.js/simulator.wasm
+// in Node, runs every test of the given corpus files and directories through
+// initializeSimulator() and runSimulator() on worker_threads, and compares
+// the final state with the test's expectations. Reports simulated cycles/s.
+// No browser needed.
+//
+//   node tools/wasm_run.js demo/test_codes
+//   node tools/wasm_run.js demo/test_codes progs/ -j 8 -r 200 --module build/simulator.js
+//   node tools/wasm_run.js progs/ --record      # write the expectations from this build
+//
+// The corpus format is the one tools/regress reads (hpp_files/sim_corpus.hpp):
+// "#@ NAME [xlen=64] [mem=BYTES] [cycles=MAX] [unified=1] [vlen=BITS] [satp=VALUE]"
+// starts a test, "#< KEY = VALUE ..." lines set registers and memory words
+// before the run and "#= KEY = VALUE ..." lines give its final state. A file
+// without #@ lines is one test, with its #= lines or a .expect file next to it.
+// Directories contribute every .s file in them.
+//
+// -j WORKERS       worker threads, each with its own module instance (default: CPUs)
+// -r REPEATS       run each test this many times (reset in between); the last run is checked
+// --module PATH    the Emscripten loader (default: simulator.js at the repo root)
+// --filter TEXT    only tests whose name contains TEXT
+// --record         rewrite the expectations from this run instead of checking
+// --trace          print the per-cycle trace (silenced by default)
+// -v               also list the tests that pass or are skipped
+'use strict';
+
+const fs = require('fs');
+const os = require('os');
+const path = require('path');
+const { Worker, isMainThread, parentPort, workerData } = require('worker_threads');
+
+const RUN_CHUNK = 10000;   // Cycles per runSimulator() call (MAX_RUN_CYCLES in main.cpp)
+const DEFAULT_VLEN = 128;  // vector_unit.hpp
+
+// --- Module loading ---
+
+// The build is not MODULARIZE: its top level reads a global Module object if
+// one exists. Run the loader with our Module in scope instead of require() so
+// each worker gets its own instance and wasm is found next to the .js file.
+function loadSimulator(loaderPath, trace) {
+    const source = fs.readFileSync(loaderPath, 'utf8');
+    const dir = path.dirname(path.resolve(loaderPath));
+    return new Promise((resolve, reject) => {
+        const Module = {
+            locateFile: (file) => path.join(dir, file),
+            print: trace ? (line) => console.log(line) : () => {},
+            printErr: (line) => console.error(line),
+            onRuntimeInitialized: () => resolve(Module),
+            onAbort: (what) => reject(new Error('wasm aborted: ' + what)),
+        };
+        const load = new Function('Module', 'require', 'module', 'exports', '__filename', '__dirname', source);
+        const shim = { exports: {} };
+        load(Module, require, shim, shim.exports, path.resolve(loaderPath), dir);
+    });
+}
+
+// --- Corpus files (same rules as cpp_files/sim_corpus.cpp) ---
+
+// BigInt() takes "0x10" but not "-0x10"
+function parseNumber(text) {
+    if (!/^-?(0x[0-9a-f]+|\d+)$/i.test(text)) return null;
+    return text[0] === '-' ? -BigInt(text.slice(1)) : BigInt(text);
+}
+
+const COUNTER_KEYS = ['pc', 'cycles', 'instructions', 'stalls', 'halted', 'cause',
+                      'itlb_hits', 'itlb_misses', 'dtlb_hits', 'dtlb_misses', 'walks'];
+
+// The KEY = VALUE pairs of one line as [{key, value}]; throws on a malformed pair
+function parseExpectations(text) {
+    const line = text.replace(/#.*/, '');
+    const pair = /\s*(mem\[[^\]]*\]|[A-Za-z0-9_]+)\s*=\s*(\S+)/y;
+    const out = [];
+    let end = 0, m;
+    while ((m = pair.exec(line)) !== null) {
+        end = pair.lastIndex;
+        const key = m[1].replace(/\s+/g, '');
+        const value = parseNumber(m[2]);
+        const addr = /^mem\[(.*)\]$/.test(key) ? parseNumber(key.slice(4, -1)) : null;
+        if (value === null) throw new Error(`bad value "${m[2]}" for ${key}`);
+        if (/^x([12]?\d|3[01])$/.test(key) || COUNTER_KEYS.includes(key)) {
+            out.push({ key, value });
+        } else if (addr !== null && addr >= 0n) {
+            out.push({ key: `mem[${addr}]`, value });
+        } else {
+            throw new Error('unknown key ' + key);
+        }
+    }
+    if (line.slice(end).trim() !== '') throw new Error(`expected KEY = VALUE at "${line.slice(end).trim()}"`);
+    return out;
+}
+
+function parseHeader(rest, test) {
+    const words = rest.replace(/#.*/, '').trim().split(/\s+/).filter((w) => w);
+    if (words.length === 0) throw new Error('test has no name');
+    test.name = words[0];
+    for (const opt of words.slice(1)) {
+        const m = /^(\w+)=(.*)$/.exec(opt);
+        const v = m ? parseNumber(m[2]) : null;
+        const n = v === null ? -1 : Number(v);
+        if (m && m[1] === 'xlen' && (n === 32 || n === 64)) test.xlen = n;
+        else if (m && m[1] === 'mem' && n >= 0) test.mem = n;
+        else if (m && m[1] === 'cycles' && n > 0) test.maxCycles = n;
+        else if (m && m[1] === 'unified' && (n === 0 || n === 1)) test.unified = n === 1;
+        else if (m && m[1] === 'vlen' && n >= 0) test.vlen = n;
+        else if (m && m[1] === 'satp' && n >= 0 && n <= 0xFFFFFFFF) test.satp = n;
+        else throw new Error(`bad option "${opt}"`);
+    }
+}
+
+function newTest(file, line) {
+    return { name: '', file, line, source: '', expectFile: '', xlen: 32, mem: 0, maxCycles: 100000,
+             unified: false, vlen: 0, satp: 0, inits: [], expects: [] };
+}
+
+// What follows "#@" / "#<" / "#=" on a marked line, or null
+function marked(line, marker) {
+    const m = /^\s*#([@<=])(.*)$/.exec(line);
+    return m && m[1] === marker ? m[2] : null;
+}
+
+function splitLines(text) {
+    const lines = text.split('\n').map((l) => l.replace(/\r$/, ''));
+    if (lines.length && lines[lines.length - 1] === '') lines.pop();
+    return lines;
+}
+
+function loadCorpusFile(file) {
+    const text = fs.readFileSync(file, 'utf8');
+    const lines = splitLines(text);
+    const sections = lines.some((l) => marked(l, '@') !== null);
+    const tests = [];
+    let current = null;
+    if (!sections) {
+        // The whole file is one test
+        current = newTest(file, 0);
+        current.name = path.basename(file).replace(/\.[^.]*$/, '');
+        current.source = text;
+        tests.push(current);
+    }
+
+    lines.forEach((line, i) => {
+        try {
+            const header = marked(line, '@');
+            if (header !== null) {
+                current = newTest(file, i + 1);
+                current.source = '\n'.repeat(i); // Keeps assembler line numbers those of the file
+                parseHeader(header, current);
+                tests.push(current);
+            }
+            if (current === null) return; // Preamble before the first test
+            if (sections) current.source += line + '\n';
+            const expect = marked(line, '=');
+            if (expect !== null) current.expects.push(...parseExpectations(expect));
+            const init = marked(line, '<');
+            if (init !== null) {
+                for (const pair of parseExpectations(init)) {
+                    const settable = pair.key[0] === 'x' || (pair.key.startsWith('mem[') && Number(pair.key.slice(4, -1)) % 4 === 0);
+                    if (!settable) throw new Error('only xN and word-aligned mem[ADDR] can be set');
+                    current.inits.push(pair);
+                }
+            }
+        } catch (e) {
+            throw new Error(`${file}:${i + 1}: ${e.message}`);
+        }
+    });
+
+    // A whole-file test may keep its expectations in prog.expect
+    const sidecar = file.replace(/\.[^./]*$/, '') + '.expect';
+    if (!sections && fs.existsSync(sidecar)) {
+        tests[0].expectFile = sidecar;
+        splitLines(fs.readFileSync(sidecar, 'utf8')).forEach((line, i) => {
+            try {
+                tests[0].expects.push(...parseExpectations(line));
+            } catch (e) {
+                throw new Error(`${sidecar}:${i + 1}: ${e.message}`);
+            }
+        });
+    }
+    return tests;
+}
+
+function collectFiles(paths) {
+    const files = [];
+    for (const p of paths) {
+        if (fs.statSync(p).isDirectory()) {
+            files.push(...fs.readdirSync(p).filter((f) => f.endsWith('.s')).sort().map((f) => path.join(p, f)));
+        } else {
+            files.push(p);
+        }
+    }
+    return files;
+}
+
+// KEY = VALUE lines for a state: non-zero registers, non-zero memory words, the
+// counters (with the cause when halted), then the TLB counters if translation was used
+function recordExpectations(state) {
+    const lines = [];
+    const group = (pairs) => {
+        for (let i = 0; i < pairs.length; i += 8) lines.push(pairs.slice(i, i + 8).join('  '));
+    };
+    group(state.regs.map((v, i) => (i > 0 && v !== '0' ? `x${i} = ${v}` : null)).filter((p) => p));
+    group(state.memory.map((v, w) => (v !== 0 ? `mem[${w * 4}] = ${v}` : null)).filter((p) => p));
+    lines.push(`pc = ${state.pc}  cycles = ${state.cycles}  instructions = ${state.instructions}  ` +
+               `stalls = ${state.stalls}  halted = ${state.halted ? 1 : 0}` + (state.halted ? `  cause = ${state.cause}` : ''));
+    if (state.itlb_hits + state.itlb_misses + state.dtlb_hits + state.dtlb_misses > 0) {
+        lines.push(`itlb_hits = ${state.itlb_hits}  itlb_misses = ${state.itlb_misses}  ` +
+                   `dtlb_hits = ${state.dtlb_hits}  dtlb_misses = ${state.dtlb_misses}  walks = ${state.walks}`);
+    }
+    return lines;
+}
+
+// Replaces each test's #= lines (or rewrites the sidecar) with its recorded state
+function saveRecorded(file, tests, states) {
+    if (tests.length === 1 && tests[0].expectFile) {
+        if (states[0] === null) return;
+        fs.writeFileSync(tests[0].expectFile, recordExpectations(states[0]).join('\n') + '\n');
+        return;
+    }
+    const lines = splitLines(fs.readFileSync(file, 'utf8'));
+    const starts = tests.map((t) => (t.line ? t.line - 1 : 0)).concat([lines.length]);
+    const out = lines.slice(0, starts[0]);
+    tests.forEach((t, k) => {
+        if (states[k] === null) {
+            out.push(...lines.slice(starts[k], starts[k + 1])); // Skipped: keeps its expectations
+            return;
+        }
+        const kept = lines.slice(starts[k], starts[k + 1]).filter((l) => marked(l, '=') === null);
+        let last = kept.length;
+        while (last > 0 && kept[last - 1].trim() === '') last--;
+        out.push(...kept.slice(0, last), ...recordExpectations(states[k]).map((l) => '#= ' + l), ...kept.slice(last));
+    });
+    fs.writeFileSync(file, out.join('\n') + '\n');
+}
+
+// --- Worker ---
+
+// runSimulator() runs at most RUN_CHUNK cycles; a short chunk means the program finished
+function runToEnd(sim, test, call) {
+    let before = sim.getStats().cycles;
+    for (;;) {
+        call('runSimulator');
+        const after = sim.getStats().cycles;
+        if (after - before < RUN_CHUNK) return true;
+        if (after >= test.maxCycles) return false;
+        before = after;
+    }
+}
+
+function readState(sim, finished) {
+    const stats = sim.getStats();
+    const memory = [];
+    for (let a = 0; a + 4 <= sim.getMemorySize(); a += 4) memory.push(sim.getMemoryWord(a));
+    const regs = [];
+    for (let i = 0; i < 32; i++) regs.push(String(sim.getRegister(i)));
+    return { finished, halted: sim.isHalted(), pc: String(sim.getPC()), cycles: stats.cycles,
+             instructions: stats.instructions, stalls: stats.stall_cycles, cause: sim.getTrapCause(),
+             itlb_hits: stats.itlb_hits, itlb_misses: stats.itlb_misses, dtlb_hits: stats.dtlb_hits,
+             dtlb_misses: stats.dtlb_misses, walks: stats.page_walks, regs, memory };
+}
+
+// Same comparisons as diffCorpusState(): memory words and RV32 registers are signed 32-bit
+function diffState(test, state) {
+    const diffs = state.finished ? [] : [`did not finish within ${test.maxCycles} cycles`];
+    for (const { key, value } of test.expects) {
+        const expected = key.startsWith('mem[') || (key[0] === 'x' && test.xlen === 32) ? BigInt.asIntN(32, value) : value;
+        let actual;
+        if (key[0] === 'x') {
+            actual = BigInt(state.regs[parseInt(key.slice(1), 10)]);
+        } else if (key.startsWith('mem[')) {
+            const addr = Number(key.slice(4, -1));
+            if (addr % 4 !== 0 || addr / 4 >= state.memory.length) {
+                diffs.push(`${key}: expected ${expected}, not a word of memory`);
+                continue;
+            }
+            actual = BigInt(state.memory[addr / 4]);
+        } else if (key === 'halted') {
+            actual = state.halted ? 1n : 0n;
+        } else {
+            actual = BigInt(state[key]);
+        }
+        if (actual !== expected) diffs.push(`${key}: expected ${expected}, got ${actual}`);
+    }
+    return diffs;
+}
+
+function runTest(sim, test, opts, xlen) {
+    const result = { index: test.index, cycles: 0, seconds: 0, diffs: [], error: null, skipped: null, state: null };
+    if (test.xlen !== xlen) {
+        result.skipped = `needs an RV${test.xlen} build`;
+        return result;
+    }
+    const call = (fn, ...args) => {
+        if (sim[fn](...args) !== sim.SIM_OK) throw new Error(`${fn}: ${sim.getLastError()}`);
+    };
+    // Memory size, unified mode, the #< state and satp go on after init, in the
+    // order runCorpusTest() uses. RV64 builds take registers as BigInt
+    const configure = () => {
+        if (test.mem) call('setMemorySize', test.mem);
+        if (test.unified) call('setUnifiedMemory', true);
+        for (const { key, value } of test.inits) {
+            if (key[0] === 'x') {
+                const reg = xlen === 64 ? BigInt.asIntN(64, value) : Number(BigInt.asIntN(32, value));
+                call('setRegister', parseInt(key.slice(1), 10), reg);
+            } else {
+                call('setMemoryWord', Number(key.slice(4, -1)), Number(BigInt.asIntN(32, value)));
+            }
+        }
+        if (test.satp) call('setSatp', test.satp);
+    };
+    try {
+        // Both persist across initializeSimulator(), so every test sets them
+        call('setUnifiedMemory', false);
+        call('setVectorLength', test.vlen || DEFAULT_VLEN);
+        const start = process.hrtime.bigint();
+        call('initializeSimulator', test.source);
+        let finished = false;
+        for (let r = 0; r < opts.repeats; r++) {
+            if (r > 0) call('resetSimulator');
+            configure();
+            finished = runToEnd(sim, test, call);
+            result.cycles += sim.getStats().cycles;
+        }
+        result.seconds = Number(process.hrtime.bigint() - start) / 1e9;
+        result.state = readState(sim, finished);
+        result.diffs = diffState(test, result.state);
+    } catch (e) {
+        result.error = e.message;
+    }
+    return result;
+}
+
+// The embind functions and return types this runner relies on (main.cpp's
+// EMSCRIPTEN_BINDINGS); a module that differs is reported before any test runs
+function checkBindings(sim) {
+    const problems = [];
+    const functions = ['initializeSimulator', 'runSimulator', 'resetSimulator', 'setMemorySize', 'setUnifiedMemory',
+                       'setVectorLength', 'setRegister', 'setMemoryWord', 'setSatp', 'getStats', 'getPC',
+                       'getRegister', 'getMemoryWord', 'getMemorySize', 'getTrapCause', 'isHalted', 'getLastError'];
+    for (const fn of functions) {
+        if (typeof sim[fn] !== 'function') problems.push(`${fn}() is not bound`);
+    }
+    if (typeof sim.SIM_OK !== 'number') problems.push('SIM_OK is not a number constant');
+    if (problems.length) return problems;
+
+    const stats = sim.getStats();
+    for (const field of ['cycles', 'instructions', 'stall_cycles', 'itlb_hits', 'itlb_misses', 'dtlb_hits',
+                         'dtlb_misses', 'page_walks']) {
+        if (typeof stats[field] !== 'number') problems.push(`getStats().${field} is ${typeof stats[field]}, not number`);
+    }
+    const pc = typeof sim.getPC();
+    const reg = typeof sim.getRegister(0);
+    if (pc !== 'number' && pc !== 'bigint') problems.push(`getPC() returns ${pc}`);
+    if (reg !== pc) problems.push(`getRegister() returns ${reg} but getPC() ${pc}`);
+    for (const fn of ['getMemorySize', 'getTrapCause', 'getLastError', 'isHalted']) {
+        const want = fn === 'getLastError' ? 'string' : fn === 'isHalted' ? 'boolean' : 'number';
+        if (typeof sim[fn]() !== want) problems.push(`${fn}() returns ${typeof sim[fn]()}, not ${want}`);
+    }
+    return problems;
+}
+
+async function workerMain() {
+    const opts = workerData;
+    const sim = await loadSimulator(opts.module, opts.trace);
+    const problems = checkBindings(sim);
+    if (problems.length) throw new Error(`${opts.module} does not match main.cpp's bindings:\n    ${problems.join('\n    ')}`);
+    const xlen = typeof sim.getPC() === 'bigint' ? 64 : 32; // RV64 builds pass registers as BigInt
+    parentPort.on('message', (test) => {
+        if (test === null) {
+            parentPort.close();
+            return;
+        }
+        parentPort.postMessage(runTest(sim, test, opts, xlen));
+    });
+    parentPort.postMessage('ready');
+}
+
+// --- Main thread ---
+
+function usage() {
+    console.error('usage: node tools/wasm_run.js CORPUS|DIR... [-j workers] [-r repeats] [--module simulator.js]\n' +
+                  '       [--filter TEXT] [--record] [--trace] [-v]');
+    process.exit(1);
+}
+
+function parseArgs(argv) {
+    const opts = {
+        paths: [],
+        workers: os.cpus().length,
+        repeats: 1,
+        module: path.join(__dirname, '..', 'simulator.js'),
+        filter: '',
+        record: false,
+        trace: false,
+        verbose: false,
+    };
+    for (let i = 0; i < argv.length; i++) {
+        const arg = argv[i];
+        const hasValue = i + 1 < argv.length;
+        if (arg === '--record') opts.record = true;
+        else if (arg === '--trace') opts.trace = true;
+        else if (arg === '-v') opts.verbose = true;
+        else if (arg === '-j' && hasValue) opts.workers = parseInt(argv[++i], 10);
+        else if (arg === '-r' && hasValue) opts.repeats = parseInt(argv[++i], 10);
+        else if (arg === '--module' && hasValue) opts.module = argv[++i];
+        else if (arg === '--filter' && hasValue) opts.filter = argv[++i];
+        else if (!arg.startsWith('-')) opts.paths.push(arg);
+        else usage();
+    }
+    if (opts.paths.length === 0 || !(opts.workers >= 1) || !(opts.repeats >= 1)) usage();
+    return opts;
+}
+
+// Writes every file whose tests all ran or were skipped; returns the number of files left alone
+function record(tests, results) {
+    let failed = 0;
+    for (const file of new Set(tests.map((t) => t.file))) {
+        const own = tests.filter((t) => t.file === file);
+        const bad = own.filter((t) => !results[t.index] || (!results[t.index].state && !results[t.index].skipped));
+        for (const t of bad) {
+            const r = results[t.index];
+            console.log(`FAIL ${file} ${t.name}: ${r ? r.error || r.skipped : 'lost with a crashed worker'}`);
+        }
+        if (bad.length) {
+            console.log(`not recorded: ${file}`);
+            failed++;
+            continue;
+        }
+        saveRecorded(file, own, own.map((t) => results[t.index].state));
+        const target = own.length === 1 && own[0].expectFile ? own[0].expectFile : file;
+        console.log(`recorded ${own.length} test${own.length === 1 ? '' : 's'} in ${target}`);
+    }
+    return failed;
+}
+
+function main() {
+    const opts = parseArgs(process.argv.slice(2));
+    if (!fs.existsSync(opts.module)) {
+        console.error(`cannot find ${opts.module}; build it with emcc (see README) or pass --module`);
+        process.exit(1);
+    }
+    let tests = [];
+    try {
+        for (const file of collectFiles(opts.paths)) tests.push(...loadCorpusFile(file));
+    } catch (e) {
+        console.error(e.message);
+        process.exit(1);
+    }
+    // A partial record would drop the other tests' expectations, so --filter only narrows checks
+    if (opts.filter && !opts.record) tests = tests.filter((t) => t.name.includes(opts.filter));
+    tests.forEach((t, i) => { t.index = i; });
+    if (tests.length === 0) {
+        console.error('no tests');
+        process.exit(1);
+    }
+
+    const results = new Array(tests.length);
+    const start = process.hrtime.bigint();
+    let next = 0;
+    const workers = Math.min(opts.workers, tests.length);
+    let running = workers;
+
+    const finish = () => {
+        const wall = Number(process.hrtime.bigint() - start) / 1e9;
+        if (opts.record) {
+            process.exitCode = record(tests, results) ? 2 : 0;
+            return;
+        }
+        let failed = 0, skipped = 0, cycles = 0, simSeconds = 0;
+        tests.forEach((t, i) => {
+            const r = results[i];
+            const where = t.line ? `${t.file}:${t.line} ${t.name}` : t.file;
+            if (r && r.skipped) {
+                skipped++;
+                if (opts.verbose) console.log(`skip ${where}: ${r.skipped}`);
+                return;
+            }
+            if (r) {
+                cycles += r.cycles;
+                simSeconds += r.seconds;
+            }
+            if (!r || r.error || r.diffs.length || t.expects.length === 0) {
+                failed++;
+                console.log(`FAIL ${where}${r && r.error ? ': ' + r.error : ''}`);
+                if (!r) console.log('    lost with a crashed worker');
+                else if (t.expects.length === 0 && !r.error) console.log('    no expectations');
+                if (r) for (const d of r.diffs) console.log(`    ${d}`);
+            } else if (opts.verbose) {
+                console.log(`ok   ${where} (${r.state.cycles} cycles, ${r.state.stalls} stalls)`);
+            }
+        });
+        const ran = tests.length - skipped;
+        console.error(`${ran - failed}/${ran} passed${skipped ? `, ${skipped} skipped (other XLEN)` : ''}, ` +
+                      `${workers} workers, ${wall.toFixed(3)} s`);
+        console.error(`${cycles} cycles: ${(cycles / wall).toFixed(0)} cycles/s overall, ` +
+                      `${simSeconds > 0 ? (cycles / simSeconds).toFixed(0) : 0} cycles/s per worker`);
+        process.exitCode = failed ? 2 : 0;
+    };
+
+    for (let w = 0; w < workers; w++) {
+        const worker = new Worker(__filename, { workerData: opts });
+        // Hand out one test at a time so a slow one does not hold up a fixed share
+        worker.on('message', (msg) => {
+            if (msg !== 'ready') results[msg.index] = msg;
+            worker.postMessage(next < tests.length ? tests[next++] : null);
+        });
+        worker.on('error', (e) => console.error(`worker ${w}: ${e.message}`));
+        worker.on('exit', () => {
+            if (--running === 0) finish();
+        });
+    }
+}
+
+if (isMainThread) main();
+else workerMain().catch((e) => {
+    console.error(e.message);
+    process.exit(1);
+});